@@ -1,8 +1,8 @@
 #version 460
 
 in vec3 vertNormal;
-in vec3 vertLightDir[15];
-in vec3 vertHalfVector[15];
+in vec3 vertPosition;
+flat in int vertInstance;
 
 out vec4 fragColor;
 
@@ -22,34 +22,103 @@ struct NaturalMaterial
 	float shininess;
 };
 
+layout (std140, binding = 0) uniform Matrices
+{
+	mat4 projection_matrix;
+	mat4 view_matrix;
+};
+
+// tiles x, y, depth slices, logarithmic slicing flag; tiles per pixel x, y, depth slice scale and bias
 layout (std140, binding = 1) uniform Lights
 {
 	vec4 globalAmbient;
 	int lightsCount;
-	PointLight light[15];
+	ivec4 clusterGrid;
+	vec4 clusterScale;
+};
+
+// position.w is the range of the light
+layout (std430, binding = 7) readonly buffer PointLights
+{
+	PointLight lights[];
+};
+
+// offset and count of every cluster inside the cluster lights
+layout (std430, binding = 8) readonly buffer Clusters
+{
+	uvec2 clusters[];
+};
+
+layout (std430, binding = 9) readonly buffer ClusterLights
+{
+	uint clusterLights[];
+};
+
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
+{
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
 };
 
-uniform NaturalMaterial material;
+layout (std430, binding = 3) readonly buffer ObjectInstances
+{
+	ObjectInstance instances[];
+};
+
+// every loaded material, selected by the index of the instance
+layout (std430, binding = 6) readonly buffer NaturalMaterials
+{
+	NaturalMaterial materials[];
+};
+
+uint getClusterIndex()
+{
+	float depth = -(view_matrix * vec4(vertPosition, 1.0)).z;
+	float slice = clusterGrid.w != 0 ? log(max(depth, 1e-6)) : depth;
+
+	int z = clamp(int(floor(slice * clusterScale.z + clusterScale.w)), 0, clusterGrid.z - 1);
+	ivec2 tile = clamp(ivec2(gl_FragCoord.xy * clusterScale.xy), ivec2(0), clusterGrid.xy - 1);
+
+	return uint((z * clusterGrid.y + tile.y) * clusterGrid.x + tile.x);
+}
+
+// smooth falloff that reaches zero at the range
+float getAttenuation(float distance, float range)
+{
+	float ratio = distance / max(range, 1e-6);
+	return pow(clamp(1.0 - pow(ratio, 4.0), 0.0, 1.0), 2.0);
+}
 
 void main(void)
 {
+	NaturalMaterial material = materials[instances[vertInstance].material_index];
+
 	vec3 color = (globalAmbient * material.ambient).xyz;
 
     vec3 N = normalize(vertNormal);
 
-    for (int i = 0; i < lightsCount; ++i)
+	uvec2 cluster = clusters[getClusterIndex()];
+
+    for (uint i = cluster.x; i < cluster.x + cluster.y; ++i)
 	{
-		vec3 L = normalize(vertLightDir[i]);
-		vec3 H = normalize(vertHalfVector[i]);
+		PointLight light = lights[clusterLights[i]];
+
+		vec3 lightDir = light.position.xyz - vertPosition;
+
+		vec3 L = normalize(lightDir);
+		vec3 H = normalize(lightDir - vertPosition);
 
 		float cosTheta = dot(N,L);
     	float cosPhi = dot(H,N);
 
-    	vec3 ambient = ((light[i].ambient * material.ambient).xyz);
-    	vec3 diffuse = light[i].diffuse.xyz * material.diffuse.xyz * max(cosTheta, 0.0);
-    	vec3 specular = light[i].specular.xyz * material.specular.xyz * pow(max(cosPhi, 0.0), material.shininess * 3.0);
+    	vec3 ambient = ((light.ambient * material.ambient).xyz);
+    	vec3 diffuse = light.diffuse.xyz * material.diffuse.xyz * max(cosTheta, 0.0);
+    	vec3 specular = light.specular.xyz * material.specular.xyz * pow(max(cosPhi, 0.0), material.shininess * 3.0);
 
-    	color += vec3(ambient + diffuse + specular);
+    	color += vec3(ambient + diffuse + specular) * getAttenuation(length(lightDir), light.position.w);
 	}
 		
     fragColor = vec4(color, 1.0);
@@ -4,44 +4,55 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 
 out vec3 vertNormal;
-out vec3 vertLightDir[15];
-out vec3 vertHalfVector[15];
+out vec3 vertPosition;
+flat out int vertInstance;
 
-struct PointLight
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
 {
-	vec4 ambient;
-	vec4 diffuse;
-	vec4 specular;
-	vec4 position;
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
 };
 
-layout (std140, binding = 0) uniform Matrices
+layout (std430, binding = 3) readonly buffer ObjectInstances
 {
-	mat4 projection_matrix;
-	mat4 view_matrix;
+	ObjectInstance instances[];
 };
 
-layout (std140, binding = 1) uniform Lights
+struct PackedChunkBounds
 {
-	vec4 globalAmbient;
-	int lightsCount;
-	PointLight light[15];
+	vec4 origin;
+	vec4 step;
 };
 
-uniform mat4 model_matrix;
+// packed vertices store their positions in steps of the grid of their chunk
+layout (std430, binding = 2) readonly buffer PackedPositions
+{
+	PackedChunkBounds chunkBounds[];
+};
+
+uniform int packed_chunk_size = 0;
+
+vec3 decodePosition(vec3 value)
+{
+	if (packed_chunk_size == 0)
+		return value;
+
+	PackedChunkBounds bounds = chunkBounds[gl_VertexID / packed_chunk_size];
+	return bounds.origin.xyz + value * bounds.step.xyz;
+}
 
 void main(void)
 {
-	mat4 normal_matrix = transpose(inverse(model_matrix));
-	vertNormal = (normal_matrix * vec4(normal, 1.0)).xyz;
+	vertInstance = gl_BaseInstance + gl_InstanceID;
+	ObjectInstance instance = instances[vertInstance];
 
-	vec3 mPos = (model_matrix * vec4(position, 1.0)).xyz;
+	vertNormal = (instance.normal_matrix * vec4(normal, 1.0)).xyz;
 
-	for (int i = 0; i < lightsCount; ++i)
-	{
-		vertLightDir[i] = light[i].position.xyz - mPos;
-		vertHalfVector[i] = vertLightDir[i] - mPos;
-	}
+	vec4 objectPosition = vec4(decodePosition(position), 1.0);
+	vertPosition = (instance.model_matrix * objectPosition).xyz;
 
-	gl_Position = projection_matrix * view_matrix * vec4(mPos, 1.0);
+	gl_Position = instance.mvp_matrix * objectPosition;
 }
\ No newline at end of file
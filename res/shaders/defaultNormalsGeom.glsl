@@ -4,18 +4,25 @@ layout (triangles) in;
 layout (line_strip, max_vertices = 6) out;
 
 in vec3 vertNormal[];
+flat in int vertInstance[];
 
-layout (std140, binding = 0) uniform Matrices
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
 {
-	mat4 projection_matrix;
-	mat4 view_matrix;
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
 };
 
-uniform mat4 model_matrix;
+layout (std430, binding = 3) readonly buffer ObjectInstances
+{
+	ObjectInstance instances[];
+};
 
 void main(void)
 {
-	mat4 mvp = projection_matrix * view_matrix * model_matrix;
+	mat4 mvp = instances[vertInstance[0]].mvp_matrix;
 
 	float normalLength = 0.03;
 
@@ -4,9 +4,34 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 
 out vec3 vertNormal;
+flat out int vertInstance;
+
+struct PackedChunkBounds
+{
+	vec4 origin;
+	vec4 step;
+};
+
+// packed vertices store their positions in steps of the grid of their chunk
+layout (std430, binding = 2) readonly buffer PackedPositions
+{
+	PackedChunkBounds chunkBounds[];
+};
+
+uniform int packed_chunk_size = 0;
+
+vec3 decodePosition(vec3 value)
+{
+	if (packed_chunk_size == 0)
+		return value;
+
+	PackedChunkBounds bounds = chunkBounds[gl_VertexID / packed_chunk_size];
+	return bounds.origin.xyz + value * bounds.step.xyz;
+}
 
 void main(void)
 {
 	vertNormal = normal;
-	gl_Position = vec4(position, 1.0);
+	vertInstance = gl_BaseInstance + gl_InstanceID;
+	gl_Position = vec4(decodePosition(position), 1.0);
 }
\ No newline at end of file
@@ -5,17 +5,48 @@ layout(location = 1) in vec2 tex;
 
 out vec2 vertTex;
 
-layout (std140, binding = 0) uniform Matrices
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
 {
-	mat4 projection_matrix;
-	mat4 view_matrix;
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
 };
 
-uniform mat4 model_matrix;
+layout (std430, binding = 3) readonly buffer ObjectInstances
+{
+	ObjectInstance instances[];
+};
+
+struct PackedChunkBounds
+{
+	vec4 origin;
+	vec4 step;
+};
+
+// packed vertices store their positions in steps of the grid of their chunk
+layout (std430, binding = 2) readonly buffer PackedPositions
+{
+	PackedChunkBounds chunkBounds[];
+};
+
+uniform int packed_chunk_size = 0;
+
+vec3 decodePosition(vec3 value)
+{
+	if (packed_chunk_size == 0)
+		return value;
+
+	PackedChunkBounds bounds = chunkBounds[gl_VertexID / packed_chunk_size];
+	return bounds.origin.xyz + value * bounds.step.xyz;
+}
 
 void main(void)
 {
+	mat4 mvp_matrix = instances[gl_BaseInstance + gl_InstanceID].mvp_matrix;
+
 	vertTex = tex;
-	gl_Position = projection_matrix * view_matrix * model_matrix * vec4(pos, 1.0);
+	gl_Position = mvp_matrix * vec4(decodePosition(pos), 1.0);
 }
 
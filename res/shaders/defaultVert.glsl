@@ -8,10 +8,56 @@ layout (std140, binding = 0) uniform Matrices
 	mat4 view_matrix;
 };
 
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
+{
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
+};
+
+layout (std430, binding = 3) readonly buffer ObjectInstances
+{
+	ObjectInstance instances[];
+};
+
 uniform mat4 model_matrix;
+uniform bool is_instanced = false;
+
+struct PackedChunkBounds
+{
+	vec4 origin;
+	vec4 step;
+};
+
+// packed vertices store their positions in steps of the grid of their chunk
+layout (std430, binding = 2) readonly buffer PackedPositions
+{
+	PackedChunkBounds chunkBounds[];
+};
+
+uniform int packed_chunk_size = 0;
+
+vec3 decodePosition(vec3 value)
+{
+	if (packed_chunk_size == 0)
+		return value;
+
+	PackedChunkBounds bounds = chunkBounds[gl_VertexID / packed_chunk_size];
+	return bounds.origin.xyz + value * bounds.step.xyz;
+}
+
+mat4 getModelViewProjectionMatrix()
+{
+	if (!is_instanced)
+		return projection_matrix * view_matrix * model_matrix;
+
+	return instances[gl_BaseInstance + gl_InstanceID].mvp_matrix;
+}
 
 void main(void)
 {
-	gl_Position = projection_matrix * view_matrix * model_matrix * vec4(pos, 1.0);
+	gl_Position = getModelViewProjectionMatrix() * vec4(decodePosition(pos), 1.0);
 }
 
@@ -0,0 +1,10 @@
+#version 460
+
+flat in vec3 vertColor;
+
+out vec4 fragColor;
+
+void main(void)
+{
+	fragColor = vec4(vertColor, 1.0);
+}
@@ -0,0 +1,32 @@
+#version 460
+
+layout(location = 0) in vec3 pos;
+
+flat out vec3 vertColor;
+
+layout (std140, binding = 0) uniform Matrices
+{
+	mat4 projection_matrix;
+	mat4 view_matrix;
+};
+
+// position and scale in w, color of the marker
+struct LightMarker
+{
+	vec4 position_scale;
+	vec4 color;
+};
+
+layout (std430, binding = 10) readonly buffer LightMarkers
+{
+	LightMarker markers[];
+};
+
+void main(void)
+{
+	LightMarker marker = markers[gl_BaseInstance + gl_InstanceID];
+	vertColor = marker.color.rgb;
+
+	vec3 mPos = marker.position_scale.xyz + pos * marker.position_scale.w;
+	gl_Position = projection_matrix * view_matrix * vec4(mPos, 1.0);
+}
@@ -0,0 +1,222 @@
+#version 460
+
+// the programs of the procedural sweep share this shader, every fragment or geometry shader reads its own outputs
+out vec3 vertNormal;
+out vec3 vertPosition;
+out vec2 vertTex;
+flat out int vertInstance;
+
+// per object data of the instanced draws, indexed by gl_BaseInstance + gl_InstanceID
+struct ObjectInstance
+{
+	mat4 model_matrix;
+	mat4 mvp_matrix;
+	mat4 normal_matrix;
+	int material_index;
+};
+
+layout (std430, binding = 3) readonly buffer ObjectInstances
+{
+	ObjectInstance instances[];
+};
+
+// x axis and scale, y axis and the sign that turns the quad normals outwards, translation, ring center
+struct SweepFrame
+{
+	vec4 x_axis;
+	vec4 y_axis;
+	vec4 translation;
+	vec4 center;
+};
+
+layout (std430, binding = 4) readonly buffer SweepFrames
+{
+	SweepFrame frames[];
+};
+
+// centered profile point and its cap texture coordinate
+layout (std430, binding = 5) readonly buffer SweepProfile
+{
+	vec4 profile[];
+};
+
+uniform int rings_count;
+uniform int profile_size;
+uniform bool is_smooth_normals = false;
+uniform bool is_lit = false;
+// the normals geometry shader takes object space positions
+uniform bool is_object_space = false;
+
+vec3 getRingPoint(int ring, int point)
+{
+	SweepFrame frame = frames[ring];
+	vec2 scaled = frame.x_axis.w * profile[point == profile_size ? 0 : point].xy;
+
+	return (frame.x_axis.xyz * scaled.x + frame.y_axis.xyz * scaled.y) + frame.translation.xyz;
+}
+
+// outward and scaled by the quad area, points 1 and 2 lie on the first ring
+vec3 getQuadNormal(vec3 point1, vec3 point2, vec3 point3, vec3 point4, float orientation)
+{
+	return orientation * 0.5 * cross(point4 - point1, point3 - point2);
+}
+
+vec3 getCapNormal(bool isEnd)
+{
+	if (isEnd)
+		return frames[rings_count - 1].center.xyz - frames[rings_count - 2].center.xyz;
+
+	return frames[0].center.xyz - frames[1].center.xyz;
+}
+
+// normalized sum of the neighbouring quad normals, boundary rings lean halfway towards the caps
+vec3 getRingVertexNormal(int ring, int point)
+{
+	int prevPoint = point == 0 ? profile_size - 1 : point - 1;
+	int nextPoint = point + 1;
+
+	vec3 current = getRingPoint(ring, point);
+	vec3 currentPrev = getRingPoint(ring, prevPoint);
+	vec3 currentNext = getRingPoint(ring, nextPoint);
+
+	vec3 normal = vec3(0.0);
+
+	if (ring > 0)
+	{
+		vec3 prev = getRingPoint(ring - 1, point);
+		float orientation = frames[ring - 1].y_axis.w;
+
+		normal += getQuadNormal(getRingPoint(ring - 1, prevPoint), prev, currentPrev, current, orientation);
+		normal += getQuadNormal(prev, getRingPoint(ring - 1, nextPoint), current, currentNext, orientation);
+	}
+
+	if (ring < rings_count - 1)
+	{
+		vec3 next = getRingPoint(ring + 1, point);
+		float orientation = frames[ring].y_axis.w;
+
+		normal += getQuadNormal(currentPrev, current, getRingPoint(ring + 1, prevPoint), next, orientation);
+		normal += getQuadNormal(current, currentNext, next, getRingPoint(ring + 1, nextPoint), orientation);
+	}
+
+	if (length(normal) > 0.0)
+		normal = normalize(normal);
+
+	if (ring == 0)
+		normal = normalize(normal + normalize(getCapNormal(false)));
+	else if (ring == rings_count - 1)
+		normal = normalize(normal + normalize(getCapNormal(true)));
+
+	return normal;
+}
+
+// the same per corner normals as the generated flat surface
+vec3 getFlatNormal(int ring, int point, int corner)
+{
+	vec3 point1 = getRingPoint(ring, point);
+	vec3 point2 = getRingPoint(ring, point + 1);
+	vec3 point3 = getRingPoint(ring + 1, point);
+	vec3 point4 = getRingPoint(ring + 1, point + 1);
+
+	vec3 normal;
+
+	if (corner == 0)
+		normal = -cross(point2 - point1, point3 - point1);
+	else if (corner == 1 || corner == 3)
+		normal = (cross(point1 - point2, point3 - point2) + cross(point3 - point2, point4 - point2)) / 2.0;
+	else if (corner == 2 || corner == 4)
+		normal = -(cross(point1 - point3, point2 - point3) + cross(point2 - point3, point4 - point3)) / 2.0;
+	else
+		normal = cross(point2 - point4, point3 - point4);
+
+	return frames[ring].y_axis.w > 0.0 ? -normal : normal;
+}
+
+// the vertices follow the non indexed surface: two triangles per quad, then the start and the end caps
+void buildVertex(out vec3 position, out vec3 normal, out vec2 texCoord)
+{
+	bool isNormalNeeded = is_lit || is_object_space;
+	normal = vec3(0.0);
+
+	int surfaceSize = (rings_count - 1) * profile_size * 6;
+
+	if (gl_VertexID < surfaceSize)
+	{
+		const int ringOffsets[6] = int[6](0, 0, 1, 0, 1, 1);
+		const int pointOffsets[6] = int[6](0, 1, 0, 1, 0, 1);
+
+		int quad = gl_VertexID / 6;
+		int corner = gl_VertexID - quad * 6;
+
+		int quadRing = quad / profile_size;
+		int quadPoint = quad - quadRing * profile_size;
+
+		int ring = quadRing + ringOffsets[corner];
+		int point = quadPoint + pointOffsets[corner];
+
+		position = getRingPoint(ring, point);
+		texCoord = vec2(float(ring) / float(rings_count - 1), float(point) / float(profile_size));
+
+		if (isNormalNeeded)
+			normal = is_smooth_normals ? getRingVertexNormal(ring, point == profile_size ? 0 : point) : getFlatNormal(quadRing, quadPoint, corner);
+
+		return;
+	}
+
+	int capVertex = gl_VertexID - surfaceSize;
+	bool isEnd = capVertex >= profile_size * 3;
+
+	if (isEnd)
+		capVertex -= profile_size * 3;
+
+	int ring = isEnd ? rings_count - 1 : 0;
+	int corner = capVertex % 3;
+	int point = capVertex / 3 + corner - 1;
+
+	if (corner == 0)
+	{
+		position = frames[ring].center.xyz;
+		texCoord = vec2(0.5, 0.5);
+	}
+	else
+	{
+		position = getRingPoint(ring, point);
+		texCoord = profile[point == profile_size ? 0 : point].zw;
+	}
+
+	if (!isNormalNeeded)
+		return;
+
+	if (!is_smooth_normals)
+		normal = getCapNormal(isEnd);
+	else if (corner == 0)
+		normal = normalize(getCapNormal(isEnd));
+	else
+		normal = getRingVertexNormal(ring, point == profile_size ? 0 : point);
+}
+
+void main(void)
+{
+	vec3 position;
+	vec3 normal;
+
+	buildVertex(position, normal, vertTex);
+
+	vertInstance = gl_BaseInstance + gl_InstanceID;
+	ObjectInstance instance = instances[vertInstance];
+
+	if (is_object_space)
+	{
+		vertNormal = normal;
+		gl_Position = vec4(position, 1.0);
+		return;
+	}
+
+	if (is_lit)
+	{
+		vertNormal = (instance.normal_matrix * vec4(normal, 1.0)).xyz;
+		vertPosition = (instance.model_matrix * vec4(position, 1.0)).xyz;
+	}
+
+	gl_Position = instance.mvp_matrix * vec4(position, 1.0);
+}
@@ -0,0 +1,27 @@
+#include "CutObjectFile.h"
+#include "ThreadPool.h"
+
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: CutObjectConverter <text cut object file> <binary cut object file>" << std::endl;
+        return 1;
+    }
+
+    CutObjectData data;
+    ThreadPool threadPool;
+
+    if (!CutObjectFile::readText(argv[1], data, &threadPool) || !CutObjectFile::writeBinary(argv[2], data))
+        return 1;
+
+    // the written file is opened again, so a damaged file is reported here and not on loading
+    CutObjectFile file;
+
+    if (!file.open(argv[2]))
+        return 1;
+
+    std::cout << "Converted " << file.getControlPointsSize() << " trajectory points in " << file.getChunksCount() << " chunks" << std::endl;
+}
@@ -0,0 +1,400 @@
+#include "CutObjectFile.h"
+
+#include "TextScanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace
+{
+    constexpr char fileMagic[8]{ 'S', 'W', 'E', 'E', 'P', 'C', 'U', 'T' };
+
+    // the layout is a part of the format
+    static_assert(sizeof(CutObjectFileHeader) == 104 && sizeof(CutObjectFileChunk) == 40);
+
+    uint64_t alignOffset(uint64_t offset)
+    {
+        uint64_t alignment = CutObjectFile::arrayAlignment;
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    CutObjectFileArray placeArray(uint64_t& offset, size_t size, size_t elementSize)
+    {
+        CutObjectFileArray array{ alignOffset(offset), size };
+        offset = array.offset + size * elementSize;
+
+        return array;
+    }
+
+    bool readAmount(TextScanner& scanner, int& amount)
+    {
+        if (!scanner.read(amount))
+            return false;
+
+        if (amount < 0)
+        {
+            std::cerr << "Negative amount in cut object file!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    void writeArray(std::ofstream& f, const CutObjectFileArray& array, const void* data, size_t elementSize)
+    {
+        // zero padding up to the aligned array start
+        static const char padding[CutObjectFile::arrayAlignment]{};
+
+        uint64_t position = static_cast<uint64_t>(f.tellp());
+        f.write(padding, array.offset - position);
+
+        if (array.size > 0)
+            f.write(static_cast<const char*>(data), array.size * elementSize);
+    }
+}
+
+bool CutObjectFile::isBinary(std::string_view path)
+{
+    std::ifstream f(std::string(path), std::ios::in | std::ios::binary);
+
+    char magic[sizeof(fileMagic)]{};
+    f.read(magic, sizeof(magic));
+
+    return f.gcount() == sizeof(magic) && std::memcmp(magic, fileMagic, sizeof(magic)) == 0;
+}
+
+bool CutObjectFile::readText(std::string_view path, CutObjectData& data, ThreadPool* threadPool)
+{
+    TextScanner scanner;
+
+    if (!scanner.open(path))
+    {
+        std::cerr << "Failed to open cut object file!" << std::endl;
+        return false;
+    }
+
+    int cutPointAmount = 0;
+
+    if (!readAmount(scanner, cutPointAmount))
+        return false;
+
+    data.cut.resize(cutPointAmount);
+
+    if (!scanner.read(reinterpret_cast<float*>(data.cut.data()), 2 * cutPointAmount, threadPool))
+        return false;
+
+    int trajectoryPointAmount = 0;
+
+    if (!readAmount(scanner, trajectoryPointAmount))
+        return false;
+
+    data.controlPoints.resize(trajectoryPointAmount);
+
+    // the trajectory is the long part of the file
+    if (!scanner.read(reinterpret_cast<float*>(data.controlPoints.data()), 3 * trajectoryPointAmount, threadPool))
+        return false;
+
+    int cutParametersAmount = 0;
+
+    if (!readAmount(scanner, cutParametersAmount))
+        return false;
+
+    data.cutParameters.resize(cutParametersAmount);
+
+    if (!scanner.read(data.cutParameters.data(), cutParametersAmount, threadPool))
+        return false;
+
+    // optional curve type after the cut parameters, a polyline when it is missing
+    data.curve = Polyline_curve;
+
+    if (!scanner.isEnd())
+    {
+        std::string_view curveName;
+        scanner.read(curveName);
+
+        if (curveName == "catmull_rom")
+            data.curve = Catmull_rom_curve;
+        else if (curveName == "b_spline")
+            data.curve = B_spline_curve;
+        else if (curveName == "nurbs")
+        {
+            data.curve = Nurbs_curve;
+
+            // one weight per control point
+            data.weights.resize(trajectoryPointAmount, 1.0f);
+
+            if (!scanner.read(data.weights.data(), trajectoryPointAmount, threadPool))
+                return false;
+        }
+        else if (curveName != "polyline")
+            std::cerr << "Unknown trajectory curve " << curveName << "!" << std::endl;
+    }
+
+    return true;
+}
+
+bool CutObjectFile::readTextPreview(std::string_view path, int maxPointsSize, CutObjectData& preview, ThreadPool* threadPool)
+{
+    TextScanner scanner;
+
+    if (!scanner.open(path))
+    {
+        std::cerr << "Failed to open cut object file!" << std::endl;
+        return false;
+    }
+
+    int cutPointAmount = 0;
+
+    if (!readAmount(scanner, cutPointAmount))
+        return false;
+
+    preview.cut.resize(cutPointAmount);
+
+    if (!scanner.read(reinterpret_cast<float*>(preview.cut.data()), 2 * cutPointAmount, threadPool))
+        return false;
+
+    int trajectoryPointAmount = 0;
+
+    if (!readAmount(scanner, trajectoryPointAmount))
+        return false;
+
+    if (trajectoryPointAmount <= maxPointsSize)
+    {
+        preview = CutObjectData();
+        return true;
+    }
+
+    int stride = getPreviewStride(trajectoryPointAmount, maxPointsSize);
+    int previewPointsSize = TextScanner::getSampledGroupsCount(trajectoryPointAmount, stride);
+
+    preview.controlPoints.resize(previewPointsSize);
+
+    if (!scanner.read(reinterpret_cast<float*>(preview.controlPoints.data()), 3, trajectoryPointAmount, stride, threadPool))
+        return false;
+
+    int cutParametersAmount = 0;
+
+    if (!readAmount(scanner, cutParametersAmount))
+        return false;
+
+    if (cutParametersAmount != trajectoryPointAmount)
+    {
+        preview = CutObjectData();
+        return true;
+    }
+
+    preview.cutParameters.resize(previewPointsSize);
+
+    return scanner.read(preview.cutParameters.data(), 1, cutParametersAmount, stride, threadPool);
+}
+
+int CutObjectFile::getPreviewStride(int controlPointsSize, int maxPointsSize)
+{
+    // the last point follows the samples, so at most maxPointsSize points are left
+    return std::max(1, (controlPointsSize + maxPointsSize - 4) / (maxPointsSize - 2));
+}
+
+bool CutObjectFile::writeBinary(std::string_view path, const CutObjectData& data)
+{
+    std::ofstream f(std::string(path), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!f.is_open())
+    {
+        std::cerr << "Failed to create binary cut object file!" << std::endl;
+        return false;
+    }
+
+    int controlPointsSize = data.controlPoints.size();
+    int chunksCount = (controlPointsSize + chunkSize - 1) / chunkSize;
+
+    std::vector<CutObjectFileChunk> chunks(chunksCount);
+
+    for (int i = 0; i < chunksCount; ++i)
+    {
+        CutObjectFileChunk& chunk = chunks[i];
+
+        chunk.firstPoint = static_cast<uint64_t>(i) * chunkSize;
+        chunk.pointsSize = std::min<uint64_t>(chunkSize, controlPointsSize - chunk.firstPoint);
+        chunk.min = glm::vec3(std::numeric_limits<float>::max());
+        chunk.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+        for (uint64_t k = chunk.firstPoint; k < chunk.firstPoint + chunk.pointsSize; ++k)
+        {
+            chunk.min = glm::min(chunk.min, data.controlPoints[k]);
+            chunk.max = glm::max(chunk.max, data.controlPoints[k]);
+        }
+    }
+
+    CutObjectFileHeader header;
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = version;
+    header.byteOrderMark = byteOrderMark;
+    header.curve = data.curve;
+    header.chunkSize = chunkSize;
+
+    uint64_t offset = sizeof(CutObjectFileHeader);
+
+    header.cut = placeArray(offset, data.cut.size(), sizeof(glm::vec2));
+    header.controlPoints = placeArray(offset, data.controlPoints.size(), sizeof(glm::vec3));
+    header.cutParameters = placeArray(offset, data.cutParameters.size(), sizeof(float));
+    header.weights = placeArray(offset, data.weights.size(), sizeof(float));
+    header.chunks = placeArray(offset, chunks.size(), sizeof(CutObjectFileChunk));
+
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    writeArray(f, header.cut, data.cut.data(), sizeof(glm::vec2));
+    writeArray(f, header.controlPoints, data.controlPoints.data(), sizeof(glm::vec3));
+    writeArray(f, header.cutParameters, data.cutParameters.data(), sizeof(float));
+    writeArray(f, header.weights, data.weights.data(), sizeof(float));
+    writeArray(f, header.chunks, chunks.data(), sizeof(CutObjectFileChunk));
+
+    if (!f.good())
+    {
+        std::cerr << "Failed to write binary cut object file!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool CutObjectFile::open(std::string_view path)
+{
+    close();
+
+    if (!m_file.open(path))
+        return false;
+
+    if (m_file.getSize() < sizeof(CutObjectFileHeader))
+    {
+        std::cerr << "Binary cut object file is too short!" << std::endl;
+        close();
+        return false;
+    }
+
+    // the header is copied, everything after it is read in place
+    std::memcpy(&m_header, m_file.getData(), sizeof(CutObjectFileHeader));
+
+    if (std::memcmp(m_header.magic, fileMagic, sizeof(fileMagic)) != 0 || m_header.byteOrderMark != byteOrderMark)
+    {
+        std::cerr << "Not a binary cut object file or written with another byte order!" << std::endl;
+        close();
+        return false;
+    }
+
+    if (m_header.version != version)
+    {
+        std::cerr << "Binary cut object file version " << m_header.version << " is not supported!" << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t controlPointsSize = m_header.controlPoints.size;
+    uint64_t chunksCount = m_header.chunkSize > 0 ? (controlPointsSize + m_header.chunkSize - 1) / m_header.chunkSize : 0;
+
+    bool isValid = m_header.curve <= Nurbs_curve && m_header.chunks.size == chunksCount &&
+        isValidArray(m_header.cut, sizeof(glm::vec2)) &&
+        isValidArray(m_header.controlPoints, sizeof(glm::vec3)) &&
+        isValidArray(m_header.cutParameters, sizeof(float)) &&
+        isValidArray(m_header.weights, sizeof(float)) &&
+        isValidArray(m_header.chunks, sizeof(CutObjectFileChunk));
+
+    // the chunks have to cover the control points in order, the preview is read through them
+    for (uint64_t i = 0; isValid && i < chunksCount; ++i)
+    {
+        const CutObjectFileChunk& chunk = getChunks()[i];
+        isValid = chunk.firstPoint == i * m_header.chunkSize && chunk.pointsSize == std::min<uint64_t>(m_header.chunkSize, controlPointsSize - chunk.firstPoint);
+    }
+
+    if (!isValid)
+    {
+        std::cerr << "Binary cut object file is damaged!" << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void CutObjectFile::close()
+{
+    m_file.close();
+    m_header = CutObjectFileHeader();
+}
+
+const glm::vec2* CutObjectFile::getCut() const
+{
+    return getArray<glm::vec2>(m_header.cut);
+}
+
+int CutObjectFile::getCutSize() const
+{
+    return m_header.cut.size;
+}
+
+const glm::vec3* CutObjectFile::getControlPoints() const
+{
+    return getArray<glm::vec3>(m_header.controlPoints);
+}
+
+int CutObjectFile::getControlPointsSize() const
+{
+    return m_header.controlPoints.size;
+}
+
+const float* CutObjectFile::getCutParameters() const
+{
+    return getArray<float>(m_header.cutParameters);
+}
+
+int CutObjectFile::getCutParametersSize() const
+{
+    return m_header.cutParameters.size;
+}
+
+const float* CutObjectFile::getWeights() const
+{
+    return getArray<float>(m_header.weights);
+}
+
+int CutObjectFile::getWeightsSize() const
+{
+    return m_header.weights.size;
+}
+
+TrajectoryCurves CutObjectFile::getCurve() const
+{
+    return static_cast<TrajectoryCurves>(m_header.curve);
+}
+
+const CutObjectFileChunk* CutObjectFile::getChunks() const
+{
+    return getArray<CutObjectFileChunk>(m_header.chunks);
+}
+
+int CutObjectFile::getChunksCount() const
+{
+    return m_header.chunks.size;
+}
+
+void CutObjectFile::read(CutObjectData& data) const
+{
+    data.cut.assign(getCut(), getCut() + getCutSize());
+    data.controlPoints.assign(getControlPoints(), getControlPoints() + getControlPointsSize());
+    data.cutParameters.assign(getCutParameters(), getCutParameters() + getCutParametersSize());
+    data.weights.assign(getWeights(), getWeights() + getWeightsSize());
+    data.curve = getCurve();
+}
+
+bool CutObjectFile::isValidArray(const CutObjectFileArray& array, size_t elementSize) const
+{
+    uint64_t fileSize = m_file.getSize();
+
+    // sizes are used as ints by the sweep, the check is written so that it can not overflow
+    return array.offset % arrayAlignment == 0 && array.offset <= fileSize &&
+        array.size <= static_cast<uint64_t>(std::numeric_limits<int>::max()) &&
+        array.size <= (fileSize - array.offset) / elementSize;
+}
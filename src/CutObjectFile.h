@@ -0,0 +1,110 @@
+#ifndef CUT_OBJECT_FILE_H
+#define CUT_OBJECT_FILE_H
+
+#include "Enums.h"
+#include "MappedFile.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+// Contents of a cut object file in either format
+struct CutObjectData
+{
+    std::vector<glm::vec2> cut;
+    std::vector<glm::vec3> controlPoints;
+    std::vector<float> cutParameters;
+    std::vector<float> weights; // NURBS only
+    TrajectoryCurves curve = Polyline_curve;
+};
+
+// Array of the binary file, size is in elements
+struct CutObjectFileArray
+{
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+// Binary file layout: the header and then the arrays, every one of them starts at a multiple of arrayAlignment.
+// All values are stored in the byte order of the writer, which is checked with byteOrderMark
+struct CutObjectFileHeader
+{
+    char magic[8]{};
+    uint32_t version = 0;
+    uint32_t byteOrderMark = 0;
+    uint32_t curve = 0;
+    uint32_t chunkSize = 0;
+
+    CutObjectFileArray cut;           // glm::vec2
+    CutObjectFileArray controlPoints; // glm::vec3
+    CutObjectFileArray cutParameters; // float
+    CutObjectFileArray weights;       // float
+    CutObjectFileArray chunks;        // CutObjectFileChunk
+};
+
+// Index entry of chunkSize control points, so that a part of the trajectory can be found without reading all of it
+struct CutObjectFileChunk
+{
+    uint64_t firstPoint = 0;
+    uint32_t pointsSize = 0;
+    uint32_t reserved = 0;
+    glm::vec3 min{};
+    glm::vec3 max{};
+};
+
+// The binary file is mapped and its arrays are read in place, the text file is parsed into CutObjectData
+class CutObjectFile
+{
+public:
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t byteOrderMark = 0x01020304;
+    static constexpr uint32_t chunkSize = 65536;
+    static constexpr uint64_t arrayAlignment = 64;
+
+    static bool isBinary(std::string_view path);
+    static bool readText(std::string_view path, CutObjectData& data, ThreadPool* threadPool = nullptr);
+
+    // reads the cut and every getPreviewStride()-th control point and cut parameter with the ends kept, the values
+    // between are only skipped. The preview stays empty when the file has at most maxPointsSize control points
+    // or a different amount of cut parameters
+    static bool readTextPreview(std::string_view path, int maxPointsSize, CutObjectData& preview, ThreadPool* threadPool = nullptr);
+    static int getPreviewStride(int controlPointsSize, int maxPointsSize);
+    static bool writeBinary(std::string_view path, const CutObjectData& data);
+
+    bool open(std::string_view path);
+    void close();
+
+    const glm::vec2* getCut() const;
+    int getCutSize() const;
+    const glm::vec3* getControlPoints() const;
+    int getControlPointsSize() const;
+    const float* getCutParameters() const;
+    int getCutParametersSize() const;
+    const float* getWeights() const;
+    int getWeightsSize() const;
+    TrajectoryCurves getCurve() const;
+
+    const CutObjectFileChunk* getChunks() const;
+    int getChunksCount() const;
+
+    // copies the mapped arrays, for the callers that edit them
+    void read(CutObjectData& data) const;
+
+private:
+    bool isValidArray(const CutObjectFileArray& array, size_t elementSize) const;
+
+    template<typename T>
+    const T* getArray(const CutObjectFileArray& array) const
+    {
+        return reinterpret_cast<const T*>(m_file.getData() + array.offset);
+    }
+
+    MappedFile m_file;
+    CutObjectFileHeader m_header;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "CutObjectLoader.h"
+
+#include "CutObjectFile.h"
+#include "ReplicatedCutObject.h"
+
+#include <iostream>
+#include <new>
+#include <utility>
+
+CutObjectLoader::CutObjectLoader(ResourceManager* resourceManager, ThreadPool* threadPool) :
+    m_resourceManager(resourceManager),
+    m_threadPool(threadPool)
+{
+}
+
+CutObjectLoader::~CutObjectLoader()
+{
+    // the task is not interrupted inside a stage, so the destructor waits for the current one
+    m_isCancelled = true;
+
+    if (m_task.valid())
+        m_task.wait();
+
+    for (ReplicatedCutObject* cutObject : m_generatedCutObjects)
+        delete cutObject;
+}
+
+void CutObjectLoader::load(std::string_view fullFilePath, std::string_view texture)
+{
+    if (m_task.valid())
+    {
+        m_isCancelled = true;
+        m_task.wait();
+    }
+
+    m_isCancelled = false;
+    m_stage = Generating_preview;
+
+    m_task = m_threadPool->submit([this, path = std::string(fullFilePath), texture = std::string(texture)]()
+    {
+        loadTask(path, texture);
+    });
+}
+
+LoadingStages CutObjectLoader::getStage() const
+{
+    return m_stage;
+}
+
+float CutObjectLoader::getProgress() const
+{
+    // the stages are not divided further, so the progress is the share of the finished ones
+    switch (m_stage)
+    {
+    case Generating_preview:
+        return 0.0f;
+
+    case Reading_file:
+        return 1.0f / 3.0f;
+
+    case Generating_sweep:
+        return 2.0f / 3.0f;
+
+    default:
+        return 1.0f;
+    }
+}
+
+bool CutObjectLoader::isLoading() const
+{
+    LoadingStages stage = m_stage;
+    return stage != Loading_finished && stage != Loading_failed;
+}
+
+ReplicatedCutObject* CutObjectLoader::takeCutObject()
+{
+    std::vector<ReplicatedCutObject*> cutObjects;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cutObjects.swap(m_generatedCutObjects);
+    }
+
+    if (cutObjects.empty())
+        return nullptr;
+
+    // a preview that was not taken in time is replaced by the full object at once
+    for (int i = 0; i < static_cast<int>(cutObjects.size()) - 1; ++i)
+        delete cutObjects[i];
+
+    return cutObjects.back();
+}
+
+void CutObjectLoader::loadTask(std::string fullFilePath, std::string texture)
+{
+    try
+    {
+        CutObjectData data;
+        bool isLoaded = false;
+
+        // small objects are generated about as fast as their preview
+        if (CutObjectFile::isBinary(fullFilePath))
+        {
+            CutObjectFile file;
+            isLoaded = file.open(fullFilePath);
+
+            // the preview is read from the mapped arrays before they are copied
+            if (isLoaded && !m_isCancelled && file.getControlPointsSize() > previewMaxPointsSize && file.getCutParametersSize() == file.getControlPointsSize())
+                handOver(makePreviewData(file), texture);
+
+            if (isLoaded && !m_isCancelled)
+            {
+                m_stage = Reading_file;
+                file.read(data);
+            }
+        }
+        else
+        {
+            // the preview is a partial read that parses only its own points, the whole file is parsed after it
+            CutObjectData preview;
+            isLoaded = CutObjectFile::readTextPreview(fullFilePath, previewMaxPointsSize, preview, m_threadPool);
+
+            if (isLoaded && !m_isCancelled && !preview.controlPoints.empty())
+                handOver(std::move(preview), texture);
+
+            if (isLoaded && !m_isCancelled)
+            {
+                m_stage = Reading_file;
+                isLoaded = CutObjectFile::readText(fullFilePath, data, m_threadPool);
+            }
+        }
+
+        if (!isLoaded)
+        {
+            m_stage = Loading_failed;
+            return;
+        }
+
+        if (!m_isCancelled)
+        {
+            m_stage = Generating_sweep;
+            handOver(std::move(data), texture);
+        }
+
+        m_stage = Loading_finished;
+    }
+    catch (const std::bad_alloc&)
+    {
+        std::cerr << "Not enough memory to load " << fullFilePath << "!" << std::endl;
+        m_stage = Loading_failed;
+    }
+}
+
+CutObjectData CutObjectLoader::makePreviewData(const CutObjectFile& file) const
+{
+    CutObjectData preview;
+    preview.cut.assign(file.getCut(), file.getCut() + file.getCutSize());
+
+    // the control polygon is thinned out evenly and drawn as a polyline, the ends are kept. The samples are taken
+    // chunk by chunk of the index, so only the pages around them are read from the mapped file
+    const glm::vec3* controlPoints = file.getControlPoints();
+    const float* cutParameters = file.getCutParameters();
+    int controlPointsSize = file.getControlPointsSize();
+    int step = CutObjectFile::getPreviewStride(controlPointsSize, previewMaxPointsSize);
+
+    for (int i = 0; i < file.getChunksCount(); ++i)
+    {
+        const CutObjectFileChunk& chunk = file.getChunks()[i];
+        int chunkBegin = chunk.firstPoint;
+        int chunkEnd = chunkBegin + chunk.pointsSize;
+
+        for (int k = (chunkBegin + step - 1) / step * step; k < chunkEnd; k += step)
+        {
+            preview.controlPoints.push_back(controlPoints[k]);
+            preview.cutParameters.push_back(cutParameters[k]);
+        }
+    }
+
+    if ((controlPointsSize - 1) % step != 0)
+    {
+        preview.controlPoints.push_back(controlPoints[controlPointsSize - 1]);
+        preview.cutParameters.push_back(cutParameters[controlPointsSize - 1]);
+    }
+
+    return preview;
+}
+
+void CutObjectLoader::handOver(CutObjectData data, const std::string& texture)
+{
+    ReplicatedCutObject* cutObject = new ReplicatedCutObject(std::move(data), m_resourceManager, texture, m_threadPool);
+    cutObject->generate();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_generatedCutObjects.push_back(cutObject);
+}
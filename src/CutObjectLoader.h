@@ -0,0 +1,58 @@
+#ifndef CUT_OBJECT_LOADER_H
+#define CUT_OBJECT_LOADER_H
+
+#include "CutObjectFile.h"
+#include "Enums.h"
+#include "ReplicatedCutObject.h"
+#include "ResourcesManager.h"
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reads a cut object file and generates its sweep as a task of the thread pool.
+// A preview made of every n-th control point is handed over before the whole file is read, the full object follows
+class CutObjectLoader
+{
+public:
+    CutObjectLoader(ResourceManager* resourceManager, ThreadPool* threadPool);
+    ~CutObjectLoader();
+
+    CutObjectLoader(const CutObjectLoader&) = delete;
+    CutObjectLoader& operator=(const CutObjectLoader&) = delete;
+
+    void load(std::string_view fullFilePath, std::string_view texture);
+
+    LoadingStages getStage() const;
+    float getProgress() const;
+    bool isLoading() const;
+
+    // the newest generated object or nullptr, it is not uploaded yet. Called by the render thread,
+    // which also deletes the objects that were replaced before they were taken
+    ReplicatedCutObject* takeCutObject();
+
+private:
+    static constexpr int previewMaxPointsSize = 1024;
+
+    void loadTask(std::string fullFilePath, std::string texture);
+    CutObjectData makePreviewData(const CutObjectFile& file) const;
+    void handOver(CutObjectData data, const std::string& texture);
+
+    ResourceManager* m_resourceManager = nullptr;
+    ThreadPool* m_threadPool = nullptr;
+
+    std::future<void> m_task;
+    std::atomic<LoadingStages> m_stage = Loading_finished;
+    std::atomic<bool> m_isCancelled = false;
+
+    std::mutex m_mutex;
+    std::vector<ReplicatedCutObject*> m_generatedCutObjects;
+};
+
+#endif
@@ -16,4 +16,27 @@ enum DisplayModes
     Replicated_cut_trajectory_and_cuts_frame_surface
 };
 
+enum FrameModes
+{
+    Legacy_frames,
+    Rotation_minimizing_frames
+};
+
+enum TrajectoryCurves
+{
+    Polyline_curve,
+    Catmull_rom_curve,
+    B_spline_curve,
+    Nurbs_curve
+};
+
+enum LoadingStages
+{
+    Loading_finished,
+    Loading_failed,
+    Generating_preview,
+    Reading_file,
+    Generating_sweep
+};
+
 #endif
\ No newline at end of file
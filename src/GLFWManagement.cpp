@@ -9,6 +9,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <string>
 #include <string_view>
 
 namespace GLFWglobals
@@ -26,6 +27,8 @@ namespace GLFWglobals
 
     extern float lastMousePositionX = 0.0f;
     extern float lastMousePositionY = 0.0f;
+
+    extern int selectedTrajectoryPoint = 0;
 }
 
 namespace GLFW
@@ -129,6 +132,13 @@ namespace GLFW
         ImGui::NewFrame();
 
         if (ImGui::BeginMainMenuBar()) {
+            // the shown objects are replaced when the loading ends, so the settings that generate them again wait for that
+            int loadingCutObjectsCount = GLFWglobals::openGLManager->getLoadingCutObjectsCount();
+            bool isLoading = loadingCutObjectsCount > 0;
+
+            // group nodes have no cut object to edit
+            bool isCutObjectSelected = GLFWglobals::openGLManager->hasSelectedCutObject();
+
             if (ImGui::BeginMenu("Display mode"))
             {
                 if (ImGui::MenuItem("Trajectory"))
@@ -251,6 +261,11 @@ namespace GLFW
                             ImGui::EndMenu();
                         }
 
+                        float range = GLFWglobals::openGLManager->getPointLightRange(i);
+
+                        if (ImGui::DragFloat("Range", &range, 0.1f, 0.0f, 300.0f))
+                            GLFWglobals::openGLManager->setPointLightRange(i, range);
+
                         if (ImGui::MenuItem("Delete"))
                         {
                             GLFWglobals::openGLManager->deletePointLightSource(i);
@@ -279,7 +294,43 @@ namespace GLFW
                 ImGui::EndMenu();
             }
 
-            if (ImGui::BeginMenu("Material"))
+            if (ImGui::BeginMenu("Scene"))
+            {
+                int size = GLFWglobals::openGLManager->getSceneNodesCount();
+                int selected = GLFWglobals::openGLManager->getSelectedSceneNode();
+
+                for (int i = 0; i < size; ++i)
+                {
+                    // children are indented under their parents, the index keeps equal names apart
+                    std::string label = std::string(2 * GLFWglobals::openGLManager->getSceneNodeDepth(i), ' ') +
+                        GLFWglobals::openGLManager->getSceneNodeName(i) + "##" + std::to_string(i);
+
+                    if (ImGui::Selectable(label.c_str(), i == selected, ImGuiSelectableFlags_NoAutoClosePopups))
+                    {
+                        GLFWglobals::openGLManager->setSelectedSceneNode(i);
+                    }
+                }
+
+                if (selected >= 0 && selected < size)
+                {
+                    ImGui::Separator();
+
+                    glm::vec3 position = GLFWglobals::openGLManager->getSceneNodePosition(selected);
+                    glm::vec3 rotation = GLFWglobals::openGLManager->getSceneNodeRotation(selected);
+                    glm::vec3 scale = GLFWglobals::openGLManager->getSceneNodeScale(selected);
+
+                    bool isChanged = ImGui::DragFloat3("Position", &position.x, 0.01f);
+                    isChanged |= ImGui::DragFloat3("Rotation", &rotation.x, 1.0f);
+                    isChanged |= ImGui::DragFloat3("Scale", &scale.x, 0.01f);
+
+                    if (isChanged)
+                        GLFWglobals::openGLManager->setSceneNodeTransform(selected, position, rotation, scale);
+                }
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Material", isCutObjectSelected))
             {
                 auto& materialsNames = GLFWglobals::openGLManager->getNaturalMaterialsNames();
                 int size = materialsNames.size();
@@ -294,7 +345,7 @@ namespace GLFW
                 ImGui::EndMenu();
             }
 
-            if (ImGui::BeginMenu("Texture"))
+            if (ImGui::BeginMenu("Texture", isCutObjectSelected))
             {
                 auto& texturesNames = GLFWglobals::openGLManager->getTexturesNames();
                 int size = texturesNames.size();
@@ -309,6 +360,130 @@ namespace GLFW
                 ImGui::EndMenu();
             }
 
+            if (ImGui::BeginMenu("Mesh", !isLoading && isCutObjectSelected))
+            {
+                bool isStreamingMode = GLFWglobals::openGLManager->getReplicatedCutStreamingMode();
+
+                if (ImGui::MenuItem("Streamed generation", nullptr, isStreamingMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutStreamingMode(!isStreamingMode);
+                }
+
+                bool isProceduralMode = GLFWglobals::openGLManager->getReplicatedCutProceduralMode();
+
+                if (ImGui::MenuItem("Procedural vertices", nullptr, isProceduralMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutProceduralMode(!isProceduralMode);
+                }
+
+                // the streamed and the procedural surfaces have their own vertex formats
+                bool isVertexFormatMode = !isStreamingMode && !isProceduralMode;
+                bool isIndexedMode = GLFWglobals::openGLManager->getReplicatedCutIndexedMode();
+
+                if (ImGui::MenuItem("Indexed vertices", nullptr, isIndexedMode, isVertexFormatMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutIndexedMode(!isIndexedMode);
+                }
+
+                bool isInterleavedMode = GLFWglobals::openGLManager->getReplicatedCutInterleavedMode();
+
+                if (ImGui::MenuItem("Interleaved vertices", nullptr, isInterleavedMode, isVertexFormatMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutInterleavedMode(!isInterleavedMode);
+                }
+
+                bool isPackedMode = GLFWglobals::openGLManager->getReplicatedCutPackedMode();
+
+                if (ImGui::MenuItem("Packed vertices", nullptr, isPackedMode, isVertexFormatMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutPackedMode(!isPackedMode);
+                }
+
+                bool isLodMode = GLFWglobals::openGLManager->getReplicatedCutLodMode();
+                std::string lodLevel = std::to_string(GLFWglobals::openGLManager->getReplicatedCutLodLevel()) + "/" +
+                    std::to_string(GLFWglobals::openGLManager->getReplicatedCutLodLevelsCount() - 1);
+
+                if (ImGui::MenuItem("Level of detail", lodLevel.c_str(), isLodMode, !isProceduralMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutLodMode(!isLodMode);
+                }
+
+                if (ImGui::BeginMenu("Frames"))
+                {
+                    FrameModes frameMode = GLFWglobals::openGLManager->getReplicatedCutFrameMode();
+
+                    if (ImGui::MenuItem("Rotation minimizing", nullptr, frameMode == Rotation_minimizing_frames))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutFrameMode(Rotation_minimizing_frames);
+                    }
+                    if (ImGui::MenuItem("Legacy", nullptr, frameMode == Legacy_frames))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutFrameMode(Legacy_frames);
+                    }
+
+                    ImGui::EndMenu();
+                }
+
+                bool isParallelMode = GLFWglobals::openGLManager->getReplicatedCutParallelMode();
+
+                if (ImGui::MenuItem("Parallel generation", nullptr, isParallelMode))
+                {
+                    GLFWglobals::openGLManager->setReplicatedCutParallelMode(!isParallelMode);
+                }
+
+                ImGui::EndMenu();
+            }
+
+            if (ImGui::BeginMenu("Trajectory", !isLoading && isCutObjectSelected))
+            {
+                if (ImGui::BeginMenu("Curve"))
+                {
+                    TrajectoryCurves curve = GLFWglobals::openGLManager->getReplicatedCutTrajectoryCurve();
+
+                    if (ImGui::MenuItem("Polyline", nullptr, curve == Polyline_curve))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutTrajectoryCurve(Polyline_curve);
+                    }
+                    if (ImGui::MenuItem("Catmull-Rom", nullptr, curve == Catmull_rom_curve))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutTrajectoryCurve(Catmull_rom_curve);
+                    }
+                    if (ImGui::MenuItem("B-spline", nullptr, curve == B_spline_curve))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutTrajectoryCurve(B_spline_curve);
+                    }
+                    if (ImGui::MenuItem("NURBS", nullptr, curve == Nurbs_curve))
+                    {
+                        GLFWglobals::openGLManager->setReplicatedCutTrajectoryCurve(Nurbs_curve);
+                    }
+
+                    ImGui::EndMenu();
+                }
+
+                int size = GLFWglobals::openGLManager->getReplicatedCutTrajectorySize();
+
+                if (size > 0)
+                {
+                    int& i = GLFWglobals::selectedTrajectoryPoint;
+                    i = glm::clamp(i, 0, size - 1);
+
+                    ImGui::SliderInt("Point", &i, 0, size - 1);
+
+                    glm::vec3 point = GLFWglobals::openGLManager->getReplicatedCutTrajectoryPoint(i);
+                    float position[3]{ point.x, point.y, point.z };
+
+                    if (ImGui::DragFloat3("Position", position, 0.01f))
+                        GLFWglobals::openGLManager->updateReplicatedCutTrajectoryPoint(i, glm::vec3(position[0], position[1], position[2]));
+
+                    float cutParameter = GLFWglobals::openGLManager->getReplicatedCutParameter(i);
+
+                    if (ImGui::DragFloat("Cut scale", &cutParameter, 0.01f, 0.0f, 100.0f))
+                        GLFWglobals::openGLManager->updateReplicatedCutParameter(i, cutParameter);
+                }
+
+                ImGui::EndMenu();
+            }
+
             if (ImGui::BeginMenu("Projection"))
             {
                 if (ImGui::MenuItem("Perspective"))
@@ -323,6 +498,23 @@ namespace GLFW
                 ImGui::EndMenu();
             }
 
+            std::string stateCalls = "State calls: " + std::to_string(GLFWglobals::openGLManager->getIssuedStateCallsCount()) + " issued, " +
+                std::to_string(GLFWglobals::openGLManager->getSkippedStateCallsCount()) + " skipped";
+            ImGui::TextUnformatted(stateCalls.c_str());
+
+            int failedCutObjectsCount = GLFWglobals::openGLManager->getFailedCutObjectsCount();
+
+            if (isLoading)
+            {
+                std::string overlay = "Loading " + std::to_string(loadingCutObjectsCount) + " cut objects";
+                ImGui::ProgressBar(GLFWglobals::openGLManager->getCutObjectsLoadingProgress(), ImVec2(200.0f, 0.0f), overlay.c_str());
+            }
+            else if (failedCutObjectsCount > 0)
+            {
+                std::string message = "Failed to load " + std::to_string(failedCutObjectsCount) + " cut objects";
+                ImGui::TextUnformatted(message.c_str());
+            }
+
             ImGui::EndMainMenuBar();
         }
 
@@ -22,6 +22,8 @@ namespace GLFWglobals
 
     extern float lastMousePositionX;
     extern float lastMousePositionY;
+
+    extern int selectedTrajectoryPoint;
 }
 
 namespace GLFW
@@ -0,0 +1,173 @@
+#include "GLState.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    // no object has this name, so the first call of every kind is issued
+    constexpr GLuint unknownName = std::numeric_limits<GLuint>::max();
+    constexpr GLenum unknownMode = 0;
+
+    GLuint currentProgram = unknownName;
+    GLuint currentVertexArray = unknownName;
+
+    std::unordered_map<GLenum, GLuint> buffers;
+    std::map<std::pair<GLenum, GLuint>, GLuint> indexedBuffers;
+    // the element buffer is a part of the vertex array state
+    std::unordered_map<GLuint, GLuint> elementBuffers;
+
+    std::array<GLuint, 16> textureUnits = [] { std::array<GLuint, 16> units; units.fill(unknownName); return units; }();
+    std::unordered_map<GLenum, bool> capabilities;
+    GLenum currentPolygonMode = unknownMode;
+
+    GLState::CallsStatistics frameStatistics;
+    GLState::CallsStatistics lastFrameStatistics;
+
+    template<typename T>
+    bool changeState(T& current, T value)
+    {
+        if (current == value)
+        {
+            ++frameStatistics.skipped;
+            return false;
+        }
+
+        current = value;
+        ++frameStatistics.issued;
+
+        return true;
+    }
+
+    GLuint& getCachedName(std::unordered_map<GLuint, GLuint>& names, GLuint key)
+    {
+        return names.try_emplace(key, unknownName).first->second;
+    }
+
+    void forgetBuffer(GLuint buffer)
+    {
+        for (auto& [target, bound] : buffers)
+            if (bound == buffer) bound = unknownName;
+
+        for (auto& [binding, bound] : indexedBuffers)
+            if (bound == buffer) bound = unknownName;
+
+        for (auto& [vao, bound] : elementBuffers)
+            if (bound == buffer) bound = unknownName;
+    }
+}
+
+namespace GLState
+{
+    void useProgram(GLuint program)
+    {
+        if (changeState(currentProgram, program))
+            glUseProgram(program);
+    }
+
+    void bindVertexArray(GLuint vao)
+    {
+        if (changeState(currentVertexArray, vao))
+            glBindVertexArray(vao);
+    }
+
+    void bindBuffer(GLenum target, GLuint buffer)
+    {
+        if (target != GL_ELEMENT_ARRAY_BUFFER)
+        {
+            if (changeState(getCachedName(buffers, target), buffer))
+                glBindBuffer(target, buffer);
+
+            return;
+        }
+
+        // the binding of an unknown vertex array can not be tracked
+        if (currentVertexArray == unknownName)
+        {
+            ++frameStatistics.issued;
+            glBindBuffer(target, buffer);
+            return;
+        }
+
+        if (changeState(getCachedName(elementBuffers, currentVertexArray), buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        auto binding = indexedBuffers.try_emplace({ target, index }, unknownName).first;
+
+        if (changeState(binding->second, buffer))
+        {
+            glBindBufferBase(target, index, buffer);
+            // the generic binding point of the target is changed too
+            getCachedName(buffers, target) = buffer;
+        }
+    }
+
+    void bindTextureUnit(GLuint unit, GLuint texture)
+    {
+        if (unit >= textureUnits.size())
+        {
+            ++frameStatistics.issued;
+            glBindTextureUnit(unit, texture);
+            return;
+        }
+
+        if (changeState(textureUnits[unit], texture))
+            glBindTextureUnit(unit, texture);
+    }
+
+    void setCapability(GLenum capability, bool isEnabled)
+    {
+        // an unknown capability is cached as the opposite state, so the first call is issued
+        bool& cached = capabilities.try_emplace(capability, !isEnabled).first->second;
+
+        if (changeState(cached, isEnabled))
+            isEnabled ? glEnable(capability) : glDisable(capability);
+    }
+
+    void setPolygonMode(GLenum mode)
+    {
+        if (changeState(currentPolygonMode, mode))
+            glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+
+    void deleteVertexArrays(GLsizei count, const GLuint* names)
+    {
+        for (GLsizei i = 0; i < count; ++i)
+        {
+            elementBuffers.erase(names[i]);
+
+            // the deleted bound vertex array is replaced by the default one
+            if (currentVertexArray == names[i])
+                currentVertexArray = 0;
+        }
+
+        glDeleteVertexArrays(count, names);
+    }
+
+    void deleteBuffers(GLsizei count, const GLuint* names)
+    {
+        for (GLsizei i = 0; i < count; ++i)
+            if (names[i] != 0) forgetBuffer(names[i]);
+
+        glDeleteBuffers(count, names);
+    }
+
+    void beginFrame()
+    {
+        lastFrameStatistics = frameStatistics;
+        frameStatistics = CallsStatistics{};
+    }
+
+    CallsStatistics getFrameStatistics()
+    {
+        return lastFrameStatistics;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+// the render paths change the context state only through these functions, the calls that would change nothing are skipped
+namespace GLState
+{
+    struct CallsStatistics
+    {
+        int issued = 0;
+        int skipped = 0;
+    };
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void bindTextureUnit(GLuint unit, GLuint texture);
+    void setCapability(GLenum capability, bool isEnabled);
+    void setPolygonMode(GLenum mode);
+
+    // the names of the deleted objects are forgotten, a new object can get the same name
+    void deleteVertexArrays(GLsizei count, const GLuint* names);
+    void deleteBuffers(GLsizei count, const GLuint* names);
+
+    // starts counting the calls of a new frame
+    void beginFrame();
+    CallsStatistics getFrameStatistics();
+}
+
+#endif
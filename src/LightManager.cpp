@@ -1,149 +1,152 @@
 #include "LightManager.h"
 
+#include "GLState.h"
 #include "LightTypes.h"
 #include "ShaderProgram.h"
 #include "Sphere.h"
+#include "TextScanner.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <format>
-#include <fstream>
 #include <iostream>
+#include <limits>
 
 LightManager::LightManager(ResourceManager* resourceManager, std::string_view fullFilePathGlobalLight, std::string_view fullFilePathPointLights)
 {
-    std::ifstream f;
+    TextScanner scanner;
 
-    f.open(fullFilePathGlobalLight.data());
-
-    if (!f.is_open())
+    if (!scanner.open(fullFilePathGlobalLight))
         std::cerr << "Failed to open global light file!" << std::endl;
     else
     {
-        glm::vec4* ambient = &m_globalAmbient.ambient;
-
-        f >> ambient->x >> ambient->y >> ambient->z >> ambient->w;
-
-        f.close();
+        scanner.read(glm::value_ptr(m_globalAmbient.ambient), 4);
+        scanner.close();
     }
 
-    f.open(fullFilePathPointLights.data());
-
-    if (!f.is_open())
+    if (!scanner.open(fullFilePathPointLights))
         std::cerr << "Failed to open point lights file!" << std::endl;
     else
     {
         int size = 0;
-        f >> size;
-        m_pointLight.resize(size);
+        scanner.read(size);
 
-        glm::vec4* ambient = nullptr;
-        glm::vec4* diffuse = nullptr;
-        glm::vec4* specular = nullptr;
-        glm::vec4* position = nullptr;
+        size = std::clamp(size, 0, m_maxPointLightCount);
+        m_pointLight.resize(size);
 
-        for (int i = 0; i < size; ++i)
+        for (int i = 0; i < size && !scanner.isFailed(); ++i)
         {
-            ambient = &m_pointLight[i].ambient;
-            diffuse = &m_pointLight[i].diffuse;
-            specular = &m_pointLight[i].specular;
-            position = &m_pointLight[i].position;
+            scanner.read(glm::value_ptr(m_pointLight[i].ambient), 4);
+            scanner.read(glm::value_ptr(m_pointLight[i].diffuse), 4);
+            scanner.read(glm::value_ptr(m_pointLight[i].specular), 4);
+            scanner.read(glm::value_ptr(m_pointLight[i].position), 3);
 
-            f >> ambient->x >> ambient->y >> ambient->z >> ambient->w;
-            f >> diffuse->x >> diffuse->y >> diffuse->z >> diffuse->w;
-            f >> specular->x >> specular->y >> specular->z >> specular->w;
-            f >> position->x >> position->y >> position->z;
-
-            position->w = 1.0f;
+            m_pointLight[i].position.w = defaultPointLightRange;
         }
 
-        f.close();
+        // a damaged file loads no point lights
+        if (scanner.isFailed())
+            m_pointLight.clear();
 
-        glGenBuffers(1, &m_lightsUniformBufferObject);
-        glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-        glBufferData(GL_UNIFORM_BUFFER, 1056, nullptr, GL_STATIC_DRAW);
-        glBindBufferRange(GL_UNIFORM_BUFFER, 1, m_lightsUniformBufferObject, 0, 1056);
+        scanner.close();
+    }
 
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, 16, glm::value_ptr(m_globalAmbient.ambient));
-        glBufferSubData(GL_UNIFORM_BUFFER, 16, 16, &size);
-        glBufferSubData(GL_UNIFORM_BUFFER, 32, 64 * size, m_pointLight.data());
+    glCreateBuffers(1, &m_lightsUniformBufferObject);
+    glNamedBufferData(m_lightsUniformBufferObject, 32 + sizeof(ClusterGrid), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, 1, m_lightsUniformBufferObject);
 
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    }
+    glNamedBufferSubData(m_lightsUniformBufferObject, 0, 16, glm::value_ptr(m_globalAmbient.ambient));
+    updateSizeUniformBufferObject();
+
+    // the storage holds the most lights, so adding one never moves the buffer
+    glCreateBuffers(1, &m_pointLightsBufferObject);
+    glNamedBufferData(m_pointLightsBufferObject, m_maxPointLightCount * sizeof(PointLight), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, pointLightsBufferBinding, m_pointLightsBufferObject);
+    updateFullPointLightsBufferObject();
+
+    m_clusters.resize(clustersCount);
+
+    glCreateBuffers(1, &m_clustersBufferObject);
+    glNamedBufferData(m_clustersBufferObject, clustersCount * sizeof(glm::uvec2), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, clustersBufferBinding, m_clustersBufferObject);
+
+    // the light lists grow with the lights in view
+    m_clusterLightsCapacity = clustersCount;
+
+    glCreateBuffers(1, &m_clusterLightsBufferObject);
+    glNamedBufferData(m_clusterLightsBufferObject, m_clusterLightsCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, clusterLightsBufferBinding, m_clusterLightsBufferObject);
 
-    Sphere lightSphere{};
+    glCreateBuffers(1, &m_lightMarkersBufferObject);
+    glNamedBufferData(m_lightMarkersBufferObject, (m_maxPointLightCount + 1) * sizeof(LightMarker), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, lightMarkersBufferBinding, m_lightMarkersBufferObject);
+
+    Sphere lightSphere(markerSpherePrecision);
     m_elementsSize = lightSphere.GetNumIndices();
 
-    m_defaultShaderProgram = resourceManager->getShaderProgram("defaultSP");
+    m_lightMarkerShaderProgram = resourceManager->getShaderProgram("lightMarkerSP");
+
+    glCreateVertexArrays(1, &m_vao);
+    glCreateBuffers(1, &m_lightSphereBufferObject);
+    glCreateBuffers(1, &m_lightSphereElementBufferObject);
 
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_lightSphereBufferObject);
-    glGenBuffers(1, &m_lightSphereElementBufferObject);
+    glNamedBufferData(m_lightSphereBufferObject, lightSphere.GetNumVertices() * sizeof(float) * 3, lightSphere.GetVertices().data(), GL_STATIC_DRAW);
+    glNamedBufferData(m_lightSphereElementBufferObject, lightSphere.GetNumIndices() * sizeof(int), lightSphere.GetIndices().data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_lightSphereBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, lightSphere.GetNumVertices() * sizeof(float) * 3, lightSphere.GetVertices().data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glVertexArrayVertexBuffer(m_vao, 0, m_lightSphereBufferObject, 0, sizeof(float) * 3);
+    glVertexArrayElementBuffer(m_vao, m_lightSphereElementBufferObject);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_lightSphereElementBufferObject);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, lightSphere.GetNumIndices() * sizeof(int), lightSphere.GetIndices().data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glEnableVertexArrayAttrib(m_vao, 0);
+    glVertexArrayAttribFormat(m_vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(m_vao, 0, 0);
 }
 
 LightManager::~LightManager()
 {
-    glDeleteVertexArrays(1, &m_vao);
-    glDeleteBuffers(1, &m_lightsUniformBufferObject);
-    glDeleteBuffers(1, &m_lightSphereBufferObject);
-    glDeleteBuffers(1, &m_lightSphereElementBufferObject);
+    GLState::deleteVertexArrays(1, &m_vao);
+    GLState::deleteBuffers(1, &m_lightsUniformBufferObject);
+    GLState::deleteBuffers(1, &m_pointLightsBufferObject);
+    GLState::deleteBuffers(1, &m_clustersBufferObject);
+    GLState::deleteBuffers(1, &m_clusterLightsBufferObject);
+    GLState::deleteBuffers(1, &m_lightMarkersBufferObject);
+    GLState::deleteBuffers(1, &m_lightSphereBufferObject);
+    GLState::deleteBuffers(1, &m_lightSphereElementBufferObject);
 }
 
 void LightManager::renderPointLights()
 {
-    m_defaultShaderProgram->use();
-    m_defaultShaderProgram->setVec3("color", glm::vec3(1.0f, 1.0f, 1.0f));
+    if (m_pointLight.empty())
+        return;
+
+    if (m_isLightMarkersChanged)
+        updateLightMarkersBufferObject();
 
-    glBindVertexArray(m_vao);
+    m_lightMarkerShaderProgram->use();
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_lightSphereBufferObject);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(0);
+    GLState::setPolygonMode(GL_FILL);
+    GLState::bindVertexArray(m_vao);
 
     glStencilFunc(GL_ALWAYS, 1, 0xFF);
     glStencilMask(0xFF);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_lightSphereElementBufferObject);
-    glm::mat4 model(1.0f);
+    int pointLightsCount = m_pointLight.size();
 
-    for (int i = 0; i < m_pointLight.size(); ++i)
-    {
-        model = glm::translate(glm::mat4(1.0f), glm::vec3(m_pointLight[i].position));
-        model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));
-        m_defaultShaderProgram->setMat4("model_matrix", model);
-
-        glDrawElements(GL_TRIANGLES, m_elementsSize, GL_UNSIGNED_INT, 0);
-    }
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, m_elementsSize, GL_UNSIGNED_INT, nullptr, pointLightsCount, 0);
 
     if (m_selectedPointLightSource != -1)
     {
         glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
         glStencilMask(0x00);
 
-        m_defaultShaderProgram->setVec3("color", glm::vec3(1.0f, 0.4f, 0.0f));
-
-        model = glm::translate(glm::mat4(1.0f), glm::vec3(m_pointLight[m_selectedPointLightSource].position));
-        model = glm::scale(model, glm::vec3(0.23f, 0.23f, 0.23f));
-        m_defaultShaderProgram->setMat4("model_matrix", model);
-
-        glDrawElements(GL_TRIANGLES, m_elementsSize, GL_UNSIGNED_INT, 0);
+        // the outline marker follows the markers of all lights
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, m_elementsSize, GL_UNSIGNED_INT, nullptr, 1, pointLightsCount);
 
         glStencilMask(0xFF);
         glStencilFunc(GL_ALWAYS, 0, 0xFF);
     }
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void LightManager::addPointLightSource()
@@ -155,12 +158,14 @@ void LightManager::addPointLightSource()
     defaultPointLight.ambient = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
     defaultPointLight.diffuse = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     defaultPointLight.specular = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-    defaultPointLight.position = glm::vec4(3.0f, 3.0f, -3.0f, 1.0f);
+    defaultPointLight.position = glm::vec4(3.0f, 3.0f, -3.0f, defaultPointLightRange);
 
     m_pointLight.push_back(defaultPointLight);
 
-    updateUniformBufferObject(m_pointLight.size() - 1);
+    updatePointLightBufferObject(m_pointLight.size() - 1);
     updateSizeUniformBufferObject();
+
+    m_isLightMarkersChanged = true;
 }
 
 void LightManager::deletePointLightSource(int index)
@@ -173,21 +178,19 @@ void LightManager::deletePointLightSource(int index)
     m_pointLight.erase(m_pointLight.begin() + index);
 
     updateSizeUniformBufferObject();
-    updateFullLightPointsInUniformBufferObject();
+    updateFullPointLightsBufferObject();
+
+    m_isLightMarkersChanged = true;
 }
 
 void LightManager::enableGlobalAmbient()
 {
-    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, 16, glm::value_ptr(m_globalAmbient.ambient));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glNamedBufferSubData(m_lightsUniformBufferObject, 0, 16, glm::value_ptr(m_globalAmbient.ambient));
 }
 
 void LightManager::disableGlobalAmbient()
 {
-    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, 16, glm::value_ptr(glm::vec4(0.0f)));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glNamedBufferSubData(m_lightsUniformBufferObject, 0, 16, glm::value_ptr(glm::vec4(0.0f)));
 }
 
 int LightManager::getPointLightSourceCounts()
@@ -227,8 +230,18 @@ glm::vec3 LightManager::getSpecularComponent(int index)
     return glm::vec3(m_pointLight[index].specular);
 }
 
+float LightManager::getRange(int index)
+{
+    if (index >= m_pointLight.size() || index < 0)
+        return 0.0f;
+
+    return m_pointLight[index].position.w;
+}
+
 void LightManager::setSelectedPointLight(int index)
 {
+    m_isLightMarkersChanged = true;
+
     if (index >= m_pointLight.size())
     {
         m_selectedPointLightSource = -1;
@@ -248,7 +261,9 @@ void LightManager::setSelectedPointLightPosition(int x, int y, int z, double del
         m_pointLight[index].position.y += y * m_speedCoeff * deltaTime;
         m_pointLight[index].position.z += z * m_speedCoeff * deltaTime;
 
-        updateUniformBufferObject(index);
+        updatePointLightBufferObject(index);
+
+        m_isLightMarkersChanged = true;
     }
 }
 
@@ -259,7 +274,7 @@ void LightManager::setAmbientComponent(int index, glm::vec3 ambient)
 
     m_pointLight[index].ambient = glm::vec4(ambient, 1.0f);
 
-    updateUniformBufferObject(index);
+    updatePointLightBufferObject(index);
 }
 
 void LightManager::setDiffuseComponent(int index, glm::vec3 diffuse)
@@ -269,7 +284,7 @@ void LightManager::setDiffuseComponent(int index, glm::vec3 diffuse)
 
     m_pointLight[index].diffuse = glm::vec4(diffuse, 1.0f);
 
-    updateUniformBufferObject(index);
+    updatePointLightBufferObject(index);
 }
 
 void LightManager::setSpecularComponent(int index, glm::vec3 specular)
@@ -279,30 +294,205 @@ void LightManager::setSpecularComponent(int index, glm::vec3 specular)
 
     m_pointLight[index].specular = glm::vec4(specular, 1.0f);
 
-    updateUniformBufferObject(index);
+    updatePointLightBufferObject(index);
 }
 
-void LightManager::updateUniformBufferObject(int index)
+void LightManager::setRange(int index, float range)
 {
-    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 32 + 64 * index, 64, &m_pointLight[index]);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    if (index >= m_pointLight.size() || index < 0)
+        return;
+
+    m_pointLight[index].position.w = std::max(range, 0.0f);
+
+    updatePointLightBufferObject(index);
+}
+
+void LightManager::updatePointLightBufferObject(int index)
+{
+    glNamedBufferSubData(m_pointLightsBufferObject, index * sizeof(PointLight), sizeof(PointLight), &m_pointLight[index]);
 }
 
 void LightManager::updateSizeUniformBufferObject()
 {
     int size = m_pointLight.size();
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 16, 16, &size);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glNamedBufferSubData(m_lightsUniformBufferObject, 16, sizeof(int), &size);
 }
 
-void LightManager::updateFullLightPointsInUniformBufferObject()
+void LightManager::updateFullPointLightsBufferObject()
 {
-    int size = m_pointLight.size();
+    if (!m_pointLight.empty())
+        glNamedBufferSubData(m_pointLightsBufferObject, 0, m_pointLight.size() * sizeof(PointLight), m_pointLight.data());
+}
+
+void LightManager::updateLightMarkersBufferObject()
+{
+    int pointLightsCount = m_pointLight.size();
+    m_lightMarkers.resize(pointLightsCount + 1);
+
+    for (int i = 0; i < pointLightsCount; ++i)
+    {
+        m_lightMarkers[i].positionScale = glm::vec4(glm::vec3(m_pointLight[i].position), markerScale);
+        m_lightMarkers[i].color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    if (m_selectedPointLightSource != -1)
+    {
+        glm::vec3 selectedPosition = m_pointLight[m_selectedPointLightSource].position;
+
+        m_lightMarkers[pointLightsCount].positionScale = glm::vec4(selectedPosition, selectedMarkerScale);
+        m_lightMarkers[pointLightsCount].color = glm::vec4(1.0f, 0.4f, 0.0f, 1.0f);
+    }
+
+    glNamedBufferSubData(m_lightMarkersBufferObject, 0, m_lightMarkers.size() * sizeof(LightMarker), m_lightMarkers.data());
+
+    m_isLightMarkersChanged = false;
+}
+
+void LightManager::updateClusters(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, int width, int height)
+{
+    if (width == 0 || height == 0)
+        return;
+
+    // the depth range of the grid is read from the projection, a perspective one is sliced logarithmically
+    bool isPerspective = projectionMatrix[3][3] == 0.0f;
+
+    if (isPerspective)
+    {
+        m_clusterNear = projectionMatrix[3][2] / (projectionMatrix[2][2] - 1.0f);
+        m_clusterFar = projectionMatrix[3][2] / (projectionMatrix[2][2] + 1.0f);
+    }
+    else
+    {
+        m_clusterNear = (projectionMatrix[3][2] + 1.0f) / projectionMatrix[2][2];
+        m_clusterFar = (projectionMatrix[3][2] - 1.0f) / projectionMatrix[2][2];
+    }
+
+    m_clusterGrid.size = glm::ivec4(clusterTilesX, clusterTilesY, clusterSlices, isPerspective);
+    m_clusterGrid.scale.x = static_cast<float>(clusterTilesX) / width;
+    m_clusterGrid.scale.y = static_cast<float>(clusterTilesY) / height;
+
+    if (isPerspective)
+    {
+        float logDepthRange = std::log(m_clusterFar / m_clusterNear);
+        m_clusterGrid.scale.z = clusterSlices / logDepthRange;
+        m_clusterGrid.scale.w = -clusterSlices * std::log(m_clusterNear) / logDepthRange;
+    }
+    else
+    {
+        m_clusterGrid.scale.z = clusterSlices / (m_clusterFar - m_clusterNear);
+        m_clusterGrid.scale.w = -m_clusterNear * m_clusterGrid.scale.z;
+    }
+
+    glNamedBufferSubData(m_lightsUniformBufferObject, 32, sizeof(ClusterGrid), &m_clusterGrid);
+
+    // the lights are counted per cluster first, then written after the prefix sums of the counts
+    std::fill(m_clusters.begin(), m_clusters.end(), glm::uvec2(0));
+    m_lightClusterBounds.resize(m_pointLight.size());
+
+    for (int i = 0; i < m_pointLight.size(); ++i)
+    {
+        ClusterBounds& bounds = m_lightClusterBounds[i];
+
+        if (!getClusterBounds(m_pointLight[i], viewMatrix, projectionMatrix, bounds))
+            continue;
+
+        for (int z = bounds.min.z; z <= bounds.max.z; ++z)
+            for (int y = bounds.min.y; y <= bounds.max.y; ++y)
+                for (int x = bounds.min.x; x <= bounds.max.x; ++x)
+                    ++m_clusters[(z * clusterTilesY + y) * clusterTilesX + x].y;
+    }
+
+    GLuint clusterLightsSize = 0;
+
+    for (glm::uvec2& cluster : m_clusters)
+    {
+        cluster.x = clusterLightsSize;
+        clusterLightsSize += cluster.y;
+        cluster.y = 0;
+    }
+
+    m_clusterLights.resize(clusterLightsSize);
+
+    for (int i = 0; i < m_pointLight.size(); ++i)
+    {
+        const ClusterBounds& bounds = m_lightClusterBounds[i];
+
+        for (int z = bounds.min.z; z <= bounds.max.z; ++z)
+            for (int y = bounds.min.y; y <= bounds.max.y; ++y)
+                for (int x = bounds.min.x; x <= bounds.max.x; ++x)
+                {
+                    glm::uvec2& cluster = m_clusters[(z * clusterTilesY + y) * clusterTilesX + x];
+                    m_clusterLights[cluster.x + cluster.y++] = i;
+                }
+    }
+
+    glNamedBufferSubData(m_clustersBufferObject, 0, m_clusters.size() * sizeof(glm::uvec2), m_clusters.data());
+
+    // the binding point keeps the buffer when its storage is specified again
+    if (m_clusterLights.size() > m_clusterLightsCapacity)
+    {
+        m_clusterLightsCapacity = std::max(m_clusterLights.size(), 2 * m_clusterLightsCapacity);
+        glNamedBufferData(m_clusterLightsBufferObject, m_clusterLightsCapacity * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    if (!m_clusterLights.empty())
+        glNamedBufferSubData(m_clusterLightsBufferObject, 0, m_clusterLights.size() * sizeof(GLuint), m_clusterLights.data());
+}
+
+bool LightManager::getClusterBounds(const PointLight& pointLight, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, ClusterBounds& bounds) const
+{
+    // an empty range, the loops over the clusters of a culled light do nothing
+    bounds = ClusterBounds{ glm::ivec3(0), glm::ivec3(-1) };
+
+    glm::vec3 center = viewMatrix * glm::vec4(glm::vec3(pointLight.position), 1.0f);
+    float range = pointLight.position.w;
+
+    float minDepth = -center.z - range;
+    float maxDepth = -center.z + range;
+
+    if (range <= 0.0f || maxDepth < m_clusterNear || minDepth > m_clusterFar)
+        return false;
+
+    bool isPerspective = m_clusterGrid.size.w != 0;
+
+    glm::vec2 minNdc(std::numeric_limits<float>::max());
+    glm::vec2 maxNdc(std::numeric_limits<float>::lowest());
+
+    // the corners of the view space box around the light bound its projection, once they are moved in front of the near plane
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec3 corner = center + range * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+
+        if (isPerspective)
+            corner.z = std::min(corner.z, -m_clusterNear);
+
+        glm::vec4 clip = projectionMatrix * glm::vec4(corner, 1.0f);
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+
+        minNdc = glm::min(minNdc, ndc);
+        maxNdc = glm::max(maxNdc, ndc);
+    }
+
+    if (minNdc.x > 1.0f || minNdc.y > 1.0f || maxNdc.x < -1.0f || maxNdc.y < -1.0f)
+        return false;
+
+    glm::vec2 tilesSize(clusterTilesX, clusterTilesY);
+    glm::ivec2 maxTile(clusterTilesX - 1, clusterTilesY - 1);
+
+    glm::ivec2 minTile = glm::clamp(glm::ivec2(glm::floor((glm::max(minNdc, -1.0f) * 0.5f + 0.5f) * tilesSize)), glm::ivec2(0), maxTile);
+    glm::ivec2 lastTile = glm::clamp(glm::ivec2(glm::floor((glm::min(maxNdc, 1.0f) * 0.5f + 0.5f) * tilesSize)), glm::ivec2(0), maxTile);
+
+    bounds.min = glm::ivec3(minTile, getDepthSlice(std::max(minDepth, m_clusterNear)));
+    bounds.max = glm::ivec3(lastTile, getDepthSlice(std::min(maxDepth, m_clusterFar)));
+
+    return true;
+}
+
+int LightManager::getDepthSlice(float depth) const
+{
+    // the same slice as the light fragment shader calculates
+    float slice = m_clusterGrid.size.w != 0 ? std::log(depth) * m_clusterGrid.scale.z + m_clusterGrid.scale.w : depth * m_clusterGrid.scale.z + m_clusterGrid.scale.w;
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 32, 64 * size, m_pointLight.data());
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return std::clamp(static_cast<int>(std::floor(slice)), 0, clusterSlices - 1);
 }
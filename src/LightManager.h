@@ -6,6 +6,7 @@
 #include "ShaderProgram.h"
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 #include <memory>
 #include <string_view>
@@ -19,6 +20,9 @@ public:
 
     void renderPointLights();
 
+    // bins the point lights into the clusters of the view frustum, the light shaders read only the lights of their cluster
+    void updateClusters(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, int width, int height);
+
     void addPointLightSource();
     void deletePointLightSource(int index);
 
@@ -30,24 +34,55 @@ public:
     glm::vec3 getAmbientComponent(int index);
     glm::vec3 getDiffuseComponent(int index);
     glm::vec3 getSpecularComponent(int index);
+    float getRange(int index);
 
     void setSelectedPointLight(int index);
     void setSelectedPointLightPosition(int x, int y, int z, double deltaTime);
     void setAmbientComponent(int index, glm::vec3 ambient);
     void setDiffuseComponent(int index, glm::vec3 diffuse);
     void setSpecularComponent(int index, glm::vec3 specular);
+    void setRange(int index, float range);
 
-    void updateUniformBufferObject(int index);
+    void updatePointLightBufferObject(int index);
     void updateSizeUniformBufferObject();
-    void updateFullLightPointsInUniformBufferObject();
+    void updateFullPointLightsBufferObject();
 
 private:
+    // inclusive ranges of the tiles and the depth slices a light reaches
+    struct ClusterBounds
+    {
+        glm::ivec3 min{};
+        glm::ivec3 max{};
+    };
+
+    bool getClusterBounds(const PointLight& pointLight, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, ClusterBounds& bounds) const;
+    int getDepthSlice(float depth) const;
+
+    void updateLightMarkersBufferObject();
+
+    static constexpr int clusterTilesX = 16;
+    static constexpr int clusterTilesY = 9;
+    static constexpr int clusterSlices = 24;
+    static constexpr int clustersCount = clusterTilesX * clusterTilesY * clusterSlices;
+
+    static constexpr GLuint pointLightsBufferBinding = 7;
+    static constexpr GLuint clustersBufferBinding = 8;
+    static constexpr GLuint clusterLightsBufferBinding = 9;
+    static constexpr GLuint lightMarkersBufferBinding = 10;
+
+    // the markers are small on screen, a coarse sphere keeps their cost low with many lights
+    static constexpr int markerSpherePrecision = 12;
+    static constexpr float markerScale = 0.2f;
+    static constexpr float selectedMarkerScale = 0.23f;
+
+    static constexpr float defaultPointLightRange = 20.0f;
+
     GlobalAmbientLight m_globalAmbient{};
     std::vector<PointLight> m_pointLight;
 
-    const int m_maxPointLightCount = 16;
+    const int m_maxPointLightCount = 4096;
 
-    std::shared_ptr<ShaderProgram> m_defaultShaderProgram = nullptr;
+    std::shared_ptr<ShaderProgram> m_lightMarkerShaderProgram = nullptr;
 
     GLuint m_vao{};
     GLuint m_lightSphereBufferObject{};
@@ -55,10 +90,28 @@ private:
 
     int m_elementsSize = 0;
 
+    // a marker for every light and the outline of the selected one after them
+    std::vector<LightMarker> m_lightMarkers;
+    GLuint m_lightMarkersBufferObject{};
+    bool m_isLightMarkersChanged = true;
+
     int m_selectedPointLightSource = -1;
     float m_speedCoeff = 5.0f;
 
     GLuint m_lightsUniformBufferObject{};
+    GLuint m_pointLightsBufferObject{};
+
+    ClusterGrid m_clusterGrid{};
+    float m_clusterNear = 0.0f;
+    float m_clusterFar = 0.0f;
+    std::vector<ClusterBounds> m_lightClusterBounds;
+    // first index in m_clusterLights and lights count of every cluster
+    std::vector<glm::uvec2> m_clusters;
+    std::vector<GLuint> m_clusterLights;
+
+    GLuint m_clustersBufferObject{};
+    GLuint m_clusterLightsBufferObject{};
+    size_t m_clusterLightsCapacity = 0;
 };
 
 #endif
\ No newline at end of file
@@ -13,7 +13,21 @@ struct PointLight
     glm::vec4 ambient{};
     glm::vec4 diffuse{};
     glm::vec4 specular{};
-    glm::vec4 position{};
+    glm::vec4 position{}; // w is the range, the light fades out towards it
+};
+
+// one instance of the light markers, the scale is stored in w of the position
+struct LightMarker
+{
+    glm::vec4 positionScale{};
+    glm::vec4 color{};
+};
+
+// layout of the cluster grid in the lights uniform buffer
+struct ClusterGrid
+{
+    glm::ivec4 size{}; // tiles along x and y, depth slices, whether the slices are logarithmic
+    glm::vec4 scale{}; // tiles per pixel along x and y, depth slice scale and bias
 };
 
 #endif
\ No newline at end of file
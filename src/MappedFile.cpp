@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+#include <string>
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(std::string_view path)
+{
+    close();
+
+    std::string filePath(path);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "Failed to open " << filePath << " for mapping!" << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // an empty file can not be mapped, it is kept open with no data
+    if (m_size == 0)
+        return true;
+
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    int file = ::open(filePath.c_str(), O_RDONLY);
+
+    if (file == -1)
+    {
+        std::cerr << "Failed to open " << filePath << " for mapping!" << std::endl;
+        return false;
+    }
+
+    struct stat status {};
+    fstat(file, &status);
+
+    m_size = static_cast<size_t>(status.st_size);
+
+    if (m_size == 0)
+    {
+        ::close(file);
+        return true;
+    }
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // the mapping keeps the file referenced on its own
+    ::close(file);
+
+    if (data != MAP_FAILED)
+    {
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+#endif
+
+    if (m_data == nullptr)
+    {
+        std::cerr << "Failed to map " << filePath << "!" << std::endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data)
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const char* MappedFile::getData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
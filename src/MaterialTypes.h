@@ -9,6 +9,9 @@ struct NaturalMaterial
     glm::vec4 diffuse{};
     glm::vec4 specular{};
     float shininess = 0;
+    float padding[3]{}; // array stride of the std430 materials buffer
 };
 
+static_assert(sizeof(NaturalMaterial) == 64, "NaturalMaterial must match the std430 layout of NaturalMaterial in the shaders!");
+
 #endif
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "OpenGLManager.h"
 
+#include "GLState.h"
 #include "LightManager.h"
 #include "ReplicatedCutObject.h"
 #include "ResourcesManager.h"
+#include "Scene.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -15,16 +17,19 @@ OpenGLManager::OpenGLManager(std::string_view executablePath, int mainWindowWidt
     m_mainWindowHeight(mainWindowHeight)
 {
     m_resourceManager = new ResourceManager(executablePath);
+    m_threadPool = new ThreadPool();
 }
 
 OpenGLManager::~OpenGLManager()
 {
+    // the loading tasks use the resources and the pool
+    if (m_scene) delete m_scene;
     if (m_resourceManager) delete m_resourceManager;
     if (m_lightManager) delete m_lightManager;
-    if (m_cutObject) delete m_cutObject;
     if (m_camera) delete m_camera;
+    if (m_threadPool) delete m_threadPool;
 
-    glDeleteBuffers(1, &m_matricesUniformBufferObject);
+    GLState::deleteBuffers(1, &m_matricesUniformBufferObject);
 }
 
 void OpenGLManager::init(GLFWwindow* window)
@@ -41,11 +46,32 @@ void OpenGLManager::init(GLFWwindow* window)
         "defaultLightSP", 
         "res/shaders/defaultLightVert.glsl", 
         "res/shaders/defaultLightFrag.glsl");
+    m_resourceManager->loadShaders(
+        "lightMarkerSP",
+        "res/shaders/lightMarkerVert.glsl",
+        "res/shaders/lightMarkerFrag.glsl");
     m_resourceManager->loadShaders(
         "defaultNormalsSP",
         "res/shaders/defaultNormalsVert.glsl",
         "res/shaders/defaultNormalsGeom.glsl",
         "res/shaders/defaultFrag.glsl");
+    m_resourceManager->loadShaders(
+        "proceduralSweepSP",
+        "res/shaders/proceduralSweepVert.glsl",
+        "res/shaders/defaultFrag.glsl");
+    m_resourceManager->loadShaders(
+        "proceduralSweepTextureSP",
+        "res/shaders/proceduralSweepVert.glsl",
+        "res/shaders/defaultTextureFrag.glsl");
+    m_resourceManager->loadShaders(
+        "proceduralSweepLightSP",
+        "res/shaders/proceduralSweepVert.glsl",
+        "res/shaders/defaultLightFrag.glsl");
+    m_resourceManager->loadShaders(
+        "proceduralSweepNormalsSP",
+        "res/shaders/proceduralSweepVert.glsl",
+        "res/shaders/defaultNormalsGeom.glsl",
+        "res/shaders/defaultFrag.glsl");
 
     std::string globalLightFilePath = m_resourceManager->getFullFilePath("res/data/light/globalLight.txt");
     std::string pointLightsFilePath = m_resourceManager->getFullFilePath("res/data/light/pointLights.txt");
@@ -58,11 +84,9 @@ void OpenGLManager::init(GLFWwindow* window)
     m_resourceManager->loadTextures("res/textures/");
     m_texturesNames = m_resourceManager->getTexturesNames();
 
-    std::string cutObjectFilePath = m_resourceManager->getFullFilePath("res/data/object/cutObject.txt");
-    m_cutObject = new ReplicatedCutObject(cutObjectFilePath, m_resourceManager, m_naturalMaterialNames[0], m_texturesNames[0]);
-    m_cutObject->prepareToRenderTrajectory();
-    m_cutObject->prepareToRenderTrajectoryCuts();
-    m_cutObject->prepareToRenderReplicatedCut();
+    std::string sceneFilePath = m_resourceManager->getFullFilePath("res/data/scene/scene.txt");
+    m_scene = new Scene(m_resourceManager, m_threadPool);
+    m_scene->load(sceneFilePath);
 
     m_camera = new Camera(OpenGLConstants::startCameraPosition);
 
@@ -80,88 +104,96 @@ void OpenGLManager::init(GLFWwindow* window)
         m_projectionMatrix = m_isPerspective ? m_perspectiveMatrix : m_orthographicMatrix;
     }
 
-    glGenBuffers(1, &m_matricesUniformBufferObject);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_matricesUniformBufferObject);
-    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_STATIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_matricesUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glCreateBuffers(1, &m_matricesUniformBufferObject);
+    glNamedBufferData(m_matricesUniformBufferObject, 2 * sizeof(glm::mat4), nullptr, GL_STATIC_DRAW);
+    glNamedBufferSubData(m_matricesUniformBufferObject, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, 0, m_matricesUniformBufferObject);
 }
 
 void OpenGLManager::display(GLFWwindow* window, double currentTime)
 {
+    GLState::beginFrame();
+
+    m_scene->update();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     glClearColor(0, 0, 0, 0);
-    glEnable(GL_DEPTH_TEST);
+    // the interface is drawn with its own state and restores this one
+    GLState::setCapability(GL_DEPTH_TEST, true);
+    GLState::setCapability(GL_STENCIL_TEST, true);
 
-    glEnable(GL_STENCIL_TEST);
     glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
     glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 
     m_viewMatrix = m_camera->getViewMatrix();
 
-    glBindBuffer(GL_UNIFORM_BUFFER, m_matricesUniformBufferObject);
-    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(m_viewMatrix));
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glNamedBufferSubData(m_matricesUniformBufferObject, sizeof(glm::mat4), sizeof(glm::mat4), glm::value_ptr(m_viewMatrix));
+
+    m_lightManager->updateClusters(m_viewMatrix, m_projectionMatrix, m_mainWindowWidth, m_mainWindowHeight);
 
     glStencilMask(0x00);
 
+    m_scene->prepareToRender(m_viewMatrix, m_projectionMatrix, m_mainWindowHeight);
+
+    for (const SceneBatch& batch : m_scene->getBatches())
+        renderCutObject(batch.cutObject, batch.instances);
+
+    m_lightManager->renderPointLights();
+}
+
+void OpenGLManager::renderCutObject(ReplicatedCutObject* cutObject, const InstanceRange& instances)
+{
     switch (m_displayMode)
     {
     case Trajectory:
-        m_cutObject->renderTrajectory(m_trajectoryColor);
+        cutObject->renderTrajectory(m_trajectoryColor, instances);
         break;
 
     case Trajectory_and_filled_cuts:
-        m_cutObject->renderTrajectory(m_trajectoryColor);
-        m_cutObject->renderTrajectoryCuts(m_cutsColor, false);
+        cutObject->renderTrajectory(m_trajectoryColor, instances);
+        cutObject->renderTrajectoryCuts(m_cutsColor, false, instances);
         break;
 
     case Trajectory_and_frame_cuts:
-        m_cutObject->renderTrajectory(m_trajectoryColor);
-        m_cutObject->renderTrajectoryCuts(m_cutsColor, true);
+        cutObject->renderTrajectory(m_trajectoryColor, instances);
+        cutObject->renderTrajectoryCuts(m_cutsColor, true, instances);
         break;
 
     case Replicated_cut_smoothing_normals_filled_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, false, true);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, false, true, instances);
         break;
 
     case Replicated_cut_no_smoothing_normals_filled_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, false, false);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, false, false, instances);
         break;
 
     case Replicated_cut_smoothing_normals_display_filled_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, true, true);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, true, true, instances);
         break;
 
     case Replicated_cut_no_smoothing_normals_display_filled_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, true, false);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, true, true, false, instances);
         break;
 
     case Replicated_cut_no_light_filled_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, false, false, false);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, false, false, false, false, instances);
         break;
 
     case Replicated_cut_simple_frame_surface:
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor,  true, false, false, false);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor,  true, false, false, false, instances);
         break;
 
     case Replicated_cut_trajectory_frame_surface:
-        m_cutObject->renderTrajectory(m_trajectoryColor);
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, true, false, false, false);
+        cutObject->renderTrajectory(m_trajectoryColor, instances);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, true, false, false, false, instances);
         break;
 
     case Replicated_cut_trajectory_and_cuts_frame_surface:
-        m_cutObject->renderTrajectory(m_trajectoryColor);
-        m_cutObject->renderTrajectoryCuts(m_cutsColor, true);
-        m_cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, true, false, false, false);
+        cutObject->renderTrajectory(m_trajectoryColor, instances);
+        cutObject->renderTrajectoryCuts(m_cutsColor, true, instances);
+        cutObject->renderReplicatedCut(m_replicatedCutColor, m_normalsColor, true, false, false, false, instances);
         break;
     }
-
-    m_lightManager->renderPointLights();
-
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_STENCIL_TEST);
 }
 
 void OpenGLManager::setDisplayMode(DisplayModes displayMode)
@@ -177,9 +209,7 @@ void OpenGLManager::setProjectionMode(bool isPerspective)
 
         m_projectionMatrix = m_isPerspective ? m_perspectiveMatrix : m_orthographicMatrix;
 
-        glBindBuffer(GL_UNIFORM_BUFFER, m_matricesUniformBufferObject);
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glNamedBufferSubData(m_matricesUniformBufferObject, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
     }
 }
 
@@ -201,12 +231,221 @@ const std::vector<std::string>& OpenGLManager::getTexturesNames()
 
 void OpenGLManager::setReplicatedCutMaterial(std::string materialName)
 {
-    m_cutObject->setMaterial(materialName);
+    m_scene->setNodeMaterial(m_selectedSceneNode, materialName);
+    getSelectedCutObject()->setTextureMode(false);
 }
 
 void OpenGLManager::setReplicatedCutTexture(std::string textureName)
 {
-    m_cutObject->setTexture(textureName);
+    getSelectedCutObject()->setTexture(textureName);
+}
+
+int OpenGLManager::getLoadingCutObjectsCount()
+{
+    return m_scene->getLoadingCutObjectsCount();
+}
+
+int OpenGLManager::getFailedCutObjectsCount()
+{
+    return m_scene->getFailedCutObjectsCount();
+}
+
+float OpenGLManager::getCutObjectsLoadingProgress()
+{
+    return m_scene->getLoadingProgress();
+}
+
+int OpenGLManager::getIssuedStateCallsCount()
+{
+    return GLState::getFrameStatistics().issued;
+}
+
+int OpenGLManager::getSkippedStateCallsCount()
+{
+    return GLState::getFrameStatistics().skipped;
+}
+
+int OpenGLManager::getSceneNodesCount()
+{
+    return m_scene->getNodesCount();
+}
+
+std::string OpenGLManager::getSceneNodeName(int index)
+{
+    return m_scene->getNodeName(index);
+}
+
+int OpenGLManager::getSceneNodeDepth(int index)
+{
+    return m_scene->getNodeDepth(index);
+}
+
+void OpenGLManager::setSelectedSceneNode(int index)
+{
+    m_selectedSceneNode = index;
+}
+
+int OpenGLManager::getSelectedSceneNode()
+{
+    return m_selectedSceneNode;
+}
+
+bool OpenGLManager::hasSelectedCutObject()
+{
+    return getSelectedCutObject() != nullptr;
+}
+
+glm::vec3 OpenGLManager::getSceneNodePosition(int index)
+{
+    return m_scene->getNodePosition(index);
+}
+
+glm::vec3 OpenGLManager::getSceneNodeRotation(int index)
+{
+    return m_scene->getNodeRotation(index);
+}
+
+glm::vec3 OpenGLManager::getSceneNodeScale(int index)
+{
+    return m_scene->getNodeScale(index);
+}
+
+void OpenGLManager::setSceneNodeTransform(int index, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    m_scene->setNodeTransform(index, position, rotation, scale);
+}
+
+void OpenGLManager::setReplicatedCutIndexedMode(bool isIndexedMode)
+{
+    getSelectedCutObject()->setIndexedMode(isIndexedMode);
+}
+
+bool OpenGLManager::getReplicatedCutIndexedMode()
+{
+    return getSelectedCutObject()->getIndexedMode();
+}
+
+void OpenGLManager::setReplicatedCutInterleavedMode(bool isInterleavedMode)
+{
+    getSelectedCutObject()->setInterleavedMode(isInterleavedMode);
+}
+
+bool OpenGLManager::getReplicatedCutInterleavedMode()
+{
+    return getSelectedCutObject()->getInterleavedMode();
+}
+
+void OpenGLManager::setReplicatedCutPackedMode(bool isPackedMode)
+{
+    getSelectedCutObject()->setPackedMode(isPackedMode);
+}
+
+bool OpenGLManager::getReplicatedCutPackedMode()
+{
+    return getSelectedCutObject()->getPackedMode();
+}
+
+void OpenGLManager::setReplicatedCutStreamingMode(bool isStreamingMode)
+{
+    getSelectedCutObject()->setStreamingMode(isStreamingMode);
+}
+
+bool OpenGLManager::getReplicatedCutStreamingMode()
+{
+    return getSelectedCutObject()->getStreamingMode();
+}
+
+void OpenGLManager::setReplicatedCutProceduralMode(bool isProceduralMode)
+{
+    getSelectedCutObject()->setProceduralMode(isProceduralMode);
+}
+
+bool OpenGLManager::getReplicatedCutProceduralMode()
+{
+    return getSelectedCutObject()->getProceduralMode();
+}
+
+void OpenGLManager::setReplicatedCutLodMode(bool isLodMode)
+{
+    getSelectedCutObject()->setLodMode(isLodMode);
+}
+
+bool OpenGLManager::getReplicatedCutLodMode()
+{
+    return getSelectedCutObject()->getLodMode();
+}
+
+int OpenGLManager::getReplicatedCutLodLevel()
+{
+    return getSelectedCutObject()->getLodLevel();
+}
+
+int OpenGLManager::getReplicatedCutLodLevelsCount()
+{
+    return getSelectedCutObject()->getLodLevelsCount();
+}
+
+void OpenGLManager::setReplicatedCutFrameMode(FrameModes frameMode)
+{
+    getSelectedCutObject()->setFrameMode(frameMode);
+}
+
+FrameModes OpenGLManager::getReplicatedCutFrameMode()
+{
+    return getSelectedCutObject()->getFrameMode();
+}
+
+void OpenGLManager::setReplicatedCutParallelMode(bool isParallelMode)
+{
+    getSelectedCutObject()->setParallelMode(isParallelMode);
+}
+
+bool OpenGLManager::getReplicatedCutParallelMode()
+{
+    return getSelectedCutObject()->getParallelMode();
+}
+
+void OpenGLManager::setReplicatedCutTrajectoryCurve(TrajectoryCurves trajectoryCurve)
+{
+    getSelectedCutObject()->setTrajectoryCurve(trajectoryCurve);
+    m_scene->invalidateCutObjectBounds(m_selectedSceneNode);
+}
+
+TrajectoryCurves OpenGLManager::getReplicatedCutTrajectoryCurve()
+{
+    return getSelectedCutObject()->getTrajectoryCurve();
+}
+
+int OpenGLManager::getReplicatedCutTrajectorySize()
+{
+    return getSelectedCutObject()->getTrajectorySize();
+}
+
+glm::vec3 OpenGLManager::getReplicatedCutTrajectoryPoint(int i)
+{
+    return getSelectedCutObject()->getTrajectoryPoint(i);
+}
+
+float OpenGLManager::getReplicatedCutParameter(int i)
+{
+    return getSelectedCutObject()->getCutParameter(i);
+}
+
+void OpenGLManager::updateReplicatedCutTrajectoryPoint(int i, const glm::vec3& point)
+{
+    getSelectedCutObject()->updateTrajectoryPoint(i, point);
+    m_scene->invalidateCutObjectBounds(m_selectedSceneNode);
+}
+
+void OpenGLManager::updateReplicatedCutParameter(int i, float cutParameter)
+{
+    getSelectedCutObject()->updateCutParameter(i, cutParameter);
+    m_scene->invalidateCutObjectBounds(m_selectedSceneNode);
+}
+
+ReplicatedCutObject* OpenGLManager::getSelectedCutObject()
+{
+    return m_scene->getCutObject(m_selectedSceneNode);
 }
 
 void OpenGLManager::addPointLightSource()
@@ -244,6 +483,11 @@ glm::vec3 OpenGLManager::getSpecularComponent(int index)
     return m_lightManager->getSpecularComponent(index);
 }
 
+float OpenGLManager::getPointLightRange(int index)
+{
+    return m_lightManager->getRange(index);
+}
+
 void OpenGLManager::setSelectedPointLight(int index)
 {
     m_lightManager->setSelectedPointLight(index);
@@ -269,6 +513,11 @@ void OpenGLManager::setSpecularComponent(int index, float* specular)
     m_lightManager->setSpecularComponent(index, glm::vec3(specular[0], specular[1], specular[2]));
 }
 
+void OpenGLManager::setPointLightRange(int index, float range)
+{
+    m_lightManager->setRange(index, range);
+}
+
 void OpenGLManager::windowResize(int width, int height)
 {
     m_mainWindowWidth = width;
@@ -288,9 +537,7 @@ void OpenGLManager::windowResize(int width, int height)
 
         m_projectionMatrix = m_isPerspective ? m_perspectiveMatrix : m_orthographicMatrix;
 
-        glBindBuffer(GL_UNIFORM_BUFFER, m_matricesUniformBufferObject);
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glNamedBufferSubData(m_matricesUniformBufferObject, 0, sizeof(glm::mat4), glm::value_ptr(m_projectionMatrix));
     }
 }
 
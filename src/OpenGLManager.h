@@ -6,6 +6,8 @@
 #include "LightManager.h"
 #include "ReplicatedCutObject.h"
 #include "ResourcesManager.h"
+#include "Scene.h"
+#include "ThreadPool.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -51,6 +53,54 @@ public:
     void setReplicatedCutMaterial(std::string materialName);
     void setReplicatedCutTexture(std::string textureName);
 
+    int getLoadingCutObjectsCount();
+    int getFailedCutObjectsCount();
+    float getCutObjectsLoadingProgress();
+
+    // the state changes of the last frame that reached the driver and that were skipped as redundant
+    int getIssuedStateCallsCount();
+    int getSkippedStateCallsCount();
+
+    // the cut object edits apply to the selected node, a group node has no cut object
+    int getSceneNodesCount();
+    std::string getSceneNodeName(int index);
+    int getSceneNodeDepth(int index);
+    void setSelectedSceneNode(int index);
+    int getSelectedSceneNode();
+    bool hasSelectedCutObject();
+
+    glm::vec3 getSceneNodePosition(int index);
+    glm::vec3 getSceneNodeRotation(int index);
+    glm::vec3 getSceneNodeScale(int index);
+    void setSceneNodeTransform(int index, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+    void setReplicatedCutIndexedMode(bool isIndexedMode);
+    bool getReplicatedCutIndexedMode();
+    void setReplicatedCutInterleavedMode(bool isInterleavedMode);
+    bool getReplicatedCutInterleavedMode();
+    void setReplicatedCutPackedMode(bool isPackedMode);
+    bool getReplicatedCutPackedMode();
+    void setReplicatedCutStreamingMode(bool isStreamingMode);
+    bool getReplicatedCutStreamingMode();
+    void setReplicatedCutProceduralMode(bool isProceduralMode);
+    bool getReplicatedCutProceduralMode();
+    void setReplicatedCutLodMode(bool isLodMode);
+    bool getReplicatedCutLodMode();
+    int getReplicatedCutLodLevel();
+    int getReplicatedCutLodLevelsCount();
+    void setReplicatedCutFrameMode(FrameModes frameMode);
+    FrameModes getReplicatedCutFrameMode();
+    void setReplicatedCutParallelMode(bool isParallelMode);
+    bool getReplicatedCutParallelMode();
+
+    void setReplicatedCutTrajectoryCurve(TrajectoryCurves trajectoryCurve);
+    TrajectoryCurves getReplicatedCutTrajectoryCurve();
+    int getReplicatedCutTrajectorySize();
+    glm::vec3 getReplicatedCutTrajectoryPoint(int i);
+    float getReplicatedCutParameter(int i);
+    void updateReplicatedCutTrajectoryPoint(int i, const glm::vec3& point);
+    void updateReplicatedCutParameter(int i, float cutParameter);
+
     void addPointLightSource();
     void deletePointLightSource(int index);
 
@@ -59,12 +109,14 @@ public:
     glm::vec3 getAmbientComponent(int index);
     glm::vec3 getDiffuseComponent(int index);
     glm::vec3 getSpecularComponent(int index);
+    float getPointLightRange(int index);
 
     void setSelectedPointLight(int index);
     void moveSelectedPointLight(int x, int y, int z, double deltaTime);
     void setAmbientComponent(int index, float* ambient);
     void setDiffuseComponent(int index, float* diffuse);
     void setSpecularComponent(int index, float* specular);
+    void setPointLightRange(int index, float range);
 
     void windowResize(int width, int height);
     void frontMovement(double deltaTime);
@@ -75,9 +127,14 @@ public:
     void mouseScroll(float yoffset);
 
 private:
+    ReplicatedCutObject* getSelectedCutObject();
+    void renderCutObject(ReplicatedCutObject* cutObject, const InstanceRange& instances);
+
     ResourceManager* m_resourceManager = nullptr;
-    ReplicatedCutObject* m_cutObject = nullptr;
+    Scene* m_scene = nullptr;
+    int m_selectedSceneNode = 0;
     LightManager* m_lightManager = nullptr;
+    ThreadPool* m_threadPool = nullptr;
 
     std::vector<std::string> m_naturalMaterialNames;
     std::vector<std::string> m_texturesNames;
@@ -0,0 +1,289 @@
+#include "ProfileTransform.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PROFILE_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+// the AVX2 kernel is built on every x86 compiler that can target it per function,
+// transform uses it only when the whole library is built for AVX2
+#if defined(__AVX2__) || defined(_M_X64) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#define PROFILE_TRANSFORM_AVX2
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) && !defined(__AVX2__)
+#define PROFILE_TRANSFORM_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define PROFILE_TRANSFORM_AVX2_TARGET
+#endif
+#endif
+
+void ProfileSoA::assign(const glm::vec2* points, int pointsSize)
+{
+    int paddedSize = (pointsSize + ProfileTransform::simdWidth - 1) / ProfileTransform::simdWidth * ProfileTransform::simdWidth;
+
+    x.assign(paddedSize, 0.0f);
+    y.assign(paddedSize, 0.0f);
+    size = pointsSize;
+
+    for (int i = 0; i < pointsSize; ++i)
+    {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+    }
+}
+
+void FramesSoA::resize(int framesSize)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        xAxis[i].resize(framesSize);
+        yAxis[i].resize(framesSize);
+        translation[i].resize(framesSize);
+    }
+
+    scale.resize(framesSize);
+    size = framesSize;
+}
+
+void FramesSoA::set(int index, const glm::mat3& rotation, const glm::vec3& frameTranslation, float frameScale)
+{
+    // the profile lies in the xy plane, so the third rotation column is never used
+    for (int i = 0; i < 3; ++i)
+    {
+        xAxis[i][index] = rotation[0][i];
+        yAxis[i][index] = rotation[1][i];
+        translation[i][index] = frameTranslation[i];
+    }
+
+    scale[index] = frameScale;
+}
+
+glm::vec3 FramesSoA::getXAxis(int index) const
+{
+    return glm::vec3(xAxis[0][index], xAxis[1][index], xAxis[2][index]);
+}
+
+glm::vec3 FramesSoA::getYAxis(int index) const
+{
+    return glm::vec3(yAxis[0][index], yAxis[1][index], yAxis[2][index]);
+}
+
+namespace
+{
+    // a block of transformed points is stored as rows on the stack and copied into the interleaved output,
+    // the profile and the frames are shared by the ring ranges that run in parallel
+    void copyToOutput(const float* x, const float* y, const float* z, int size, glm::vec3* output)
+    {
+        for (int j = 0; j < size; ++j)
+            output[j] = glm::vec3(x[j], y[j], z[j]);
+    }
+
+#if defined(PROFILE_TRANSFORM_AVX2)
+    PROFILE_TRANSFORM_AVX2_TARGET void transformAvx2Rings(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride)
+    {
+        const float* px = profile.x.data();
+        const float* py = profile.y.data();
+
+        for (int i = begin; i < end; ++i)
+        {
+            __m256 s = _mm256_set1_ps(frames.scale[i]);
+
+            __m256 ax = _mm256_set1_ps(frames.xAxis[0][i]);
+            __m256 ay = _mm256_set1_ps(frames.xAxis[1][i]);
+            __m256 az = _mm256_set1_ps(frames.xAxis[2][i]);
+            __m256 bx = _mm256_set1_ps(frames.yAxis[0][i]);
+            __m256 by = _mm256_set1_ps(frames.yAxis[1][i]);
+            __m256 bz = _mm256_set1_ps(frames.yAxis[2][i]);
+            __m256 tx = _mm256_set1_ps(frames.translation[0][i]);
+            __m256 ty = _mm256_set1_ps(frames.translation[1][i]);
+            __m256 tz = _mm256_set1_ps(frames.translation[2][i]);
+
+            glm::vec3* ring = output + static_cast<size_t>(i - begin) * outputStride;
+
+            // the profile is padded, so the last block reads whole registers
+            for (int j = 0; j < profile.size; j += 8)
+            {
+                alignas(32) float outX[8];
+                alignas(32) float outY[8];
+                alignas(32) float outZ[8];
+
+                __m256 vx = _mm256_mul_ps(s, _mm256_loadu_ps(px + j));
+                __m256 vy = _mm256_mul_ps(s, _mm256_loadu_ps(py + j));
+
+                _mm256_store_ps(outX, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, vx), _mm256_mul_ps(bx, vy)), tx));
+                _mm256_store_ps(outY, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ay, vx), _mm256_mul_ps(by, vy)), ty));
+                _mm256_store_ps(outZ, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(az, vx), _mm256_mul_ps(bz, vy)), tz));
+
+                copyToOutput(outX, outY, outZ, std::min(8, profile.size - j), ring + j);
+            }
+        }
+    }
+#endif
+}
+
+const char* ProfileTransform::getKernelName()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(PROFILE_TRANSFORM_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void ProfileTransform::transformScalar(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float s = frames.scale[i];
+
+        glm::vec3 xAxis(frames.xAxis[0][i], frames.xAxis[1][i], frames.xAxis[2][i]);
+        glm::vec3 yAxis(frames.yAxis[0][i], frames.yAxis[1][i], frames.yAxis[2][i]);
+        glm::vec3 translation(frames.translation[0][i], frames.translation[1][i], frames.translation[2][i]);
+
+        glm::vec3* ring = output + static_cast<size_t>(i - begin) * outputStride;
+
+        // same operations order as rotate * vec3(scale * point, 0) + translate
+        for (int j = 0; j < profile.size; ++j)
+        {
+            float vx = s * profile.x[j];
+            float vy = s * profile.y[j];
+
+            ring[j] = (xAxis * vx + yAxis * vy) + translation;
+        }
+    }
+}
+
+void ProfileTransform::transform(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride)
+{
+#if defined(__AVX2__)
+    transformAvx2(profile, frames, begin, end, output, outputStride);
+#elif defined(PROFILE_TRANSFORM_SSE2)
+    transformSse2(profile, frames, begin, end, output, outputStride);
+#else
+    transformScalar(profile, frames, begin, end, output, outputStride);
+#endif
+}
+
+bool ProfileTransform::transformSse2(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride)
+{
+#if defined(PROFILE_TRANSFORM_SSE2)
+    const float* px = profile.x.data();
+    const float* py = profile.y.data();
+
+    for (int i = begin; i < end; ++i)
+    {
+        __m128 s = _mm_set1_ps(frames.scale[i]);
+
+        __m128 ax = _mm_set1_ps(frames.xAxis[0][i]);
+        __m128 ay = _mm_set1_ps(frames.xAxis[1][i]);
+        __m128 az = _mm_set1_ps(frames.xAxis[2][i]);
+        __m128 bx = _mm_set1_ps(frames.yAxis[0][i]);
+        __m128 by = _mm_set1_ps(frames.yAxis[1][i]);
+        __m128 bz = _mm_set1_ps(frames.yAxis[2][i]);
+        __m128 tx = _mm_set1_ps(frames.translation[0][i]);
+        __m128 ty = _mm_set1_ps(frames.translation[1][i]);
+        __m128 tz = _mm_set1_ps(frames.translation[2][i]);
+
+        glm::vec3* ring = output + static_cast<size_t>(i - begin) * outputStride;
+
+        for (int j = 0; j < profile.size; j += 4)
+        {
+            alignas(16) float outX[4];
+            alignas(16) float outY[4];
+            alignas(16) float outZ[4];
+
+            __m128 vx = _mm_mul_ps(s, _mm_loadu_ps(px + j));
+            __m128 vy = _mm_mul_ps(s, _mm_loadu_ps(py + j));
+
+            _mm_store_ps(outX, _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, vx), _mm_mul_ps(bx, vy)), tx));
+            _mm_store_ps(outY, _mm_add_ps(_mm_add_ps(_mm_mul_ps(ay, vx), _mm_mul_ps(by, vy)), ty));
+            _mm_store_ps(outZ, _mm_add_ps(_mm_add_ps(_mm_mul_ps(az, vx), _mm_mul_ps(bz, vy)), tz));
+
+            copyToOutput(outX, outY, outZ, std::min(4, profile.size - j), ring + j);
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ProfileTransform::transformAvx2(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride)
+{
+#if defined(PROFILE_TRANSFORM_AVX2)
+    if (!isAvx2Supported())
+        return false;
+
+    transformAvx2Rings(profile, frames, begin, end, output, outputStride);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ProfileTransform::isAvx2Supported()
+{
+#if defined(__AVX2__)
+    return true;
+#elif defined(PROFILE_TRANSFORM_AVX2) && defined(__GNUC__)
+    return __builtin_cpu_supports("avx2");
+#elif defined(PROFILE_TRANSFORM_AVX2) && defined(_MSC_VER)
+    int info[4]{};
+
+    // the processor has AVX2 and the system saves the ymm registers
+    __cpuid(info, 1);
+    bool isOsSaved = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+
+    __cpuidex(info, 7, 0);
+    return isOsSaved && (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+float ProfileTransform::calcMaxError(const ProfileSoA& profile, const FramesSoA& frames, int samplesCount)
+{
+    if (frames.size == 0 || profile.size == 0)
+        return 0.0f;
+
+    int step = std::max(1, frames.size / std::max(samplesCount, 1));
+
+    std::vector<glm::vec3> ring(profile.size);
+    float maxError = 0.0f;
+
+    for (int i = 0; i < frames.size; i += step)
+    {
+        // zero stride writes the single frame at the start of ring
+        transform(profile, frames, i, i + 1, ring.data(), 0);
+
+        glm::mat3 rotate(glm::vec3(frames.xAxis[0][i], frames.xAxis[1][i], frames.xAxis[2][i]),
+                         glm::vec3(frames.yAxis[0][i], frames.yAxis[1][i], frames.yAxis[2][i]),
+                         glm::vec3(0.0f));
+        glm::vec3 translate(frames.translation[0][i], frames.translation[1][i], frames.translation[2][i]);
+        glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(frames.scale[i]));
+
+        for (int j = 0; j < profile.size; ++j)
+        {
+            glm::vec2 scaledVertex = glm::vec2(scale * glm::vec4(profile.x[j], profile.y[j], 0.0f, 1.0f));
+            glm::vec3 expected = rotate * glm::vec3(scaledVertex, 0.0f) + translate;
+
+            glm::vec3 difference = glm::abs(ring[j] - expected) / glm::max(glm::abs(expected), glm::vec3(1.0f));
+            maxError = std::max({ maxError, difference.x, difference.y, difference.z });
+        }
+    }
+
+    return maxError;
+}
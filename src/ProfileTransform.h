@@ -0,0 +1,56 @@
+#ifndef PROFILE_TRANSFORM_H
+#define PROFILE_TRANSFORM_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Profile points as separate coordinate arrays, padded with zeros up to a multiple of the SIMD width
+struct ProfileSoA
+{
+    void assign(const glm::vec2* points, int pointsSize);
+
+    std::vector<float> x;
+    std::vector<float> y;
+    int size = 0;
+};
+
+// Per-frame rotation columns, translation and uniform profile scale as separate arrays
+struct FramesSoA
+{
+    void resize(int framesSize);
+    void set(int index, const glm::mat3& rotation, const glm::vec3& translation, float scale);
+
+    glm::vec3 getXAxis(int index) const;
+    glm::vec3 getYAxis(int index) const;
+
+    std::vector<float> xAxis[3];
+    std::vector<float> yAxis[3];
+    std::vector<float> translation[3];
+    std::vector<float> scale;
+    int size = 0;
+};
+
+namespace ProfileTransform
+{
+    static constexpr int simdWidth = 8;
+
+    // "AVX2", "SSE2" or "scalar", chosen at compile time
+    const char* getKernelName();
+
+    // point j of frame i goes to output[(i - begin) * outputStride + j]
+    void transform(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride);
+    void transformScalar(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride);
+
+    // the SIMD kernels whatever transform uses, so they can be checked against the scalar one.
+    // They return false when the kernel is not built for this target or the processor does not support it
+    bool transformSse2(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride);
+    bool transformAvx2(const ProfileSoA& profile, const FramesSoA& frames, int begin, int end, glm::vec3* output, int outputStride);
+    bool isAvx2Supported();
+
+    // largest coordinate difference between the kernel and the glm matrix path over about samplesCount frames,
+    // relative to the coordinate magnitude when it is above 1
+    float calcMaxError(const ProfileSoA& profile, const FramesSoA& frames, int samplesCount = 64);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "ProfileTransform.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int framesSize = 4096;
+    constexpr int profileSize = 37; // not a multiple of the SIMD width, so the padding is checked too
+    constexpr float maxError = 1e-5f;
+
+    using Kernel = bool (*)(const ProfileSoA&, const FramesSoA&, int, int, glm::vec3*, int);
+
+    // largest coordinate difference relative to the coordinate magnitude when it is above 1
+    float calcDifference(const std::vector<glm::vec3>& result, const std::vector<glm::vec3>& reference)
+    {
+        float difference = 0.0f;
+
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            glm::vec3 relative = glm::abs(result[i] - reference[i]) / glm::max(glm::abs(reference[i]), glm::vec3(1.0f));
+            difference = std::max({ difference, relative.x, relative.y, relative.z });
+        }
+
+        return difference;
+    }
+
+    // a kernel that is not built or not supported by the processor is skipped
+    bool checkKernel(const char* name, Kernel kernel, const ProfileSoA& profile, const FramesSoA& frames, const std::vector<glm::vec3>& reference)
+    {
+        std::vector<glm::vec3> result(reference.size());
+
+        if (!kernel(profile, frames, 0, frames.size, result.data(), profile.size))
+        {
+            std::cout << name << ": skipped" << std::endl;
+            return true;
+        }
+
+        float difference = calcDifference(result, reference);
+        std::cout << name << ": max error " << difference << std::endl;
+
+        if (difference > maxError)
+        {
+            std::cerr << name << " profile transform error is above the tolerance!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+}
+
+// compares the SIMD profile transform kernels with the scalar one and the kernel of the build with the matrix path
+int main()
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<glm::vec2> points(profileSize);
+
+    for (glm::vec2& point : points)
+        point = glm::vec2(unit(generator), unit(generator)) * 5.0f;
+
+    ProfileSoA profile;
+    profile.assign(points.data(), profileSize);
+
+    FramesSoA frames;
+    frames.resize(framesSize);
+
+    for (int i = 0; i < framesSize; ++i)
+    {
+        glm::vec3 axis = glm::vec3(unit(generator), unit(generator), unit(generator)) + glm::vec3(0.0f, 0.0f, 2.0f);
+        glm::mat3 rotation = glm::mat3(glm::rotate(glm::mat4(1.0f), unit(generator) * 3.1415927f, glm::normalize(axis)));
+        glm::vec3 translation = glm::vec3(unit(generator), unit(generator), unit(generator)) * 100.0f;
+
+        frames.set(i, rotation, translation, 5.0f + 4.9f * unit(generator));
+    }
+
+    std::vector<glm::vec3> reference(framesSize * profileSize);
+    ProfileTransform::transformScalar(profile, frames, 0, framesSize, reference.data(), profileSize);
+
+    bool isPassed = checkKernel("SSE2", ProfileTransform::transformSse2, profile, frames, reference);
+    isPassed = checkKernel("AVX2", ProfileTransform::transformAvx2, profile, frames, reference) && isPassed;
+
+    float matrixPathError = ProfileTransform::calcMaxError(profile, frames, framesSize);
+    std::cout << ProfileTransform::getKernelName() << " against the matrix path: max error " << matrixPathError << std::endl;
+
+    if (matrixPathError > maxError)
+    {
+        std::cerr << ProfileTransform::getKernelName() << " profile transform error is above the tolerance!" << std::endl;
+        isPassed = false;
+    }
+
+    return isPassed ? 0 : 1;
+}
@@ -1,707 +1,1719 @@
 #include "ReplicatedCutObject.h"
 
+#include "GLState.h"
 #include "ResourcesManager.h"
+#include "SweepGenerator.h"
 
 #include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
 
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <new>
+#include <string>
 #include <string_view>
+#include <utility>
 
-ReplicatedCutObject::ReplicatedCutObject(std::string_view fullFilePath, ResourceManager* resourceManager, std::string_view material, std::string_view texture)
+ReplicatedCutObject::ReplicatedCutObject(CutObjectData data, ResourceManager* resourceManager, std::string_view texture, ThreadPool* threadPool)
 {
     m_resourceManager = resourceManager;
 
+    setThreadPool(threadPool);
+
     m_defaultShaderProgram = m_resourceManager->getShaderProgram("defaultSP");
     m_defaultTextureShaderProgram = m_resourceManager->getShaderProgram("defaultTextureSP");
     m_defaultLightShaderProgram = m_resourceManager->getShaderProgram("defaultLightSP");
     m_defaultNormalsShaderProgram = m_resourceManager->getShaderProgram("defaultNormalsSP");
+    m_proceduralShaderProgram = m_resourceManager->getShaderProgram("proceduralSweepSP");
+    m_proceduralTextureShaderProgram = m_resourceManager->getShaderProgram("proceduralSweepTextureSP");
+    m_proceduralLightShaderProgram = m_resourceManager->getShaderProgram("proceduralSweepLightSP");
+    m_proceduralNormalsShaderProgram = m_resourceManager->getShaderProgram("proceduralSweepNormalsSP");
+
+    m_defaultUniforms = getSweepUniforms(m_defaultShaderProgram);
+    m_defaultTextureUniforms = getSweepUniforms(m_defaultTextureShaderProgram);
+    m_defaultLightUniforms = getSweepUniforms(m_defaultLightShaderProgram);
+    m_defaultNormalsUniforms = getSweepUniforms(m_defaultNormalsShaderProgram);
+    m_proceduralUniforms = getSweepUniforms(m_proceduralShaderProgram);
+    m_proceduralTextureUniforms = getSweepUniforms(m_proceduralTextureShaderProgram);
+    m_proceduralLightUniforms = getSweepUniforms(m_proceduralLightShaderProgram);
+    m_proceduralNormalsUniforms = getSweepUniforms(m_proceduralNormalsShaderProgram);
+
+    m_texture = resourceManager->getTexture(texture);
+
+    m_cut = std::move(data.cut);
+    m_controlPoints = std::move(data.controlPoints);
+    m_controlCutParameters = std::move(data.cutParameters);
+    m_controlWeights = std::move(data.weights);
+    m_trajectoryCurve = data.curve;
+
+    sampleTrajectory();
+}
+
+ReplicatedCutObject::~ReplicatedCutObject()
+{
+    GLState::deleteVertexArrays(1, &m_trajectoryVao);
+    GLState::deleteVertexArrays(1, &m_trajectoryCutsVao);
+    GLState::deleteBuffers(1, &m_trajectoryBufferObject);
+    GLState::deleteBuffers(1, &m_trajectoryCutsBufferObject);
+    GLState::deleteBuffers(1, &m_trajectoryCutsElementBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutNormalsBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutSmoothedNormalsBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutTextureBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutElementBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutInterleavedBufferObject);
+    GLState::deleteBuffers(1, &m_replicatedCutPackedBoundsBufferObject);
+    GLState::deleteBuffers(1, &m_sweepFramesBufferObject);
+    GLState::deleteBuffers(1, &m_sweepProfileBufferObject);
+    GLState::deleteVertexArrays(1, &m_proceduralVao);
+    GLState::deleteVertexArrays(Vertex_configurations_count, m_replicatedCutVaos);
+
+    // the task writes into the object, so it is waited for
+    if (m_lodTask.valid())
+        m_lodTask.wait();
+
+    clearLods();
+}
+
+void ReplicatedCutObject::generate()
+{
+    SweepInput input = getSweepInput();
+
+    // streamed surfaces are generated while they are uploaded
+    if (!SweepGenerator::isValidInput(input) || m_isStreamingMode)
+        return;
+
+    m_translatedCut.resize(SweepGenerator::getTrajectoryCutsSize(input.cutSize, input.trajectorySize));
+    m_sweepGenerator.generateTrajectoryCuts(input, m_translatedCut.data());
+
+    m_isSweepPrepared = true;
+
+    buildReplicatedCut(input);
+
+    if (m_isLodMode && !m_isProceduralMode)
+    {
+        m_lods = generateLods(input, m_sweepGenerator.getFrameXAxes(), m_sweepGenerator.getFrameMode(), m_isSmoothMesh, m_boundsRadius, m_sweepGenerator.getThreadPool());
+        m_isLodOutdated = false;
+    }
+}
+
+void ReplicatedCutObject::upload()
+{
+    generateBuffers();
+    prepareToRenderTrajectory();
+
+    // an empty object stands in for one that is still loading
+    if (m_cut.empty() && m_controlPoints.empty())
+        return;
+
+    if (!m_isSweepPrepared)
+    {
+        prepareToRenderTrajectoryCuts();
+        prepareToRenderReplicatedCut();
+        return;
+    }
+
+    setBufferStorage(m_trajectoryCutsBufferObject, m_translatedCut.size() * sizeof(glm::vec3), m_translatedCut.data());
+    uploadTrajectoryCutsIndices(m_cut.size(), m_trajectory.size());
+    setupTrajectoryVertexArray(m_trajectoryCutsVao, m_trajectoryCutsBufferObject, m_trajectoryCutsElementBufferObject);
+
+    uploadReplicatedCut();
+    uploadLods();
+}
+
+void ReplicatedCutObject::copyAppearance(const ReplicatedCutObject& cutObject)
+{
+    m_texture = cutObject.m_texture;
+    m_isTextureMode = cutObject.m_isTextureMode;
+    m_isLodMode = cutObject.m_isLodMode;
+}
+
+void ReplicatedCutObject::setTexture(std::string texture)
+{
+    m_texture = m_resourceManager->getTexture(texture);
+    m_isTextureMode = true;
+}
+
+void ReplicatedCutObject::setTextureMode(bool isTextureMode)
+{
+    m_isTextureMode = isTextureMode;
+}
+
+bool ReplicatedCutObject::getTextureMode() const
+{
+    return m_isTextureMode;
+}
+
+void ReplicatedCutObject::setIndexedMode(bool isIndexedMode)
+{
+    if (m_isIndexedMode == isIndexedMode)
+        return;
+
+    m_isIndexedMode = isIndexedMode;
+
+    if (m_isSweepPrepared && !m_isStreamingMode)
+        prepareToRenderReplicatedCut();
+}
+
+bool ReplicatedCutObject::getIndexedMode() const
+{
+    return m_isIndexedMode;
+}
+
+void ReplicatedCutObject::setInterleavedMode(bool isInterleavedMode)
+{
+    if (m_isInterleavedMode == isInterleavedMode)
+        return;
+
+    m_isInterleavedMode = isInterleavedMode;
+
+    if (m_isSweepPrepared && !m_isStreamingMode)
+        prepareToRenderReplicatedCut();
+}
+
+bool ReplicatedCutObject::getInterleavedMode() const
+{
+    return m_isInterleavedMode;
+}
+
+void ReplicatedCutObject::setPackedMode(bool isPackedMode)
+{
+    if (m_isPackedMode == isPackedMode)
+        return;
+
+    m_isPackedMode = isPackedMode;
+
+    if (m_isSweepPrepared && !m_isStreamingMode)
+        prepareToRenderReplicatedCut();
+}
+
+bool ReplicatedCutObject::getPackedMode() const
+{
+    return m_isPackedMode;
+}
+
+void ReplicatedCutObject::setStreamingMode(bool isStreamingMode)
+{
+    if (m_isStreamingMode == isStreamingMode)
+        return;
+
+    m_isStreamingMode = isStreamingMode;
+
+    if (m_isSweepPrepared)
+    {
+        prepareToRenderTrajectoryCuts();
+        prepareToRenderReplicatedCut();
+    }
+}
+
+bool ReplicatedCutObject::getStreamingMode() const
+{
+    return m_isStreamingMode;
+}
+
+void ReplicatedCutObject::setProceduralMode(bool isProceduralMode)
+{
+    if (m_isProceduralMode == isProceduralMode)
+        return;
+
+    m_isProceduralMode = isProceduralMode;
+
+    if (m_isProceduralMode)
+        m_lodLevel = 0;
+
+    if (m_isSweepPrepared)
+        prepareToRenderReplicatedCut();
+}
+
+bool ReplicatedCutObject::getProceduralMode() const
+{
+    return m_isProceduralMode;
+}
+
+void ReplicatedCutObject::setFrameMode(FrameModes frameMode)
+{
+    if (m_sweepGenerator.getFrameMode() == frameMode)
+        return;
+
+    m_sweepGenerator.setFrameMode(frameMode);
+
+    if (m_isSweepPrepared)
+    {
+        prepareToRenderTrajectoryCuts();
+        prepareToRenderReplicatedCut();
+    }
+}
+
+FrameModes ReplicatedCutObject::getFrameMode() const
+{
+    return m_sweepGenerator.getFrameMode();
+}
+
+void ReplicatedCutObject::setLodMode(bool isLodMode)
+{
+    m_isLodMode = isLodMode;
+
+    if (!m_isLodMode)
+        m_lodLevel = 0;
+}
+
+bool ReplicatedCutObject::getLodMode() const
+{
+    return m_isLodMode;
+}
+
+int ReplicatedCutObject::getLodLevel() const
+{
+    return m_lodLevel;
+}
+
+int ReplicatedCutObject::getLodLevelsCount() const
+{
+    return m_lods.size() + 1;
+}
+
+void ReplicatedCutObject::selectLod(const glm::mat4& modelViewMatrix, const glm::mat4& projectionMatrix, int viewportHeight)
+{
+    if (!m_isLodMode || m_isProceduralMode)
+        return;
+
+    finishLodTask();
+
+    if (m_isLodOutdated && !m_threadPool)
+        buildLods();
+    else if (m_isLodOutdated && !m_lodTask.valid())
+        startLodTask();
+
+    // the full surface is drawn until the levels of the edited surface are ready
+    if (m_lodTask.valid())
+    {
+        m_lodLevel = 0;
+        return;
+    }
+
+    // the view matrix does not scale, so the largest axis scale is the one of the instance
+    float scale = std::max({ glm::length(glm::vec3(modelViewMatrix[0])), glm::length(glm::vec3(modelViewMatrix[1])), glm::length(glm::vec3(modelViewMatrix[2])) });
+    float pixelsPerUnit = 0.5f * viewportHeight * projectionMatrix[1][1] * scale;
+
+    // perspective projection, the error is measured at the nearest point of the bounding sphere
+    if (projectionMatrix[3][3] == 0.0f)
+    {
+        glm::vec3 center = glm::vec3(modelViewMatrix * glm::vec4(m_boundsCenter, 1.0f));
+        pixelsPerUnit /= std::max(-center.z - m_boundsRadius * scale, lodMinDistance);
+    }
+
+    int lodLevel = 0;
+
+    for (int i = m_lods.size(); i > 0; --i)
+    {
+        float maxPixelError = i <= m_lodLevel ? lodMaxPixelError * lodHysteresis : lodMaxPixelError;
+
+        if (m_lods[i - 1].maxError * pixelsPerUnit <= maxPixelError)
+        {
+            lodLevel = i;
+            break;
+        }
+    }
+
+    m_lodLevel = lodLevel;
+}
+
+glm::vec3 ReplicatedCutObject::getBoundsCenter() const
+{
+    return m_boundsCenter;
+}
+
+float ReplicatedCutObject::getBoundsRadius() const
+{
+    return m_boundsRadius;
+}
+
+void ReplicatedCutObject::setThreadPool(ThreadPool* threadPool)
+{
+    m_threadPool = threadPool;
+    m_sweepGenerator.setThreadPool(m_isParallelMode ? m_threadPool : nullptr);
+}
+
+void ReplicatedCutObject::setParallelMode(bool isParallelMode)
+{
+    m_isParallelMode = isParallelMode;
+    m_sweepGenerator.setThreadPool(m_isParallelMode ? m_threadPool : nullptr);
+}
+
+bool ReplicatedCutObject::getParallelMode() const
+{
+    return m_isParallelMode;
+}
+
+void ReplicatedCutObject::setTrajectoryCurve(TrajectoryCurves trajectoryCurve)
+{
+    if (m_trajectoryCurve == trajectoryCurve)
+        return;
+
+    m_trajectoryCurve = trajectoryCurve;
+
+    updateTrajectoryCurve();
+}
+
+TrajectoryCurves ReplicatedCutObject::getTrajectoryCurve() const
+{
+    return m_trajectoryCurve;
+}
+
+int ReplicatedCutObject::getTrajectorySize() const
+{
+    return m_controlPoints.size();
+}
+
+glm::vec3 ReplicatedCutObject::getTrajectoryPoint(int i) const
+{
+    return m_controlPoints[i];
+}
+
+float ReplicatedCutObject::getCutParameter(int i) const
+{
+    return m_controlCutParameters[i];
+}
+
+void ReplicatedCutObject::updateTrajectoryPoint(int i, const glm::vec3& point)
+{
+    if (i < 0 || i >= static_cast<int>(m_controlPoints.size()))
+    {
+        std::cerr << "Trajectory point index is out of range!" << std::endl;
+        return;
+    }
+
+    m_controlPoints[i] = point;
+
+    if (m_trajectoryCurve != Polyline_curve)
+    {
+        updateTrajectoryCurve();
+        return;
+    }
+
+    glm::vec3 oldPoint = m_trajectory[i];
+    m_trajectory[i] = point;
+    updatePointBounds(i, oldPoint);
+
+    updateBufferRange(m_trajectoryBufferObject, SweepRange{ i, i + 1 }, sizeof(glm::vec3), m_trajectory.data());
+    updateSweep(SweepRange{ i, i + 1 }, true);
+}
+
+void ReplicatedCutObject::updateCutParameter(int i, float cutParameter)
+{
+    if (i < 0 || i >= static_cast<int>(m_controlCutParameters.size()))
+    {
+        std::cerr << "Cut parameter index is out of range!" << std::endl;
+        return;
+    }
+
+    m_controlCutParameters[i] = cutParameter;
+
+    if (m_trajectoryCurve != Polyline_curve)
+    {
+        updateTrajectoryCurve();
+        return;
+    }
+
+    float oldCutParameter = m_cutParameters[i];
+    m_cutParameters[i] = cutParameter;
+    updateCutParameterBounds(i, oldCutParameter);
+
+    updateSweep(SweepRange{ i, i + 1 }, false);
+}
+
+void ReplicatedCutObject::sampleTrajectory()
+{
+    // a spline needs a cut parameter for every control point, otherwise the input stays invalid as a polyline
+    if (m_trajectoryCurve == Polyline_curve || m_controlPoints.size() != m_controlCutParameters.size())
+    {
+        m_trajectory = m_controlPoints;
+        m_cutParameters = m_controlCutParameters;
+        calcBounds();
+        return;
+    }
+
+    TrajectorySplineInput input;
+    input.controlPoints = m_controlPoints.data();
+    input.cutParameters = m_controlCutParameters.data();
+    input.weights = m_controlWeights.size() == m_controlPoints.size() ? m_controlWeights.data() : nullptr;
+    input.size = m_controlPoints.size();
+    input.curve = m_trajectoryCurve;
+
+    glm::vec3 min = m_controlPoints[0];
+    glm::vec3 max = m_controlPoints[0];
+
+    for (const glm::vec3& point : m_controlPoints)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    float diagonal = glm::length(max - min);
+    float maxChordError = (diagonal > 0.0f ? diagonal : 1.0f) * trajectoryMaxChordError;
+
+    TrajectorySpline spline;
+    spline.setControlPoints(input);
+    spline.sample(maxChordError, trajectoryMaxAngle, SweepLod::calcProfileRadius(m_cut.data(), m_cut.size()), m_trajectory, m_cutParameters);
+
+    calcBounds();
+}
+
+void ReplicatedCutObject::updateTrajectoryCurve()
+{
+    sampleTrajectory();
+
+    // the samples count changes, so everything is generated again
+    prepareToRenderTrajectory();
+    prepareToRenderTrajectoryCuts();
+    prepareToRenderReplicatedCut();
+}
+
+void ReplicatedCutObject::updateSweep(const SweepRange& changedRange, bool isTrajectoryChanged)
+{
+    SweepInput input = getSweepInput();
+
+    if (!SweepGenerator::isValidInput(input) || !m_isSweepPrepared)
+        return;
+
+    // streamed rings are not kept on the host, so the whole sweep is streamed again
+    if (m_isStreamingMode)
+    {
+        prepareToRenderTrajectoryCuts();
+        prepareToRenderReplicatedCut();
+        return;
+    }
+
+    SweepRange changedRings = changedRange;
+
+    if (!m_sweepGenerator.updateTrajectoryCuts(input, m_translatedCut.data(), changedRings, isTrajectoryChanged))
+    {
+        prepareToRenderTrajectoryCuts();
+        prepareToRenderReplicatedCut();
+        return;
+    }
+
+    int pointsInCutNum = input.cutSize + 2;
+    SweepRange changedPoints{ changedRings.begin * pointsInCutNum, changedRings.end * pointsInCutNum };
+
+    updateBufferRange(m_trajectoryCutsBufferObject, changedPoints, sizeof(glm::vec3), m_translatedCut.data());
+
+    m_isLodOutdated = true;
+
+    if (m_replicatedCutVerticesSize == 0 || changedRings.begin >= changedRings.end)
+        return;
+
+    if (m_isProceduralMode)
+    {
+        updateProceduralReplicatedCut(input, changedRings);
+        return;
+    }
+
+    if (m_isIndexedMode)
+        updateIndexedReplicatedCut(input, changedRings);
+    else
+        updateReplicatedCut(input, changedRings);
+}
+
+void ReplicatedCutObject::updateReplicatedCut(const SweepInput& input, const SweepRange& changedRings)
+{
+    SweepRange changedVertices[2];
+
+    m_sweepGenerator.updateReplicatedCut(input, m_translatedCut.data(), getOutput(), changedRings, changedVertices[0], changedVertices[1]);
+
+    if (m_isPackedMode)
+    {
+        updatePackedReplicatedCut({ changedVertices[0], changedVertices[1] });
+        return;
+    }
+
+    for (const SweepRange& range : changedVertices)
+    {
+        if (m_isInterleavedMode)
+            updateBufferRange(m_replicatedCutInterleavedBufferObject, range, sizeof(InterleavedSmoothedVertex), m_replicatedCutSmoothedVertices.data());
+        else
+        {
+            updateBufferRange(m_replicatedCutBufferObject, range, sizeof(glm::vec3), m_replicatedCut.data());
+            updateBufferRange(m_replicatedCutNormalsBufferObject, range, sizeof(glm::vec3), m_replicatedCutNormals.data());
+            updateBufferRange(m_replicatedCutSmoothedNormalsBufferObject, range, sizeof(glm::vec3), m_replicatedCutSmoothedNormals.data());
+        }
+    }
+}
+
+void ReplicatedCutObject::updateIndexedReplicatedCut(const SweepInput& input, const SweepRange& changedRings)
+{
+    SweepRange changedVertices[2];
+
+    // the smooth indices only depend on the sizes, the flat ones follow the welding
+    if (m_isSmoothMesh)
+        m_sweepGenerator.updateIndexedSmoothReplicatedCut(input, m_translatedCut.data(), getIndexedOutput(0), changedRings, changedVertices[0], changedVertices[1]);
+    else
+    {
+        SweepIndexedOutput output = getIndexedOutput(0);
+        output.indices = m_replicatedCutIndices.data();
+
+        SweepRange changedIndices;
+        m_sweepGenerator.updateIndexedFlatReplicatedCut(input, m_translatedCut.data(), output, changedRings, 0, changedVertices[0], changedVertices[1], changedIndices);
+
+        updateIndicesRange(changedIndices);
+    }
+
+    if (m_isPackedMode)
+    {
+        updatePackedReplicatedCut({ changedVertices[0], changedVertices[1] });
+        return;
+    }
+
+    for (const SweepRange& range : changedVertices)
+    {
+        if (m_isInterleavedMode)
+            updateBufferRange(m_replicatedCutInterleavedBufferObject, range, sizeof(InterleavedVertex), m_replicatedCutVertices.data());
+        else
+        {
+            updateBufferRange(m_replicatedCutBufferObject, range, sizeof(glm::vec3), m_replicatedCut.data());
+            updateBufferRange(m_replicatedCutNormalsBufferObject, range, sizeof(glm::vec3), m_replicatedCutNormals.data());
+        }
+    }
+}
+
+void ReplicatedCutObject::setBufferStorage(GLuint& buffer, GLsizeiptr size, const void* data)
+{
+    // immutable storage can not be resized, so a new buffer replaces the old one
+    GLState::deleteBuffers(1, &buffer);
+    glCreateBuffers(1, &buffer);
+
+    if (size > 0)
+        glNamedBufferStorage(buffer, size, data, GL_DYNAMIC_STORAGE_BIT);
+}
+
+void ReplicatedCutObject::updateBufferRange(GLuint buffer, const SweepRange& range, GLsizeiptr elementSize, const void* data)
+{
+    if (range.begin >= range.end)
+        return;
+
+    glNamedBufferSubData(buffer, range.begin * elementSize, (range.end - range.begin) * elementSize, static_cast<const char*>(data) + range.begin * elementSize);
+}
+
+void ReplicatedCutObject::uploadBufferChunk(GLuint buffer, GLintptr firstElement, GLsizeiptr elementsSize, GLsizeiptr elementSize, const void* data)
+{
+    glNamedBufferSubData(buffer, firstElement * elementSize, elementsSize * elementSize, data);
+}
+
+bool ReplicatedCutObject::isInterleavedStorage() const
+{
+    // packed vertices are made from the interleaved ones, which stay on the CPU for the incremental updates
+    return m_isInterleavedMode || m_isPackedMode;
+}
+
+std::vector<SweepRange> ReplicatedCutObject::getPackedSections() const
+{
+    int cutSize = m_cut.size();
+    int capSize = SweepGenerator::getCapSize(cutSize);
+
+    if (m_isIndexedMode)
+        capSize = m_isSmoothMesh ? SweepGenerator::getIndexedSmoothCapSize(cutSize) : SweepGenerator::getIndexedFlatCapSize(cutSize);
+
+    // the surface of the rings, the start cap and the end cap
+    int capsBegin = m_replicatedCutVerticesSize - capSize * 2;
+
+    return { SweepRange{ 0, capsBegin }, SweepRange{ capsBegin, capsBegin + capSize }, SweepRange{ capsBegin + capSize, m_replicatedCutVerticesSize } };
+}
+
+void ReplicatedCutObject::packReplicatedCut()
+{
+    SweepRange vertices{ 0, m_replicatedCutVerticesSize };
+
+    m_positionQuantization.setSections(getPackedSections());
+    int packedVerticesSize = m_positionQuantization.getPackedVerticesSize();
+
+    if (m_isIndexedMode)
+    {
+        SweepIndexedOutput source = getIndexedOutput(0);
+        m_replicatedCutPackedVertices.assign(packedVerticesSize, PackedVertex());
+
+        m_positionQuantization.build(source.positions, SweepAttribute<PackedPosition>(&m_replicatedCutPackedVertices.data()->position, sizeof(PackedVertex)));
+        VertexPacking::pack(source, m_positionQuantization, vertices, m_replicatedCutPackedVertices.data());
+    }
+    else
+    {
+        SweepOutput source = getOutput();
+        m_replicatedCutPackedSmoothedVertices.assign(packedVerticesSize, PackedSmoothedVertex());
+
+        m_positionQuantization.build(source.positions, SweepAttribute<PackedPosition>(&m_replicatedCutPackedSmoothedVertices.data()->position, sizeof(PackedSmoothedVertex)));
+        VertexPacking::pack(source, m_positionQuantization, vertices, m_replicatedCutPackedSmoothedVertices.data());
+    }
+}
+
+void ReplicatedCutObject::updatePackedReplicatedCut(const std::vector<SweepRange>& changedVertices)
+{
+    bool isUpdated = false;
+
+    // all copies of a moved position are among the changed vertices, so they are packed again at once
+    if (m_isIndexedMode)
+    {
+        SweepIndexedOutput source = getIndexedOutput(0);
+        SweepAttribute<PackedPosition> packedPositions(&m_replicatedCutPackedVertices.data()->position, sizeof(PackedVertex));
+
+        isUpdated = m_positionQuantization.update(source.positions, changedVertices, packedPositions);
+
+        for (const SweepRange& range : changedVertices)
+            VertexPacking::pack(source, m_positionQuantization, range, m_replicatedCutPackedVertices.data());
+    }
+    else
+    {
+        SweepOutput source = getOutput();
+        SweepAttribute<PackedPosition> packedPositions(&m_replicatedCutPackedSmoothedVertices.data()->position, sizeof(PackedSmoothedVertex));
+
+        isUpdated = m_positionQuantization.update(source.positions, changedVertices, packedPositions);
+
+        for (const SweepRange& range : changedVertices)
+            VertexPacking::pack(source, m_positionQuantization, range, m_replicatedCutPackedSmoothedVertices.data());
+    }
+
+    GLsizeiptr vertexSize = m_isIndexedMode ? sizeof(PackedVertex) : sizeof(PackedSmoothedVertex);
+    const void* packedVertices = m_isIndexedMode ? static_cast<const void*>(m_replicatedCutPackedVertices.data()) : m_replicatedCutPackedSmoothedVertices.data();
+
+    // a position left the grid of its chunk, the grids are fitted again
+    if (!isUpdated)
+    {
+        packReplicatedCut();
+
+        updateBufferRange(m_replicatedCutInterleavedBufferObject, SweepRange{ 0, m_positionQuantization.getPackedVerticesSize() }, vertexSize, packedVertices);
+
+        const std::vector<PackedChunkBounds>& bounds = m_positionQuantization.getBounds();
+        updateBufferRange(m_replicatedCutPackedBoundsBufferObject, SweepRange{ 0, static_cast<int>(bounds.size()) }, sizeof(PackedChunkBounds), bounds.data());
+        return;
+    }
+
+    // a range may reach over the padding of a section, which is uploaded with it
+    for (const SweepRange& range : changedVertices)
+    {
+        if (range.begin < range.end)
+            updateBufferRange(m_replicatedCutInterleavedBufferObject, SweepRange{ m_positionQuantization.getPackedVertex(range.begin), m_positionQuantization.getPackedVertex(range.end - 1) + 1 }, vertexSize, packedVertices);
+    }
+}
+
+std::vector<GLuint> ReplicatedCutObject::getUploadedIndices(const SweepRange& range) const
+{
+    std::vector<GLuint> indices(m_replicatedCutIndices.begin() + range.begin, m_replicatedCutIndices.begin() + range.end);
+
+    // packed vertices of the caps start their own chunks
+    if (m_isPackedMode)
+    {
+        for (GLuint& index : indices)
+            index = m_positionQuantization.getPackedVertex(index);
+    }
+
+    return indices;
+}
+
+void ReplicatedCutObject::updateIndicesRange(const SweepRange& range)
+{
+    if (range.begin >= range.end)
+        return;
+
+    if (!m_isPackedMode)
+    {
+        updateBufferRange(m_replicatedCutElementBufferObject, range, sizeof(GLuint), m_replicatedCutIndices.data());
+        return;
+    }
+
+    std::vector<GLuint> indices = getUploadedIndices(range);
+    uploadBufferChunk(m_replicatedCutElementBufferObject, range.begin, indices.size(), sizeof(GLuint), indices.data());
+}
+
+void ReplicatedCutObject::prepareToRenderTrajectory()
+{
+    setBufferStorage(m_trajectoryBufferObject, m_trajectory.size() * sizeof(glm::vec3), m_trajectory.data());
+    setupTrajectoryVertexArray(m_trajectoryVao, m_trajectoryBufferObject, 0);
+}
+
+void ReplicatedCutObject::renderTrajectory(const glm::vec3& color, const InstanceRange& instances)
+{
+    // every render function sets the state it depends on instead of restoring it afterwards
+    GLState::setCapability(GL_LINE_SMOOTH, true);
+
+    m_defaultShaderProgram->use();
+    m_defaultShaderProgram->setVec3(m_defaultUniforms.color, color);
+    m_defaultShaderProgram->setBool(m_defaultUniforms.isInstanced, true);
+    m_defaultShaderProgram->setInt(m_defaultUniforms.packedChunkSize, 0);
+
+    GLState::bindVertexArray(m_trajectoryVao);
+
+    glDrawArraysInstancedBaseInstance(GL_LINE_STRIP, 0, m_trajectory.size(), instances.count, instances.first);
+}
+
+void ReplicatedCutObject::prepareToRenderTrajectoryCuts()
+{
+    SweepInput input = getSweepInput();
+
+    if (!SweepGenerator::isValidInput(input))
+        return;
+
+    if (m_isStreamingMode)
+        streamTrajectoryCuts(input);
+    else
+    {
+        m_translatedCut.resize(SweepGenerator::getTrajectoryCutsSize(input.cutSize, input.trajectorySize));
+        m_sweepGenerator.generateTrajectoryCuts(input, m_translatedCut.data());
+
+        setBufferStorage(m_trajectoryCutsBufferObject, m_translatedCut.size() * sizeof(glm::vec3), m_translatedCut.data());
+    }
+
+    uploadTrajectoryCutsIndices(input.cutSize, input.trajectorySize);
+    setupTrajectoryVertexArray(m_trajectoryCutsVao, m_trajectoryCutsBufferObject, m_trajectoryCutsElementBufferObject);
+
+    m_isSweepPrepared = true;
+    m_isLodOutdated = true;
+}
+
+void ReplicatedCutObject::uploadTrajectoryCutsIndices(int cutSize, int trajectorySize)
+{
+    // every cut is a triangle fan ended by the primitive restart index, so all of them are drawn at once
+    int pointsInCutNum = cutSize + 2;
+    int indicesInCutNum = pointsInCutNum + 1;
+
+    m_trajectoryCutsIndicesSize = indicesInCutNum * trajectorySize;
+    setBufferStorage(m_trajectoryCutsElementBufferObject, static_cast<GLsizeiptr>(m_trajectoryCutsIndicesSize) * sizeof(GLuint), nullptr);
+
+    // the indices are uploaded in chunks, so the streamed mode does not keep them on the host either
+    int chunkSize = getStreamingChunkSize(cutSize);
+
+    std::vector<GLuint> indices;
+    indices.reserve(std::min(chunkSize, trajectorySize) * indicesInCutNum);
+
+    for (int firstCut = 0; firstCut < trajectorySize; firstCut += chunkSize)
+    {
+        int lastCut = std::min(firstCut + chunkSize, trajectorySize);
+
+        indices.clear();
+
+        for (int i = firstCut; i < lastCut; ++i)
+        {
+            for (int j = 0; j < pointsInCutNum; ++j)
+                indices.push_back(i * pointsInCutNum + j);
+
+            indices.push_back(primitiveRestartIndex);
+        }
+
+        uploadBufferChunk(m_trajectoryCutsElementBufferObject, static_cast<GLintptr>(firstCut) * indicesInCutNum, indices.size(), sizeof(GLuint), indices.data());
+    }
+}
+
+void ReplicatedCutObject::renderTrajectoryCuts(const glm::vec3& color, bool isFrameMode, const InstanceRange& instances)
+{
+    m_defaultShaderProgram->use();
+    m_defaultShaderProgram->setVec3(m_defaultUniforms.color, color);
+    m_defaultShaderProgram->setBool(m_defaultUniforms.isInstanced, true);
+    m_defaultShaderProgram->setInt(m_defaultUniforms.packedChunkSize, 0);
 
-    m_material = resourceManager->getNaturalMaterial(material);
-    m_texture = resourceManager->getTexture(texture);
+    GLState::bindVertexArray(m_trajectoryCutsVao);
 
-    std::ifstream f;
-    f.open(fullFilePath.data(), std::ios::in);
+    GLState::setCapability(GL_LINE_SMOOTH, false);
+    GLState::setPolygonMode(isFrameMode ? GL_LINE : GL_FILL);
 
-    if (!f.is_open())
-        std::cerr << "Failed to open cut object file!" << std::endl;
-    else
+    // the other indexed draws never reach the restart index, so it stays enabled
+    GLState::setCapability(GL_PRIMITIVE_RESTART_FIXED_INDEX, true);
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLE_FAN, m_trajectoryCutsIndicesSize, GL_UNSIGNED_INT, nullptr, instances.count, instances.first);
+}
+
+void ReplicatedCutObject::prepareToRenderReplicatedCut()
+{
+    SweepInput input = getSweepInput();
+
+    if (!SweepGenerator::isValidInput(input) || !m_isSweepPrepared)
+        return;
+
+    // the procedural surface only needs the frames, which the streamed rings calculate for the whole trajectory
+    if (m_isStreamingMode && !m_isProceduralMode)
     {
-        generateBuffers();
+        clearReplicatedCut();
+
+        streamReplicatedCut(input);
+        return;
+    }
 
-        int cutPointAmount = 0;
-        f >> cutPointAmount;
+    buildReplicatedCut(input);
+    uploadReplicatedCut();
+}
 
-        m_cut.resize(cutPointAmount);
+void ReplicatedCutObject::buildReplicatedCut(const SweepInput& input)
+{
+    clearReplicatedCut();
 
-        float x = 0, y = 0, z = 0;
+    if (m_isProceduralMode)
+        return;
 
-        for (int i = 0; i < cutPointAmount; ++i)
-        {
-            f >> x >> y;
-            m_cut[i] = glm::vec2(x, y);
-        }
+    if (m_isIndexedMode)
+        generateIndexedReplicatedCut(input);
+    else
+        generateReplicatedCut(input);
 
-        int trajectoryPointAmount = 0;
-        f >> trajectoryPointAmount;
+    if (m_isPackedMode)
+        packReplicatedCut();
+}
 
-        m_trajectory.resize(trajectoryPointAmount);
+void ReplicatedCutObject::generateReplicatedCut(const SweepInput& input)
+{
+    m_replicatedCutVerticesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
 
-        for (int i = 0; i < trajectoryPointAmount; ++i)
-        {
-            f >> x >> y >> z;
-            m_trajectory[i] = glm::vec3(x, y, z);
-        }
+    if (isInterleavedStorage())
+        m_replicatedCutSmoothedVertices.resize(m_replicatedCutVerticesSize);
+    else
+    {
+        m_replicatedCut.resize(m_replicatedCutVerticesSize);
+        m_replicatedCutNormals.resize(m_replicatedCutVerticesSize);
+        m_replicatedCutSmoothedNormals.resize(m_replicatedCutVerticesSize);
+        m_replicatedCutTextureCoords.resize(m_replicatedCutVerticesSize);
+    }
 
-        int cutParametersAmount = 0;
-        f >> cutParametersAmount;
+    m_sweepGenerator.generateReplicatedCut(input, m_translatedCut.data(), getOutput());
+}
 
-        m_cutParameters.resize(cutParametersAmount);
+SweepOutput ReplicatedCutObject::getOutput()
+{
+    SweepOutput output;
 
-        for (int i = 0; i < cutParametersAmount; ++i)
-            f >> m_cutParameters[i];
+    if (isInterleavedStorage())
+    {
+        InterleavedSmoothedVertex* vertices = m_replicatedCutSmoothedVertices.data();
+        int stride = sizeof(InterleavedSmoothedVertex);
 
-        f.close();
+        output.positions = SweepAttribute<glm::vec3>(&vertices->position, stride);
+        output.normals = SweepAttribute<glm::vec3>(&vertices->normal, stride);
+        output.smoothedNormals = SweepAttribute<glm::vec3>(&vertices->smoothedNormal, stride);
+        output.textureCoords = SweepAttribute<glm::vec2>(&vertices->textureCoord, stride);
+    }
+    else
+    {
+        output.positions = m_replicatedCut.data();
+        output.normals = m_replicatedCutNormals.data();
+        output.smoothedNormals = m_replicatedCutSmoothedNormals.data();
+        output.textureCoords = m_replicatedCutTextureCoords.data();
     }
+
+    return output;
 }
 
-ReplicatedCutObject::~ReplicatedCutObject()
+void ReplicatedCutObject::generateIndexedReplicatedCut(const SweepInput& input)
 {
-    glDeleteVertexArrays(1, &m_vao);
-    glDeleteBuffers(1, &m_trajectoryBufferObject);
-    glDeleteBuffers(1, &m_trajectoryCutsBufferObject);
-    glDeleteBuffers(1, &m_replicatedCutBufferObject);
-    glDeleteBuffers(1, &m_replicatedCutNormalsBufferObject);
-    glDeleteBuffers(1, &m_replicatedCutSmoothedNormalsBufferObject);
-    glDeleteBuffers(1, &m_replicatedCutTextureBufferObject);
+    m_replicatedCutIndicesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
+    m_replicatedCutIndices.resize(m_replicatedCutIndicesSize);
+
+    if (m_isSmoothMesh)
+        resizeIndexedReplicatedCut(SweepGenerator::getIndexedSmoothVerticesSize(input.cutSize, input.trajectorySize));
+    else
+        resizeIndexedReplicatedCut(SweepGenerator::getIndexedFlatVerticesSize(input.cutSize, input.trajectorySize));
+
+    SweepIndexedOutput output = getIndexedOutput(0);
+    output.indices = m_replicatedCutIndices.data();
+
+    if (m_isSmoothMesh)
+        m_sweepGenerator.generateIndexedSmoothReplicatedCut(input, m_translatedCut.data(), output);
+    else
+        m_sweepGenerator.generateIndexedFlatReplicatedCut(input, m_translatedCut.data(), output);
 }
 
-void ReplicatedCutObject::setMaterial(std::string material)
+void ReplicatedCutObject::resizeIndexedReplicatedCut(int verticesSize)
 {
-    m_material = m_resourceManager->getNaturalMaterial(material);
-    m_isMaterialMode = true;
+    m_replicatedCutVerticesSize = verticesSize;
+
+    if (isInterleavedStorage())
+        m_replicatedCutVertices.resize(verticesSize);
+    else
+    {
+        m_replicatedCut.resize(verticesSize);
+        m_replicatedCutNormals.resize(verticesSize);
+        m_replicatedCutTextureCoords.resize(verticesSize);
+    }
 }
 
-void ReplicatedCutObject::setTexture(std::string texture)
+SweepIndexedOutput ReplicatedCutObject::getIndexedOutput(int firstVertex)
 {
-    m_texture = m_resourceManager->getTexture(texture);
-    m_isMaterialMode = false;
+    SweepIndexedOutput output;
+
+    if (isInterleavedStorage())
+    {
+        InterleavedVertex* vertices = m_replicatedCutVertices.data() + firstVertex;
+        int stride = sizeof(InterleavedVertex);
+
+        output.positions = SweepAttribute<glm::vec3>(&vertices->position, stride);
+        output.normals = SweepAttribute<glm::vec3>(&vertices->normal, stride);
+        output.textureCoords = SweepAttribute<glm::vec2>(&vertices->textureCoord, stride);
+    }
+    else
+    {
+        output.positions = m_replicatedCut.data() + firstVertex;
+        output.normals = m_replicatedCutNormals.data() + firstVertex;
+        output.textureCoords = m_replicatedCutTextureCoords.data() + firstVertex;
+    }
+
+    return output;
 }
 
-void ReplicatedCutObject::setScale(float scale)
+void ReplicatedCutObject::clearReplicatedCut()
 {
-    m_scaleMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale, scale, scale));
+    m_replicatedCut.clear();
+    m_replicatedCutNormals.clear();
+    m_replicatedCutSmoothedNormals.clear();
+    m_replicatedCutTextureCoords.clear();
+    m_replicatedCutVertices.clear();
+    m_replicatedCutSmoothedVertices.clear();
+    m_replicatedCutPackedVertices.clear();
+    m_replicatedCutPackedSmoothedVertices.clear();
+    m_replicatedCutIndices.clear();
+
+    m_replicatedCut.shrink_to_fit();
+    m_replicatedCutNormals.shrink_to_fit();
+    m_replicatedCutSmoothedNormals.shrink_to_fit();
+    m_replicatedCutTextureCoords.shrink_to_fit();
+    m_replicatedCutVertices.shrink_to_fit();
+    m_replicatedCutSmoothedVertices.shrink_to_fit();
+    m_replicatedCutPackedVertices.shrink_to_fit();
+    m_replicatedCutPackedSmoothedVertices.shrink_to_fit();
+    m_replicatedCutIndices.shrink_to_fit();
+
+    m_replicatedCutVerticesSize = 0;
+    m_replicatedCutIndicesSize = 0;
 }
 
-void ReplicatedCutObject::prepareToRenderTrajectory()
+int ReplicatedCutObject::getStreamingChunkSize(int cutSize) const
 {
-    glBindBuffer(GL_ARRAY_BUFFER, m_trajectoryBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_trajectory.size() * sizeof(float) * 3, m_trajectory.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // trajectory points in a chunk, so that a chunk of the surface holds about streamingChunkVerticesSize vertices
+    return std::max(streamingChunkVerticesSize / (cutSize * 6), 1);
 }
 
-void ReplicatedCutObject::renderTrajectory(const glm::vec3& color)
+void ReplicatedCutObject::streamTrajectoryCuts(const SweepInput& input)
 {
-    glEnable(GL_LINE_SMOOTH);
+    int pointsInCutNum = input.cutSize + 2;
+    int chunkSize = getStreamingChunkSize(input.cutSize);
 
-    m_defaultShaderProgram->use();
-    m_defaultShaderProgram->setVec3("color", color);
-    m_defaultShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+    m_translatedCut.clear();
+    m_translatedCut.shrink_to_fit();
+
+    m_sweepGenerator.prepareChunks(input);
 
-    glBindVertexArray(m_vao);
+    GLsizeiptr translatedCutSize = SweepGenerator::getTrajectoryCutsSize(input.cutSize, input.trajectorySize);
+    setBufferStorage(m_trajectoryCutsBufferObject, translatedCutSize * sizeof(glm::vec3), nullptr);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_trajectoryBufferObject);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(0);
+    std::vector<glm::vec3> translatedCut(std::min(chunkSize, input.trajectorySize) * pointsInCutNum);
 
-    glDrawArrays(GL_LINE_STRIP, 0, m_trajectory.size());
+    for (int begin = 0; begin < input.trajectorySize; begin += chunkSize)
+    {
+        SweepRange rings{ begin, std::min(begin + chunkSize, input.trajectorySize) };
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glUseProgram(0);
+        m_sweepGenerator.generateTrajectoryCutsChunk(input, rings, translatedCut.data());
 
-    glDisable(GL_LINE_SMOOTH);
+        uploadBufferChunk(m_trajectoryCutsBufferObject, static_cast<GLintptr>(rings.begin) * pointsInCutNum,
+            static_cast<GLsizeiptr>(rings.end - rings.begin) * pointsInCutNum, sizeof(glm::vec3), translatedCut.data());
+    }
 }
 
-void ReplicatedCutObject::prepareToRenderTrajectoryCuts()
+void ReplicatedCutObject::streamReplicatedCut(const SweepInput& input)
 {
-    calcVectorsOrientationInTrajectory();
+    int quadVerticesSize = input.cutSize * 6;
+    int quadsSize = input.trajectorySize - 1;
+    int chunkSize = getStreamingChunkSize(input.cutSize);
 
-    int cutSize = m_cut.size();
-    int trajectorySize = m_trajectory.size();
+    m_replicatedCutVerticesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
+
+    setBufferStorage(m_replicatedCutInterleavedBufferObject, static_cast<GLsizeiptr>(m_replicatedCutVerticesSize) * sizeof(InterleavedSmoothedVertex), nullptr);
+
+    // the last chunk is followed by the caps, which take as many vertices as one quad of the trajectory
+    std::vector<InterleavedSmoothedVertex> vertices((std::min(chunkSize, quadsSize) + 1) * quadVerticesSize);
 
-    m_originTranslatedCut.resize(cutSize);
+    InterleavedSmoothedVertex* chunkVertices = vertices.data();
+    int stride = sizeof(InterleavedSmoothedVertex);
 
-    glm::vec3 cutCenter{};
-    for (int i = 0; i < cutSize; ++i)
-        cutCenter += glm::vec3(m_cut[i], 0.0f);
-    cutCenter /= cutSize;
+    SweepOutput output;
+    output.positions = SweepAttribute<glm::vec3>(&chunkVertices->position, stride);
+    output.normals = SweepAttribute<glm::vec3>(&chunkVertices->normal, stride);
+    output.smoothedNormals = SweepAttribute<glm::vec3>(&chunkVertices->smoothedNormal, stride);
+    output.textureCoords = SweepAttribute<glm::vec2>(&chunkVertices->textureCoord, stride);
 
-    glm::mat4 tran = glm::translate(glm::mat4(1.0f), -cutCenter);
-    for (int i = 0; i < cutSize; ++i)
+    // the frames are prepared by streamTrajectoryCuts
+    for (int begin = 0; begin < quadsSize; begin += chunkSize)
     {
-        m_originTranslatedCut[i] = glm::vec2(tran * glm::vec4(m_cut[i], 0.0f, 1.0f));
-    }
+        SweepRange quads{ begin, std::min(begin + chunkSize, quadsSize) };
+
+        m_sweepGenerator.generateReplicatedCutChunk(input, quads, output);
 
-    m_translatedCut.resize((cutSize + 2) * trajectorySize);
+        int chunkQuadsSize = quads.end - quads.begin + (quads.end == quadsSize ? 1 : 0);
+
+        uploadBufferChunk(m_replicatedCutInterleavedBufferObject, static_cast<GLintptr>(quads.begin) * quadVerticesSize,
+            static_cast<GLsizeiptr>(chunkQuadsSize) * quadVerticesSize, sizeof(InterleavedSmoothedVertex), vertices.data());
+    }
 
-    glm::vec3 y{};
-    glm::mat3 rotate{};
+    setupInterleavedVertexArrays(m_replicatedCutVaos, m_replicatedCutInterleavedBufferObject, 0, false);
+}
 
-    for (int i = 0, shift = 1; i < trajectorySize && trajectorySize >= 3; ++i, shift += cutSize + 2)
+void ReplicatedCutObject::uploadReplicatedCut()
+{
+    if (m_isProceduralMode)
     {
-        glm::vec3 p1{}, p2{}, p3{};
-        glm::vec3 center{};
-        glm::vec3 translate{};
-        glm::vec3 x{}, z{};
+        uploadProceduralReplicatedCut(getSweepInput());
+        return;
+    }
 
-        if (i == 0)
-        {
-            p1 = m_trajectory[0];
-            p2 = m_trajectory[1];
-            p3 = m_trajectory[2];
-
-            glm::vec3 a = p2 - p1;
-            glm::vec3 b = p3 - p2;
-
-            if (std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6))
-            {
-                z = glm::normalize(a);
-                y = glm::vec3(0.0f, 1.0f, 0.0f);
-                x = glm::normalize(glm::cross(z, y));
-                y = glm::normalize(glm::cross(x, z));
-            }
-            else
-            {
-                z = glm::normalize(a);
-                y = glm::normalize(glm::cross(a, b));
-                x = glm::normalize(glm::cross(z, y));
-
-                glm::vec3 nextX = glm::normalize(-a) + glm::normalize(b);
-                if (m_isChangeVectorOrientation[i + 1]) nextX = -nextX;
-
-                float angle1 = glm::acos(glm::dot(x, nextX));
-                float angle2 = glm::acos(glm::dot(-x, nextX));
-
-                if (angle2 < angle1) x = -x;
-            }
-
-            center = p1;
-            translate = p1;
-        }
-        else if (i == m_trajectory.size() - 1)
-        {
-            p1 = m_trajectory[i - 2];
-            p2 = m_trajectory[i - 1];
-            p3 = m_trajectory[i];
+    if (m_isIndexedMode && m_isPackedMode)
+    {
+        std::vector<GLuint> indices = getUploadedIndices(SweepRange{ 0, static_cast<int>(m_replicatedCutIndices.size()) });
+        setBufferStorage(m_replicatedCutElementBufferObject, indices.size() * sizeof(GLuint), indices.data());
+    }
+    else if (m_isIndexedMode)
+        setBufferStorage(m_replicatedCutElementBufferObject, m_replicatedCutIndices.size() * sizeof(GLuint), m_replicatedCutIndices.data());
 
-            glm::vec3 a = p2 - p1;
-            glm::vec3 b = p3 - p2;
+    if (m_isPackedMode)
+    {
+        if (m_isIndexedMode)
+            setBufferStorage(m_replicatedCutInterleavedBufferObject, m_replicatedCutPackedVertices.size() * sizeof(PackedVertex), m_replicatedCutPackedVertices.data());
+        else
+            setBufferStorage(m_replicatedCutInterleavedBufferObject, m_replicatedCutPackedSmoothedVertices.size() * sizeof(PackedSmoothedVertex), m_replicatedCutPackedSmoothedVertices.data());
 
-            if (!(std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6)))
-            {
-                z = glm::normalize(b);
-                x = glm::normalize(glm::cross(z, y));
+        const std::vector<PackedChunkBounds>& bounds = m_positionQuantization.getBounds();
+        setBufferStorage(m_replicatedCutPackedBoundsBufferObject, bounds.size() * sizeof(PackedChunkBounds), bounds.data());
 
-                glm::vec3 prevX = glm::normalize(-a) + glm::normalize(b);
-                if (m_isChangeVectorOrientation[i - 1]) prevX = -prevX;
+        setupPackedVertexArrays();
+    }
+    else if (m_isInterleavedMode)
+    {
+        if (m_isIndexedMode)
+            setBufferStorage(m_replicatedCutInterleavedBufferObject, m_replicatedCutVertices.size() * sizeof(InterleavedVertex), m_replicatedCutVertices.data());
+        else
+            setBufferStorage(m_replicatedCutInterleavedBufferObject, m_replicatedCutSmoothedVertices.size() * sizeof(InterleavedSmoothedVertex), m_replicatedCutSmoothedVertices.data());
 
-                float angle1 = glm::acos(glm::dot(x, prevX));
-                float angle2 = glm::acos(glm::dot(-x, prevX));
+        setupInterleavedVertexArrays(m_replicatedCutVaos, m_replicatedCutInterleavedBufferObject, m_replicatedCutElementBufferObject, m_isIndexedMode);
+    }
+    else
+    {
+        setBufferStorage(m_replicatedCutBufferObject, m_replicatedCut.size() * sizeof(glm::vec3), m_replicatedCut.data());
+        setBufferStorage(m_replicatedCutNormalsBufferObject, m_replicatedCutNormals.size() * sizeof(glm::vec3), m_replicatedCutNormals.data());
 
-                if (angle2 < angle1) x = -x;
-            }
+        if (!m_isIndexedMode)
+            setBufferStorage(m_replicatedCutSmoothedNormalsBufferObject, m_replicatedCutSmoothedNormals.size() * sizeof(glm::vec3), m_replicatedCutSmoothedNormals.data());
 
-            center = p3;
-            translate = p3 - m_trajectory[0];
-        }
-        else
-        {
-            p1 = m_trajectory[i - 1];
-            p2 = m_trajectory[i];
-            p3 = m_trajectory[i + 1];
+        setBufferStorage(m_replicatedCutTextureBufferObject, m_replicatedCutTextureCoords.size() * sizeof(glm::vec2), m_replicatedCutTextureCoords.data());
 
-            glm::vec3 a = glm::normalize(p1 - p2);
-            glm::vec3 b = glm::normalize(p3 - p2);
+        setupSeparateVertexArrays();
+    }
+}
 
-            if (!(std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6)))
-            {
-                x = glm::normalize(a + b);
-                z = glm::normalize(glm::cross(x, y));
+void ReplicatedCutObject::setupTrajectoryVertexArray(GLuint vao, GLuint vertexBufferObject, GLuint elementBufferObject)
+{
+    glVertexArrayVertexBuffer(vao, 0, vertexBufferObject, 0, sizeof(glm::vec3));
+    glVertexArrayElementBuffer(vao, elementBufferObject);
 
-                if (m_isChangeVectorOrientation[i]) x = -x;
-            }
+    glEnableVertexArrayAttrib(vao, 0);
+    glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(vao, 0, 0);
+}
 
-            center = p2;
-            translate = p2 - m_trajectory[0];
-        }
+void ReplicatedCutObject::setupSeparateVertexArrays()
+{
+    // location 1 reads its own buffer, the second binding point
+    GLuint attributeBuffers[Vertex_configurations_count]{ getNormalsBufferObject(false), getNormalsBufferObject(true), m_replicatedCutTextureBufferObject };
+    GLint attributeSizes[Vertex_configurations_count]{ 3, 3, 2 };
 
-        if (glm::length(x) > 1e-6 && glm::length(y) > 1e-6 && glm::length(z) > 1e-6)
-            rotate = glm::mat3(x, y, z);
+    for (int i = 0; i < Vertex_configurations_count; ++i)
+    {
+        GLuint vao = m_replicatedCutVaos[i];
 
-        float scaleParam = m_cutParameters[i];
-        glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(scaleParam));
+        glVertexArrayVertexBuffer(vao, 0, m_replicatedCutBufferObject, 0, sizeof(glm::vec3));
+        glVertexArrayVertexBuffer(vao, 1, attributeBuffers[i], 0, attributeSizes[i] * sizeof(float));
+        glVertexArrayElementBuffer(vao, m_isIndexedMode ? m_replicatedCutElementBufferObject : 0);
 
-        for (int j = 0; j < cutSize; ++j)
-        {
-            glm::vec2 scaledVertex = glm::vec2(scale * glm::vec4(m_originTranslatedCut[j], 0.0f, 1.0f));
-            m_translatedCut[j + shift] = rotate * glm::vec3(scaledVertex, 0.0f) + translate;
-        }
+        glEnableVertexArrayAttrib(vao, 0);
+        glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(vao, 0, 0);
 
-        m_translatedCut[i * (cutSize + 2)] = center;
-        m_translatedCut[shift + cutSize] = m_translatedCut[shift];
+        glEnableVertexArrayAttrib(vao, 1);
+        glVertexArrayAttribFormat(vao, 1, attributeSizes[i], GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(vao, 1, 1);
     }
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_trajectoryCutsBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_translatedCut.size() * sizeof(float) * 3, m_translatedCut.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void ReplicatedCutObject::renderTrajectoryCuts(const glm::vec3& color, bool isFrameMode)
+void ReplicatedCutObject::setupInterleavedVertexArrays(const GLuint* vaos, GLuint vertexBufferObject, GLuint elementBufferObject, bool isIndexed)
 {
-    m_defaultShaderProgram->use();
-    m_defaultShaderProgram->setVec3("color", color);
-    m_defaultShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+    GLsizei stride = isIndexed ? sizeof(InterleavedVertex) : sizeof(InterleavedSmoothedVertex);
 
-    glBindVertexArray(m_vao);
+    GLuint normalOffset = isIndexed ? offsetof(InterleavedVertex, normal) : offsetof(InterleavedSmoothedVertex, normal);
+    GLuint smoothedNormalOffset = isIndexed ? offsetof(InterleavedVertex, normal) : offsetof(InterleavedSmoothedVertex, smoothedNormal);
+    GLuint textureOffset = isIndexed ? offsetof(InterleavedVertex, textureCoord) : offsetof(InterleavedSmoothedVertex, textureCoord);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_trajectoryCutsBufferObject);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(0);
+    // location 1 is the normal for the light shaders and the texture coordinate for the texture shader
+    GLuint attributeOffsets[Vertex_configurations_count]{ normalOffset, smoothedNormalOffset, textureOffset };
+    GLint attributeSizes[Vertex_configurations_count]{ 3, 3, 2 };
 
-    if (isFrameMode)
+    for (int i = 0; i < Vertex_configurations_count; ++i)
     {
-        glEnable(GL_POLYGON_MODE);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    }
+        GLuint vao = vaos[i];
 
-    int cutSize = m_cut.size();
-    for (int i = 0; i < m_trajectory.size(); ++i)
-        glDrawArrays(GL_TRIANGLE_FAN, i * (cutSize + 2), cutSize + 2);
+        glVertexArrayVertexBuffer(vao, 0, vertexBufferObject, 0, stride);
+        glVertexArrayElementBuffer(vao, isIndexed ? elementBufferObject : 0);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glUseProgram(0);
+        glEnableVertexArrayAttrib(vao, 0);
+        glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(vao, 0, 0);
 
-    if (isFrameMode)
-    {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDisable(GL_POLYGON_MODE);
+        glEnableVertexArrayAttrib(vao, 1);
+        glVertexArrayAttribFormat(vao, 1, attributeSizes[i], GL_FLOAT, GL_FALSE, attributeOffsets[i]);
+        glVertexArrayAttribBinding(vao, 1, 0);
     }
 }
 
-void ReplicatedCutObject::prepareToRenderReplicatedCut()
+void ReplicatedCutObject::setupPackedVertexArrays()
 {
-    int cutSize = m_cut.size();
-    int pointsInCutNum = cutSize + 2;
-    int cutNum = m_trajectory.size();
+    GLsizei stride = m_isIndexedMode ? sizeof(PackedVertex) : sizeof(PackedSmoothedVertex);
 
-    int replicatedCutSize = (cutNum - 1) * cutSize * 2 * 3 + cutSize * 3 * 2;
+    GLuint positionOffset = m_isIndexedMode ? offsetof(PackedVertex, position) : offsetof(PackedSmoothedVertex, position);
+    GLuint normalOffset = m_isIndexedMode ? offsetof(PackedVertex, normal) : offsetof(PackedSmoothedVertex, normal);
+    GLuint smoothedNormalOffset = m_isIndexedMode ? offsetof(PackedVertex, normal) : offsetof(PackedSmoothedVertex, smoothedNormal);
+    GLuint textureOffset = m_isIndexedMode ? offsetof(PackedVertex, textureCoord) : offsetof(PackedSmoothedVertex, textureCoord);
 
-    m_replicatedCut.resize(replicatedCutSize);
-    m_replicatedCutNormals.resize(replicatedCutSize);
-    m_replicatedCutSmoothedNormals.resize(replicatedCutSize);
-    m_replicatedCutTextureCoords.resize(replicatedCutSize);
+    // the positions are steps on the grids of the chunks, the other attributes are normalized, so the shaders get normals
+    // in [-1, 1] and texture coordinates in [0, 1] without decoding
+    GLuint attributeOffsets[Vertex_configurations_count]{ normalOffset, smoothedNormalOffset, textureOffset };
+    GLint attributeSizes[Vertex_configurations_count]{ 4, 4, 2 };
+    GLenum attributeTypes[Vertex_configurations_count]{ GL_INT_2_10_10_10_REV, GL_INT_2_10_10_10_REV, GL_UNSIGNED_SHORT };
 
-    int repCutIndex = 0;
-
-    for (int i = 0; i < cutNum - 1; ++i)
+    for (int i = 0; i < Vertex_configurations_count; ++i)
     {
-        float x1 = ((cutNum - 1 + i) % (cutNum - 1)) / static_cast<float>(cutNum - 1);
-        float x2 = ((cutNum - 1 + i + 1) % (cutNum - 1)) / static_cast<float>(cutNum - 1);
+        GLuint vao = m_replicatedCutVaos[i];
 
-        if (i == cutNum - 2)
-            x2 = 1.0f;
+        glVertexArrayVertexBuffer(vao, 0, m_replicatedCutInterleavedBufferObject, 0, stride);
+        glVertexArrayElementBuffer(vao, m_isIndexedMode ? m_replicatedCutElementBufferObject : 0);
 
-        for (int j = 1; j < pointsInCutNum - 1; ++j)
-        {
-            int currentCutIndex = i * pointsInCutNum + j;
-            int nextCutIndex = (i + 1) * pointsInCutNum + j;
-
-            glm::vec3 point1 = m_translatedCut[currentCutIndex];
-            glm::vec3 point2 = m_translatedCut[currentCutIndex + 1];
-            glm::vec3 point3 = m_translatedCut[nextCutIndex];
-            glm::vec3 point4 = m_translatedCut[nextCutIndex + 1];
-
-            m_replicatedCut[repCutIndex] = point1;
-            m_replicatedCut[repCutIndex + 1] = point2;
-            m_replicatedCut[repCutIndex + 2] = point3;
-            m_replicatedCut[repCutIndex + 3] = point2;
-            m_replicatedCut[repCutIndex + 4] = point3;
-            m_replicatedCut[repCutIndex + 5] = point4;
-
-            float y1 = ((cutSize + j - 1) % cutSize) / static_cast<float>(cutSize);
-            float y2 = ((cutSize + j) % cutSize) / static_cast<float>(cutSize);
-
-            if (j == pointsInCutNum - 2)
-                y2 = 1.0f;
-
-            glm::vec2 texCoord1(x1, y1);
-            glm::vec2 texCoord2(x1, y2);
-            glm::vec2 texCoord3(x2, y1);
-            glm::vec2 texCoord4(x2, y2);
-
-            m_replicatedCutTextureCoords[repCutIndex] = texCoord1;
-            m_replicatedCutTextureCoords[repCutIndex + 1] = texCoord2;
-            m_replicatedCutTextureCoords[repCutIndex + 2] = texCoord3;
-            m_replicatedCutTextureCoords[repCutIndex + 3] = texCoord2;
-            m_replicatedCutTextureCoords[repCutIndex + 4] = texCoord3;
-            m_replicatedCutTextureCoords[repCutIndex + 5] = texCoord4;
-
-            glm::vec3 normal2first = glm::cross(point1 - point2, point3 - point2);
-            glm::vec3 normal2second = glm::cross(point3 - point2, point4 - point2);
-            glm::vec3 normal3first = glm::cross(point1 - point3, point2 - point3);
-            glm::vec3 normal3second = glm::cross(point2 - point3, point4 - point3);
-
-            glm::vec3 normal1 = glm::cross(point2 - point1, point3 - point1);
-            glm::vec3 normal2 = (normal2first + normal2second) / 2.0f;
-            glm::vec3 normal3 = (normal3first + normal3second) / 2.0f;
-            glm::vec3 normal4 = glm::cross(point2 - point4, point3 - point4);
-
-            glm::vec3 trjPoint = m_trajectory[i];
-            glm::vec3 outVec = trjPoint - point1;
-
-            float dot = glm::dot(glm::normalize(outVec), glm::normalize(normal1));
-
-            if (dot < 0)
-            {
-                normal1 = -normal1;
-                normal2 = -normal2;
-                normal3 = -normal3;
-                normal4 = -normal4;
-            }
-
-            m_replicatedCutNormals[repCutIndex] = -normal1;
-            m_replicatedCutNormals[repCutIndex + 1] = normal2;
-            m_replicatedCutNormals[repCutIndex + 2] = -normal3;
-            m_replicatedCutNormals[repCutIndex + 3] = normal2;
-            m_replicatedCutNormals[repCutIndex + 4] = -normal3;
-            m_replicatedCutNormals[repCutIndex + 5] = normal4;
-
-            repCutIndex += 6;
-        }
+        glEnableVertexArrayAttrib(vao, 0);
+        glVertexArrayAttribFormat(vao, 0, 3, GL_UNSIGNED_SHORT, GL_FALSE, positionOffset);
+        glVertexArrayAttribBinding(vao, 0, 0);
+
+        glEnableVertexArrayAttrib(vao, 1);
+        glVertexArrayAttribFormat(vao, 1, attributeSizes[i], attributeTypes[i], GL_TRUE, attributeOffsets[i]);
+        glVertexArrayAttribBinding(vao, 1, 0);
     }
+}
 
-    float maxLength = 0;
-    for (int i = 0; i < cutSize; ++i)
-    {
-        float length = glm::length(m_originTranslatedCut[i]);
+void ReplicatedCutObject::uploadProceduralReplicatedCut(const SweepInput& input)
+{
+    std::vector<SweepFrame> frames(input.trajectorySize);
+    m_sweepGenerator.getProceduralFrames(input, SweepRange{ 0, input.trajectorySize }, frames.data());
 
-        if (length > maxLength)
-            maxLength = length;
-    }
+    std::vector<glm::vec4> profile(input.cutSize);
+    m_sweepGenerator.getProceduralProfile(input, profile.data());
 
-    m_originTranslatedNormalizedCut.resize(cutSize);
-    for (int i = 0; i < cutSize; ++i)
-        m_originTranslatedNormalizedCut[i] = m_originTranslatedCut[i] * 0.5f / maxLength;
+    setBufferStorage(m_sweepFramesBufferObject, frames.size() * sizeof(SweepFrame), frames.data());
+    setBufferStorage(m_sweepProfileBufferObject, profile.size() * sizeof(glm::vec4), profile.data());
 
-    glm::vec3 center0 = m_translatedCut[0];
-    glm::vec3 normal = m_trajectory[0] - m_trajectory[1];
+    // the vertices are only counted, the shader decodes the same layout as the non indexed surface
+    m_replicatedCutVerticesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
+}
 
-    for (int i = 1; i < cutSize + 1; ++i)
-    {
-        m_replicatedCut[repCutIndex] = center0;
-        m_replicatedCut[repCutIndex + 1] = m_translatedCut[i];
-        m_replicatedCut[repCutIndex + 2] = m_translatedCut[i + 1];
+void ReplicatedCutObject::updateProceduralReplicatedCut(const SweepInput& input, const SweepRange& changedRings)
+{
+    // the neighbouring normals are calculated in the shader, so only the changed frames are written
+    std::vector<SweepFrame> frames(changedRings.end - changedRings.begin);
+    m_sweepGenerator.getProceduralFrames(input, changedRings, frames.data());
 
-        glm::vec2 translateVec(0.5, 0.5);
+    uploadBufferChunk(m_sweepFramesBufferObject, changedRings.begin, frames.size(), sizeof(SweepFrame), frames.data());
+}
 
-        m_replicatedCutTextureCoords[repCutIndex] = glm::vec2(0, 0) + translateVec;
-        m_replicatedCutTextureCoords[repCutIndex + 1] = m_originTranslatedNormalizedCut[i - 1] + translateVec;
-        m_replicatedCutTextureCoords[repCutIndex + 2] = m_originTranslatedNormalizedCut[i == cutSize ? 0 : i] + translateVec;
+void ReplicatedCutObject::buildLods()
+{
+    clearLods();
+    m_lods = generateLods(getSweepInput(), m_sweepGenerator.getFrameXAxes(), m_sweepGenerator.getFrameMode(), m_isSmoothMesh, m_boundsRadius, m_sweepGenerator.getThreadPool());
+    m_isLodOutdated = false;
+    uploadLods();
+}
 
-        m_replicatedCutNormals[repCutIndex] = normal;
-        m_replicatedCutNormals[repCutIndex + 1] = normal;
-        m_replicatedCutNormals[repCutIndex + 2] = normal;
+void ReplicatedCutObject::startLodTask()
+{
+    m_isLodOutdated = false;
 
-        repCutIndex += 3;
-    }
+    // the task works on copies, so the surface can be edited while it runs
+    m_lodTask = m_threadPool->submit([this, cut = m_cut, trajectory = m_trajectory, cutParameters = m_cutParameters, frameXAxes = m_sweepGenerator.getFrameXAxes(),
+        frameMode = m_sweepGenerator.getFrameMode(), isSmoothMesh = m_isSmoothMesh, boundsRadius = m_boundsRadius, threadPool = m_sweepGenerator.getThreadPool()]()
+    {
+        SweepInput input;
+        input.cut = cut.data();
+        input.cutSize = cut.size();
+        input.trajectory = trajectory.data();
+        input.trajectorySize = trajectory.size();
+        input.cutParameters = cutParameters.data();
+        input.cutParametersSize = cutParameters.size();
+
+        try
+        {
+            m_generatedLods = generateLods(input, frameXAxes, frameMode, isSmoothMesh, boundsRadius, threadPool);
+        }
+        catch (const std::bad_alloc&)
+        {
+            std::cerr << "Not enough memory to build the levels of detail!" << std::endl;
+            m_generatedLods.clear();
+        }
+    });
+}
 
-    glm::vec3 center1 = m_translatedCut[m_translatedCut.size() - cutSize - 2];
-    normal = m_trajectory[m_trajectory.size() - 1] - m_trajectory[m_trajectory.size() - 2];
+void ReplicatedCutObject::finishLodTask()
+{
+    if (!m_lodTask.valid() || m_lodTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
 
-    int endCutIndex = m_translatedCut.size() - cutSize - 1;
+    m_lodTask.get();
 
-    for (int i = 0; i < cutSize; ++i)
+    // levels of a surface that was edited again are dropped, the next task replaces them
+    if (!m_isLodOutdated)
     {
-        m_replicatedCut[repCutIndex] = center1;
-        m_replicatedCut[repCutIndex + 1] = m_translatedCut[endCutIndex + i];
-        m_replicatedCut[repCutIndex + 2] = m_translatedCut[endCutIndex + i + 1];
+        clearLods();
+        m_lods = std::move(m_generatedLods);
+        uploadLods();
+    }
 
-        glm::vec2 translateVec(0.5, 0.5);
+    m_generatedLods.clear();
+}
+
+std::vector<ReplicatedCutObject::Lod> ReplicatedCutObject::generateLods(const SweepInput& input, const std::vector<glm::vec3>& frameXAxes, FrameModes frameMode, bool isSmoothMesh,
+                                                                     float boundsRadius, ThreadPool* threadPool)
+{
+    std::vector<Lod> lods;
 
-        m_replicatedCutTextureCoords[repCutIndex] = glm::vec2(0, 0) + translateVec;
-        m_replicatedCutTextureCoords[repCutIndex + 1] = m_originTranslatedNormalizedCut[i] + translateVec;
-        m_replicatedCutTextureCoords[repCutIndex + 2] = m_originTranslatedNormalizedCut[i == cutSize - 1 ? 0 : i + 1] + translateVec;
+    if (!SweepGenerator::isValidInput(input))
+        return lods;
 
-        m_replicatedCutNormals[repCutIndex] = normal;
-        m_replicatedCutNormals[repCutIndex + 1] = normal;
-        m_replicatedCutNormals[repCutIndex + 2] = normal;
+    // the levels use their own generator, the frames of the full surface are kept for the incremental updates
+    SweepGenerator sweepGenerator;
+    sweepGenerator.setFrameMode(frameMode);
+    sweepGenerator.setThreadPool(threadPool);
 
-        repCutIndex += 3;
-    }
+    int previousIndicesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
 
-    for (int i = 0; i < cutNum - 1; ++i)
+    for (int i = 0; i < lodLevelsCount - 1; ++i)
     {
-        int cutIndex = i * cutSize * 6;
-        int prevCutIndex = (i - 1) * cutSize * 6;
-        int nextCutIndex = (i + 1) * cutSize * 6;
+        float maxChordError = 2.0f * boundsRadius * lodBaseChordError * (1 << (2 * i));
+        float maxAngle = std::min(lodBaseAngle * (1 << i), glm::radians(90.0f));
 
-        if (i == 0)
-            prevCutIndex = 0;
+        SweepLodInput lodInput = SweepLod::decimate(input, maxChordError, maxAngle);
+        SweepInput decimatedInput = lodInput.getInput();
 
-        for (int j = 0; j < cutSize; ++j)
+        int indicesSize = SweepGenerator::getReplicatedCutSize(decimatedInput.cutSize, decimatedInput.trajectorySize);
+
+        // a level that does not halve the triangles is not worth switching to
+        if (!SweepGenerator::isValidInput(decimatedInput) || indicesSize * 2 > previousIndicesSize)
+            continue;
+
+        // the kept points take the frame axes of the full surface, the twist that edits spread over it is
+        // only in those, so the profile does not turn when the level changes
+        std::vector<glm::vec3> lodXAxes;
+
+        if (static_cast<int>(frameXAxes.size()) == input.trajectorySize)
         {
-            int nextj = j + 1;
-            if (nextj == cutSize)
-                nextj = 0;
-
-            int prevj = j - 1;
-            if (prevj == -1)
-                prevj = cutSize - 1;
-
-            int rectIndex = cutIndex + j * 6;
-            int nextjRectIndex = cutIndex + nextj * 6;
-            int prevjRectIndex = cutIndex + prevj * 6;
-
-            int previrectIndex = prevCutIndex + j * 6;
-            int previnextjRectIndex = prevCutIndex + nextj * 6;
-            int previprevjRectIndex = prevCutIndex + prevj * 6;
-
-            int nextirectIndex = nextCutIndex + j * 6;
-            int nextinextjRectIndex = nextCutIndex + nextj * 6;
-            int nextiprevjRectIndex = nextCutIndex + prevj * 6;
-
-            glm::vec3 normal1_1 = glm::normalize(m_replicatedCutNormals[rectIndex]);
-            glm::vec3 normal1_2 = glm::normalize(m_replicatedCutNormals[prevjRectIndex + 1]);
-            glm::vec3 normal1_3 = glm::normalize(m_replicatedCutNormals[previrectIndex + 2]);
-            glm::vec3 normal1_4 = glm::normalize(m_replicatedCutNormals[previprevjRectIndex + 5]);
-
-            glm::vec3 normal2_1 = glm::normalize(m_replicatedCutNormals[nextjRectIndex]);
-            glm::vec3 normal2_2 = glm::normalize(m_replicatedCutNormals[rectIndex + 1]);
-            glm::vec3 normal2_3 = glm::normalize(m_replicatedCutNormals[previnextjRectIndex + 2]);
-            glm::vec3 normal2_4 = glm::normalize(m_replicatedCutNormals[previrectIndex + 5]);
-
-            glm::vec3 normal3_1 = glm::normalize(m_replicatedCutNormals[nextirectIndex]);
-            glm::vec3 normal3_2 = glm::normalize(m_replicatedCutNormals[nextiprevjRectIndex + 1]);
-            glm::vec3 normal3_3 = glm::normalize(m_replicatedCutNormals[rectIndex + 2]);
-            glm::vec3 normal3_4 = glm::normalize(m_replicatedCutNormals[prevjRectIndex + 5]);
-
-            glm::vec3 normal4_1 = glm::normalize(m_replicatedCutNormals[nextinextjRectIndex]);
-            glm::vec3 normal4_2 = glm::normalize(m_replicatedCutNormals[nextirectIndex + 1]);
-            glm::vec3 normal4_3 = glm::normalize(m_replicatedCutNormals[nextjRectIndex + 2]);
-            glm::vec3 normal4_4 = glm::normalize(m_replicatedCutNormals[rectIndex + 5]);
-
-            glm::vec3 smoothedNormal1 = (normal1_1 + normal1_2 + normal1_3 + normal1_4) / 4.0f;
-            glm::vec3 smoothedNormal2 = (normal2_1 + normal2_2 + normal2_3 + normal2_4) / 4.0f;
-            glm::vec3 smoothedNormal3 = (normal3_1 + normal3_2 + normal3_3 + normal3_4) / 4.0f;
-            glm::vec3 smoothedNormal4 = (normal4_1 + normal4_2 + normal4_3 + normal4_4) / 4.0f;
-
-            if (i == 0)
-            {
-                int startCutIndex = (cutNum - 1) * cutSize * 6;
-                int startTriangleIndex = startCutIndex + 3 * j;
-
-                glm::vec3 normal = glm::normalize(m_replicatedCutNormals[startCutIndex]);
-
-                smoothedNormal1 = (normal1_1 + normal1_2 + normal + normal) / 4.0f;
-                smoothedNormal2 = (normal2_1 + normal2_2 + normal + normal) / 4.0f;
-
-                m_replicatedCutSmoothedNormals[startTriangleIndex] = normal;
-                m_replicatedCutSmoothedNormals[startTriangleIndex + 1] = smoothedNormal1;
-                m_replicatedCutSmoothedNormals[startTriangleIndex + 2] = smoothedNormal2;
-            }
-            else if (i == cutNum - 2)
-            {
-                int endCutIndex = ((cutNum - 1) + 1.0 / 2.0) * cutSize * 6;
-                int startTriangleIndex = endCutIndex + 3 * j;
-
-                glm::vec3 normal = glm::normalize(m_replicatedCutNormals[endCutIndex]);
-
-                smoothedNormal3 = (normal + normal + normal3_3 + normal3_4) / 4.0f;
-                smoothedNormal4 = (normal + normal + normal4_3 + normal4_4) / 4.0f;
-
-                m_replicatedCutSmoothedNormals[startTriangleIndex] = normal;
-                m_replicatedCutSmoothedNormals[startTriangleIndex + 1] = smoothedNormal3;
-                m_replicatedCutSmoothedNormals[startTriangleIndex + 2] = smoothedNormal4;
-            }
-
-            m_replicatedCutSmoothedNormals[rectIndex] = smoothedNormal1;
-            m_replicatedCutSmoothedNormals[rectIndex + 1] = smoothedNormal2;
-            m_replicatedCutSmoothedNormals[rectIndex + 2] = smoothedNormal3;
-            m_replicatedCutSmoothedNormals[rectIndex + 3] = smoothedNormal2;
-            m_replicatedCutSmoothedNormals[rectIndex + 4] = smoothedNormal3;
-            m_replicatedCutSmoothedNormals[rectIndex + 5] = smoothedNormal4;
+            for (int k : lodInput.trajectoryIndices)
+                lodXAxes.push_back(frameXAxes[k]);
         }
+
+        sweepGenerator.setReferenceXAxes(std::move(lodXAxes));
+
+        Lod lod;
+        lod.maxError = lodInput.maxError;
+
+        generateLod(decimatedInput, sweepGenerator, isSmoothMesh, lod);
+
+        lods.push_back(std::move(lod));
+        previousIndicesSize = indicesSize;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_replicatedCut.size() * sizeof(float) * 3, m_replicatedCut.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return lods;
+}
+
+void ReplicatedCutObject::generateLod(const SweepInput& input, SweepGenerator& sweepGenerator, bool isSmoothMesh, Lod& lod)
+{
+    std::vector<glm::vec3> translatedCut(SweepGenerator::getTrajectoryCutsSize(input.cutSize, input.trajectorySize));
+    sweepGenerator.generateTrajectoryCuts(input, translatedCut.data());
+
+    lod.indicesSize = SweepGenerator::getReplicatedCutSize(input.cutSize, input.trajectorySize);
+
+    std::vector<InterleavedVertex>& vertices = lod.vertices;
+    std::vector<GLuint>& indices = lod.indices;
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutNormalsBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_replicatedCutNormals.size() * sizeof(float) * 3, m_replicatedCutNormals.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // the level holds the same mesh as the full indexed surface
+    if (isSmoothMesh)
+        vertices.resize(SweepGenerator::getIndexedSmoothVerticesSize(input.cutSize, input.trajectorySize));
+    else
+        vertices.resize(SweepGenerator::getIndexedFlatVerticesSize(input.cutSize, input.trajectorySize));
+
+    indices.resize(lod.indicesSize);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutSmoothedNormalsBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_replicatedCutSmoothedNormals.size() * sizeof(float) * 3, m_replicatedCutSmoothedNormals.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    int stride = sizeof(InterleavedVertex);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutTextureBufferObject);
-    glBufferData(GL_ARRAY_BUFFER, m_replicatedCutTextureCoords.size() * sizeof(float) * 2, m_replicatedCutTextureCoords.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    SweepIndexedOutput output;
+    output.positions = SweepAttribute<glm::vec3>(&vertices[0].position, stride);
+    output.normals = SweepAttribute<glm::vec3>(&vertices[0].normal, stride);
+    output.textureCoords = SweepAttribute<glm::vec2>(&vertices[0].textureCoord, stride);
+    output.indices = indices.data();
+
+    if (isSmoothMesh)
+        sweepGenerator.generateIndexedSmoothReplicatedCut(input, translatedCut.data(), output);
+    else
+        sweepGenerator.generateIndexedFlatReplicatedCut(input, translatedCut.data(), output);
 }
 
-void ReplicatedCutObject::renderReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode)
+void ReplicatedCutObject::uploadLods()
 {
-    if (isLightEnabled)
+    for (Lod& lod : m_lods)
     {
-        if (isNormalsMode && isSmoothNormalsMode)
-            renderNormals(normalsColor, true);
-        else if (isNormalsMode && !isSmoothNormalsMode)
-            renderNormals(normalsColor, false);
+        // levels are never updated, so their storage is not dynamic
+        glCreateBuffers(1, &lod.vertexBufferObject);
+        glNamedBufferStorage(lod.vertexBufferObject, lod.vertices.size() * sizeof(InterleavedVertex), lod.vertices.data(), 0);
 
-        m_defaultLightShaderProgram->use();
+        glCreateBuffers(1, &lod.elementBufferObject);
+        glNamedBufferStorage(lod.elementBufferObject, lod.indices.size() * sizeof(GLuint), lod.indices.data(), 0);
 
-        m_defaultLightShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+        glCreateVertexArrays(Vertex_configurations_count, lod.vaos);
+        setupInterleavedVertexArrays(lod.vaos, lod.vertexBufferObject, lod.elementBufferObject, true);
 
-        m_defaultLightShaderProgram->setVec4("material.ambient", m_material->ambient);
-        m_defaultLightShaderProgram->setVec4("material.diffuse", m_material->diffuse);
-        m_defaultLightShaderProgram->setVec4("material.specular", m_material->specular);
-        m_defaultLightShaderProgram->setFloat("material.shininess", m_material->shininess);
+        lod.vertices = std::vector<InterleavedVertex>();
+        lod.indices = std::vector<GLuint>();
+    }
+}
 
-        glBindVertexArray(m_vao);
+void ReplicatedCutObject::clearLods()
+{
+    for (Lod& lod : m_lods)
+    {
+        GLState::deleteBuffers(1, &lod.vertexBufferObject);
+        GLState::deleteBuffers(1, &lod.elementBufferObject);
+        GLState::deleteVertexArrays(Vertex_configurations_count, lod.vaos);
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutBufferObject);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(0);
+    m_lods.clear();
+    m_lodLevel = 0;
+}
 
-        if (isSmoothNormalsMode)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutSmoothedNormalsBufferObject);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-            glEnableVertexAttribArray(1);
-        }
-        else
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutNormalsBufferObject);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-            glEnableVertexAttribArray(1);
-        }
+void ReplicatedCutObject::renderReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode, const InstanceRange& instances)
+{
+    // an empty object is shown while the loaded one is generated
+    if (!m_isSweepPrepared)
+        return;
+
+    if (m_isProceduralMode)
+    {
+        renderProceduralReplicatedCut(replicatedCutColor, normalsColor, isFrameMode, isLightEnabled, isNormalsMode, isSmoothNormalsMode, instances);
+        return;
     }
-    else
+
+    setSmoothMesh(!isLightEnabled || isSmoothNormalsMode);
+
+    if (isLightEnabled)
     {
-        glBindVertexArray(m_vao);
+        if (isNormalsMode && isSmoothNormalsMode)
+            renderNormals(normalsColor, true, instances);
+        else if (isNormalsMode && !isSmoothNormalsMode)
+            renderNormals(normalsColor, false, instances);
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutBufferObject);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(0);
+        // the materials are read from the instances
+        m_defaultLightShaderProgram->use();
+        setPositionDecoding(m_defaultLightShaderProgram, m_defaultLightUniforms);
 
-        if (!m_isMaterialMode)
+        bindReplicatedCutVertexArray(isSmoothNormalsMode ? Smoothed_normals_configuration : Flat_normals_configuration);
+    }
+    else
+    {
+        if (m_isTextureMode)
         {
             m_defaultTextureShaderProgram->use();
 
-            glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutTextureBufferObject);
-            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
-            glEnableVertexAttribArray(1);
+            bindReplicatedCutVertexArray(Texture_configuration);
 
-            glBindTexture(GL_TEXTURE_2D, m_texture->getID());
-            glActiveTexture(GL_TEXTURE2);
+            GLState::bindTextureUnit(textureUnit, m_texture->getID());
 
-            m_defaultTextureShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+            setPositionDecoding(m_defaultTextureShaderProgram, m_defaultTextureUniforms);
         }
         else
         {
             m_defaultShaderProgram->use();
-            m_defaultShaderProgram->setVec3("color", replicatedCutColor);
-            m_defaultShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+            m_defaultShaderProgram->setVec3(m_defaultUniforms.color, replicatedCutColor);
+            m_defaultShaderProgram->setBool(m_defaultUniforms.isInstanced, true);
+            setPositionDecoding(m_defaultShaderProgram, m_defaultUniforms);
+
+            bindReplicatedCutVertexArray(Smoothed_normals_configuration);
         }
     }
 
-    if (isFrameMode)
+    GLState::setCapability(GL_LINE_SMOOTH, false);
+    GLState::setPolygonMode(isFrameMode ? GL_LINE : GL_FILL);
+
+    drawReplicatedCut(instances);
+}
+
+void ReplicatedCutObject::setSmoothMesh(bool isSmoothMesh)
+{
+    if (m_isSmoothMesh == isSmoothMesh)
+        return;
+
+    m_isSmoothMesh = isSmoothMesh;
+
+    // the levels hold the other mesh too, the full surface is drawn until they are built again
+    clearLods();
+    m_isLodOutdated = true;
+
+    if (m_isIndexedMode && m_isSweepPrepared && !m_isStreamingMode)
+        prepareToRenderReplicatedCut();
+}
+
+void ReplicatedCutObject::renderNormals(const glm::vec3& color, bool isSmoothMode, const InstanceRange& instances)
+{
+    GLState::setCapability(GL_LINE_SMOOTH, true);
+
+    m_defaultNormalsShaderProgram->use();
+
+    m_defaultNormalsShaderProgram->setVec3(m_defaultNormalsUniforms.color, color);
+    setPositionDecoding(m_defaultNormalsShaderProgram, m_defaultNormalsUniforms);
+
+    bindReplicatedCutVertexArray(isSmoothMode ? Smoothed_normals_configuration : Flat_normals_configuration);
+
+    drawReplicatedCut(instances);
+}
+
+ReplicatedCutObject::SweepUniforms ReplicatedCutObject::getSweepUniforms(const std::shared_ptr<ShaderProgram>& shaderProgram)
+{
+    SweepUniforms uniforms;
+
+    if (shaderProgram == nullptr)
+        return uniforms;
+
+    uniforms.color = shaderProgram->getUniform<glm::vec3>("color");
+    uniforms.isInstanced = shaderProgram->getUniform<bool>("is_instanced");
+    uniforms.packedChunkSize = shaderProgram->getUniform<int>("packed_chunk_size");
+    uniforms.ringsCount = shaderProgram->getUniform<int>("rings_count");
+    uniforms.profileSize = shaderProgram->getUniform<int>("profile_size");
+    uniforms.isSmoothNormals = shaderProgram->getUniform<bool>("is_smooth_normals");
+    uniforms.isLit = shaderProgram->getUniform<bool>("is_lit");
+    uniforms.isObjectSpace = shaderProgram->getUniform<bool>("is_object_space");
+
+    return uniforms;
+}
+
+void ReplicatedCutObject::setPositionDecoding(const std::shared_ptr<ShaderProgram>& shaderProgram, const SweepUniforms& uniforms) const
+{
+    bool isPacked = m_isPackedMode && !m_isStreamingMode && m_lodLevel == 0;
+
+    // the programs are shared with the other objects, so the decoding is set for every draw
+    shaderProgram->setInt(uniforms.packedChunkSize, isPacked ? PositionQuantization::chunkSize : 0);
+
+    if (isPacked)
+        GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_replicatedCutPackedBoundsBufferObject);
+}
+
+void ReplicatedCutObject::bindReplicatedCutVertexArray(VertexConfiguration configuration)
+{
+    if (m_lodLevel > 0)
     {
-        glEnable(GL_POLYGON_MODE);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        GLState::bindVertexArray(m_lods[m_lodLevel - 1].vaos[configuration]);
+        return;
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, m_replicatedCut.size());
+    GLState::bindVertexArray(m_replicatedCutVaos[configuration]);
+}
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glUseProgram(0);
+void ReplicatedCutObject::drawReplicatedCut(const InstanceRange& instances)
+{
+    if (m_lodLevel > 0)
+    {
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, m_lods[m_lodLevel - 1].indicesSize, GL_UNSIGNED_INT, nullptr, instances.count, instances.first);
+        return;
+    }
 
-    if (isFrameMode)
+    if (m_isIndexedMode && !m_isStreamingMode)
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, m_replicatedCutIndicesSize, GL_UNSIGNED_INT, nullptr, instances.count, instances.first);
+    else if (m_isPackedMode && !m_isStreamingMode)
     {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDisable(GL_POLYGON_MODE);
+        // the padding between the sections is skipped
+        for (const SweepRange& section : m_positionQuantization.getPackedSections())
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, section.begin, section.end - section.begin, instances.count, instances.first);
     }
+    else
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, m_replicatedCutVerticesSize, instances.count, instances.first);
 }
 
-void ReplicatedCutObject::renderNormals(const glm::vec3& color, bool isSmoothMode)
+GLuint ReplicatedCutObject::getNormalsBufferObject(bool isSmoothMode) const
 {
-    glEnable(GL_LINE_SMOOTH);
+    if (isSmoothMode && !m_isIndexedMode)
+        return m_replicatedCutSmoothedNormalsBufferObject;
 
-    m_defaultNormalsShaderProgram->use();
+    return m_replicatedCutNormalsBufferObject;
+}
+
+void ReplicatedCutObject::renderProceduralReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode, const InstanceRange& instances)
+{
+    bool isSmoothMode = !isLightEnabled || isSmoothNormalsMode;
+
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, sweepFramesBufferBinding, m_sweepFramesBufferObject);
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, sweepProfileBufferBinding, m_sweepProfileBufferObject);
 
-    m_defaultNormalsShaderProgram->setVec3("color", color);
-    m_defaultNormalsShaderProgram->setMat4("model_matrix", m_scaleMatrix);
+    GLState::bindVertexArray(m_proceduralVao);
 
-    glBindVertexArray(m_vao);
+    if (isLightEnabled && isNormalsMode)
+    {
+        GLState::setCapability(GL_LINE_SMOOTH, true);
+
+        m_proceduralNormalsShaderProgram->use();
+        m_proceduralNormalsShaderProgram->setVec3(m_proceduralNormalsUniforms.color, normalsColor);
+        setProceduralSweep(m_proceduralNormalsShaderProgram, m_proceduralNormalsUniforms, isSmoothMode, false, true);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutBufferObject);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(0);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, m_replicatedCutVerticesSize, instances.count, instances.first);
+    }
 
-    if (isSmoothMode)
+    if (isLightEnabled)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutSmoothedNormalsBufferObject);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(1);
+        m_proceduralLightShaderProgram->use();
+        setProceduralSweep(m_proceduralLightShaderProgram, m_proceduralLightUniforms, isSmoothMode, true, false);
+    }
+    else if (m_isTextureMode)
+    {
+        m_proceduralTextureShaderProgram->use();
+        setProceduralSweep(m_proceduralTextureShaderProgram, m_proceduralTextureUniforms, isSmoothMode, false, false);
+
+        GLState::bindTextureUnit(textureUnit, m_texture->getID());
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_replicatedCutNormalsBufferObject);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(1);
+        m_proceduralShaderProgram->use();
+        m_proceduralShaderProgram->setVec3(m_proceduralUniforms.color, replicatedCutColor);
+        setProceduralSweep(m_proceduralShaderProgram, m_proceduralUniforms, isSmoothMode, false, false);
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, m_replicatedCut.size());
+    GLState::setCapability(GL_LINE_SMOOTH, false);
+    GLState::setPolygonMode(isFrameMode ? GL_LINE : GL_FILL);
 
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glUseProgram(0);
+    glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, m_replicatedCutVerticesSize, instances.count, instances.first);
+}
 
-    glDisable(GL_LINE_SMOOTH);
+void ReplicatedCutObject::setProceduralSweep(const std::shared_ptr<ShaderProgram>& shaderProgram, const SweepUniforms& uniforms, bool isSmoothMode, bool isLit, bool isObjectSpace) const
+{
+    // the programs share one vertex shader and the other objects, so everything is set for every draw
+    shaderProgram->setInt(uniforms.ringsCount, m_trajectory.size());
+    shaderProgram->setInt(uniforms.profileSize, m_cut.size());
+    shaderProgram->setBool(uniforms.isSmoothNormals, isSmoothMode);
+    shaderProgram->setBool(uniforms.isLit, isLit);
+    shaderProgram->setBool(uniforms.isObjectSpace, isObjectSpace);
 }
 
 void ReplicatedCutObject::generateBuffers()
 {
-    glCreateVertexArrays(1, &m_vao);
+    glCreateVertexArrays(1, &m_trajectoryVao);
+    glCreateVertexArrays(1, &m_trajectoryCutsVao);
     glCreateBuffers(1, &m_trajectoryBufferObject);
     glCreateBuffers(1, &m_trajectoryCutsBufferObject);
+    glCreateBuffers(1, &m_trajectoryCutsElementBufferObject);
     glCreateBuffers(1, &m_replicatedCutBufferObject);
     glCreateBuffers(1, &m_replicatedCutNormalsBufferObject);
     glCreateBuffers(1, &m_replicatedCutSmoothedNormalsBufferObject);
     glCreateBuffers(1, &m_replicatedCutTextureBufferObject);
+    glCreateBuffers(1, &m_replicatedCutElementBufferObject);
+    glCreateBuffers(1, &m_replicatedCutInterleavedBufferObject);
+    glCreateBuffers(1, &m_replicatedCutPackedBoundsBufferObject);
+    glCreateBuffers(1, &m_sweepFramesBufferObject);
+    glCreateBuffers(1, &m_sweepProfileBufferObject);
+    glCreateVertexArrays(1, &m_proceduralVao);
+    glCreateVertexArrays(Vertex_configurations_count, m_replicatedCutVaos);
+}
+
+SweepInput ReplicatedCutObject::getSweepInput() const
+{
+    SweepInput input;
+    input.cut = m_cut.data();
+    input.cutSize = m_cut.size();
+    input.trajectory = m_trajectory.data();
+    input.trajectorySize = m_trajectory.size();
+    input.cutParameters = m_cutParameters.data();
+    input.cutParametersSize = m_cutParameters.size();
+
+    return input;
 }
 
-void ReplicatedCutObject::calcVectorsOrientationInTrajectory()
+void ReplicatedCutObject::calcBounds()
 {
-    int trajectorySize = m_trajectory.size();
-    m_isChangeVectorOrientation.resize(trajectorySize);
+    // checked quietly, the invalid input is reported when the sweep is generated
+    if (m_cut.empty() || m_trajectory.empty() || m_cutParameters.size() < m_trajectory.size())
+    {
+        m_boundsCenter = glm::vec3(0.0f);
+        m_boundsRadius = 0.0f;
+        return;
+    }
+
+    m_profileRadius = SweepLod::calcProfileRadius(m_cut.data(), m_cut.size());
+    m_maxCutParameter = *std::max_element(m_cutParameters.begin(), m_cutParameters.end());
+
+    m_trajectoryMin = m_trajectory[0];
+    m_trajectoryMax = m_trajectory[0];
+
+    for (const glm::vec3& point : m_trajectory)
+    {
+        m_trajectoryMin = glm::min(m_trajectoryMin, point);
+        m_trajectoryMax = glm::max(m_trajectoryMax, point);
+    }
+
+    calcBoundingSphere();
+}
+
+void ReplicatedCutObject::updatePointBounds(int i, const glm::vec3& oldPoint)
+{
+    if (!isBoundsInputValid(i))
+    {
+        calcBounds();
+        return;
+    }
+
+    const glm::vec3& point = m_trajectory[i];
 
-    for (int i = 1; i < trajectorySize - 1; ++i)
+    // a point that leaves the box inwards may have been the only one on its side
+    for (int k = 0; k < 3; ++k)
     {
-        glm::vec3 p1 = m_trajectory[i - 1];
-        glm::vec3 p2 = m_trajectory[i];
-        glm::vec3 p3 = m_trajectory[i + 1];
+        if ((oldPoint[k] == m_trajectoryMin[k] && point[k] > oldPoint[k]) || (oldPoint[k] == m_trajectoryMax[k] && point[k] < oldPoint[k]))
+        {
+            calcBounds();
+            return;
+        }
+    }
+
+    m_trajectoryMin = glm::min(m_trajectoryMin, point);
+    m_trajectoryMax = glm::max(m_trajectoryMax, point);
+
+    calcBoundingSphere();
+}
 
-        glm::vec3 a = p2 - p1;
-        glm::vec3 b = p3 - p2;
+void ReplicatedCutObject::updateCutParameterBounds(int i, float oldCutParameter)
+{
+    if (!isBoundsInputValid(i))
+    {
+        calcBounds();
+        return;
+    }
 
-        float product = a.x * b.y - a.y * b.x;
+    float cutParameter = m_cutParameters[i];
 
-        m_isChangeVectorOrientation[i] = product > 0 ? true : false;
+    if (oldCutParameter == m_maxCutParameter && cutParameter < oldCutParameter)
+    {
+        calcBounds();
+        return;
     }
+
+    m_maxCutParameter = std::max(m_maxCutParameter, cutParameter);
+
+    calcBoundingSphere();
+}
+
+bool ReplicatedCutObject::isBoundsInputValid(int i) const
+{
+    return !m_cut.empty() && i < static_cast<int>(m_trajectory.size()) && m_cutParameters.size() >= m_trajectory.size();
 }
+
+void ReplicatedCutObject::calcBoundingSphere()
+{
+    glm::vec3 min = m_trajectoryMin - glm::vec3(m_profileRadius * m_maxCutParameter);
+    glm::vec3 max = m_trajectoryMax + glm::vec3(m_profileRadius * m_maxCutParameter);
+
+    m_boundsCenter = 0.5f * (min + max);
+    m_boundsRadius = 0.5f * glm::length(max - min);
+}
\ No newline at end of file
@@ -1,49 +1,257 @@
 #ifndef REPLICATED_CUT_OBJECT_H
 #define REPLICATED_CUT_OBJECT_H
 
+#include "CutObjectFile.h"
 #include "LightManager.h"
-#include "MaterialTypes.h"
 #include "ResourcesManager.h"
 #include "ShaderProgram.h"
+#include "SweepGenerator.h"
+#include "SweepLod.h"
+#include "ThreadPool.h"
+#include "TrajectorySpline.h"
+#include "VertexPacking.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <future>
 #include <memory>
 #include <string_view>
 #include <vector>
 
+struct InterleavedVertex
+{
+    glm::vec3 position{};
+    glm::vec3 normal{};
+    glm::vec2 textureCoord{};
+};
+
+struct InterleavedSmoothedVertex
+{
+    glm::vec3 position{};
+    glm::vec3 normal{};
+    glm::vec3 smoothedNormal{};
+    glm::vec2 textureCoord{};
+};
+
+// consecutive instances of an object in the instance buffer of the scene
+struct InstanceRange
+{
+    int first = 0;
+    int count = 1;
+};
+
 class ReplicatedCutObject
 {
 public:
-    ReplicatedCutObject(std::string_view fullFilePath, ResourceManager* resourceManager, std::string_view material, std::string_view texture);
+    ReplicatedCutObject(CutObjectData data, ResourceManager* resourceManager, std::string_view texture, ThreadPool* threadPool = nullptr);
     ~ReplicatedCutObject();
 
-    void setMaterial(std::string material);
+    // the constructor and generate() make no OpenGL calls, so an object can be generated on another thread,
+    // upload() is called by the render thread before the object is used and generates whatever generate() skipped
+    void generate();
+    void upload();
+
+    // texture and modes of the object that this one replaces
+    void copyAppearance(const ReplicatedCutObject& cutObject);
+
+    // the unlit surface is drawn with the texture or with a plain color, lit surfaces use the materials of the instances
     void setTexture(std::string texture);
+    void setTextureMode(bool isTextureMode);
+    bool getTextureMode() const;
+
+    void setIndexedMode(bool isIndexedMode);
+    bool getIndexedMode() const;
+
+    void setInterleavedMode(bool isInterleavedMode);
+    bool getInterleavedMode() const;
+
+    // packed vertices take 16 or 20 bytes instead of 32 or 44, positions are decoded in the vertex shaders
+    void setPackedMode(bool isPackedMode);
+    bool getPackedMode() const;
+
+    // the rings and the surface are generated and uploaded in chunks, so the host memory does not grow with the trajectory,
+    // streamed surfaces are drawn as interleaved triangles without indices and are generated again on every edit
+    void setStreamingMode(bool isStreamingMode);
+    bool getStreamingMode() const;
+
+    // only the ring frames and the profile are uploaded, the vertex shader rebuilds the surface from gl_VertexID,
+    // so a cut parameter edit writes one frame; the procedural surface has no levels of detail
+    void setProceduralMode(bool isProceduralMode);
+    bool getProceduralMode() const;
+
+    void setFrameMode(FrameModes frameMode);
+    FrameModes getFrameMode() const;
+
+    // coarser surfaces are drawn while their error stays below a pixel on the screen
+    void setLodMode(bool isLodMode);
+    bool getLodMode() const;
+    int getLodLevel() const;
+    int getLodLevelsCount() const;
+    // the model view matrix of the nearest instance, the level is shared by all instances
+    void selectLod(const glm::mat4& modelViewMatrix, const glm::mat4& projectionMatrix, int viewportHeight);
+
+    // bounding sphere of the surface in object space
+    glm::vec3 getBoundsCenter() const;
+    float getBoundsRadius() const;
+
+    void setThreadPool(ThreadPool* threadPool);
+    void setParallelMode(bool isParallelMode);
+    bool getParallelMode() const;
+
+    // control points are sampled adaptively when they are interpreted as a spline
+    void setTrajectoryCurve(TrajectoryCurves trajectoryCurve);
+    TrajectoryCurves getTrajectoryCurve() const;
 
-    void setScale(float scale);
+    // points and cut parameters of the control polygon
+    int getTrajectorySize() const;
+    glm::vec3 getTrajectoryPoint(int i) const;
+    float getCutParameter(int i) const;
+
+    // polyline edits regenerate only the rings around the point and patch the uploaded buffers in place,
+    // spline edits sample the curve again
+    void updateTrajectoryPoint(int i, const glm::vec3& point);
+    void updateCutParameter(int i, float cutParameter);
 
     void prepareToRenderTrajectory();
-    void renderTrajectory(const glm::vec3& color);
+    void renderTrajectory(const glm::vec3& color, const InstanceRange& instances);
 
     void prepareToRenderTrajectoryCuts();
-    void renderTrajectoryCuts(const glm::vec3& color, bool isFrameMode);
+    void renderTrajectoryCuts(const glm::vec3& color, bool isFrameMode, const InstanceRange& instances);
 
     void prepareToRenderReplicatedCut();
-    void renderReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode);
+    void renderReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode, const InstanceRange& instances);
 
 private:
+    enum VertexConfiguration
+    {
+        Flat_normals_configuration,
+        Smoothed_normals_configuration,
+        Texture_configuration,
+        Vertex_configurations_count
+    };
+
+    // handles of the uniforms the object sets, a program keeps -1 for the ones it does not use
+    struct SweepUniforms
+    {
+        Uniform<glm::vec3> color;
+        Uniform<bool> isInstanced;
+        Uniform<int> packedChunkSize;
+        Uniform<int> ringsCount;
+        Uniform<int> profileSize;
+        Uniform<bool> isSmoothNormals;
+        Uniform<bool> isLit;
+        Uniform<bool> isObjectSpace;
+    };
+
+    // coarser copy of the surface, always indexed and interleaved
+    struct Lod
+    {
+        float maxError = 0.0f;
+        int indicesSize = 0;
+
+        GLuint vertexBufferObject{};
+        GLuint elementBufferObject{};
+        GLuint vaos[Vertex_configurations_count]{};
+
+        // freed when the level is uploaded
+        std::vector<InterleavedVertex> vertices;
+        std::vector<GLuint> indices;
+    };
+
+    static constexpr float trajectoryMaxChordError = 0.0001f; // of the control polygon bounding box diagonal
+    static constexpr float trajectoryMaxAngle = 0.0872665f; // 5 degrees
+
+    static constexpr int streamingChunkVerticesSize = 1 << 20;
+    static constexpr GLuint primitiveRestartIndex = 0xFFFFFFFF; // the fixed index of GL_UNSIGNED_INT
+
+    static constexpr GLuint sweepFramesBufferBinding = 4;
+    static constexpr GLuint sweepProfileBufferBinding = 5;
+    static constexpr GLuint textureUnit = 2; // the sampler binding of the texture shaders
+
+    static constexpr int lodLevelsCount = 4;
+    static constexpr float lodBaseChordError = 0.0005f; // of the bounding box diagonal
+    static constexpr float lodBaseAngle = 0.17453293f; // 10 degrees
+    static constexpr float lodMaxPixelError = 1.0f;
+    // the current level is kept until its error grows by this factor, so the level does not flicker on the threshold
+    static constexpr float lodHysteresis = 1.25f;
+    static constexpr float lodMinDistance = 0.1f;
+
     void generateBuffers();
-    void calcVectorsOrientationInTrajectory();
+    void sampleTrajectory();
+    void updateTrajectoryCurve();
+    SweepInput getSweepInput() const;
+    void calcBounds();
+    // an edit of point i only grows the bounds, they are calculated again when an extreme point or scale moves inwards
+    void updatePointBounds(int i, const glm::vec3& oldPoint);
+    void updateCutParameterBounds(int i, float oldCutParameter);
+    bool isBoundsInputValid(int i) const;
+    void calcBoundingSphere();
 
-    void renderNormals(const glm::vec3& color, bool isSmoothMode);
+    void updateSweep(const SweepRange& changedRange, bool isTrajectoryChanged);
+    void updateReplicatedCut(const SweepInput& input, const SweepRange& changedRings);
+    void updateIndexedReplicatedCut(const SweepInput& input, const SweepRange& changedRings);
+
+    void setBufferStorage(GLuint& buffer, GLsizeiptr size, const void* data);
+    void updateBufferRange(GLuint buffer, const SweepRange& range, GLsizeiptr elementSize, const void* data);
+    void uploadBufferChunk(GLuint buffer, GLintptr firstElement, GLsizeiptr elementsSize, GLsizeiptr elementSize, const void* data);
+
+    bool isInterleavedStorage() const;
+    void packReplicatedCut();
+    void updatePackedReplicatedCut(const std::vector<SweepRange>& changedVertices);
+    std::vector<SweepRange> getPackedSections() const;
+    std::vector<GLuint> getUploadedIndices(const SweepRange& range) const;
+    void updateIndicesRange(const SweepRange& range);
+
+    void buildReplicatedCut(const SweepInput& input);
+    void generateReplicatedCut(const SweepInput& input);
+    SweepOutput getOutput();
+    void generateIndexedReplicatedCut(const SweepInput& input);
+    void resizeIndexedReplicatedCut(int verticesSize);
+    SweepIndexedOutput getIndexedOutput(int firstVertex);
+    void clearReplicatedCut();
+    int getStreamingChunkSize(int cutSize) const;
+    void streamTrajectoryCuts(const SweepInput& input);
+    void uploadTrajectoryCutsIndices(int cutSize, int trajectorySize);
+    void streamReplicatedCut(const SweepInput& input);
+    void uploadReplicatedCut();
+    void setupTrajectoryVertexArray(GLuint vao, GLuint vertexBufferObject, GLuint elementBufferObject);
+    void setupSeparateVertexArrays();
+    void setupInterleavedVertexArrays(const GLuint* vaos, GLuint vertexBufferObject, GLuint elementBufferObject, bool isIndexed);
+    void setupPackedVertexArrays();
+    void uploadProceduralReplicatedCut(const SweepInput& input);
+    void updateProceduralReplicatedCut(const SweepInput& input, const SweepRange& changedRings);
+
+    void buildLods();
+    void startLodTask();
+    void finishLodTask();
+    static std::vector<Lod> generateLods(const SweepInput& input, const std::vector<glm::vec3>& frameXAxes, FrameModes frameMode, bool isSmoothMesh,
+                                         float boundsRadius, ThreadPool* threadPool);
+    static void generateLod(const SweepInput& input, SweepGenerator& sweepGenerator, bool isSmoothMesh, Lod& lod);
+    void uploadLods();
+    void clearLods();
+
+    // the smooth mesh is drawn unlit and with the smoothed normals, the flat one with the face normals
+    void setSmoothMesh(bool isSmoothMesh);
+    void renderNormals(const glm::vec3& color, bool isSmoothMode, const InstanceRange& instances);
+    static SweepUniforms getSweepUniforms(const std::shared_ptr<ShaderProgram>& shaderProgram);
+    void setPositionDecoding(const std::shared_ptr<ShaderProgram>& shaderProgram, const SweepUniforms& uniforms) const;
+    void bindReplicatedCutVertexArray(VertexConfiguration configuration);
+    void drawReplicatedCut(const InstanceRange& instances);
+    GLuint getNormalsBufferObject(bool isSmoothMode) const;
+
+    void renderProceduralReplicatedCut(const glm::vec3& replicatedCutColor, const glm::vec3& normalsColor, bool isFrameMode, bool isLightEnabled, bool isNormalsMode, bool isSmoothNormalsMode, const InstanceRange& instances);
+    void setProceduralSweep(const std::shared_ptr<ShaderProgram>& shaderProgram, const SweepUniforms& uniforms, bool isSmoothMode, bool isLit, bool isObjectSpace) const;
 
     ResourceManager* m_resourceManager = nullptr;
 
     std::vector<glm::vec2> m_cut;
-    std::vector<glm::vec2> m_originTranslatedCut;
-    std::vector<glm::vec2> m_originTranslatedNormalizedCut;
+    std::vector<glm::vec3> m_controlPoints;
+    std::vector<float> m_controlCutParameters;
+    std::vector<float> m_controlWeights;
+    TrajectoryCurves m_trajectoryCurve = Polyline_curve;
+
+    // samples of the trajectory curve, one ring is placed at each of them
     std::vector<glm::vec3> m_trajectory;
     std::vector<float> m_cutParameters;
     std::vector<glm::vec3> m_translatedCut;
@@ -51,27 +259,84 @@ private:
     std::vector<glm::vec3> m_replicatedCutNormals;
     std::vector<glm::vec3> m_replicatedCutSmoothedNormals;
     std::vector<glm::vec2> m_replicatedCutTextureCoords;
+    std::vector<GLuint> m_replicatedCutIndices;
+    std::vector<InterleavedVertex> m_replicatedCutVertices;
+    std::vector<InterleavedSmoothedVertex> m_replicatedCutSmoothedVertices;
+    std::vector<PackedVertex> m_replicatedCutPackedVertices;
+    std::vector<PackedSmoothedVertex> m_replicatedCutPackedSmoothedVertices;
+    PositionQuantization m_positionQuantization;
 
-    std::vector<bool> m_isChangeVectorOrientation;
+    SweepGenerator m_sweepGenerator;
+    ThreadPool* m_threadPool = nullptr;
+    bool m_isParallelMode = true;
 
-    GLuint m_vao{};
+    // the vertex arrays are set up when their buffers are created, drawing only binds them
+    GLuint m_trajectoryVao{};
+    GLuint m_trajectoryCutsVao{};
     GLuint m_trajectoryBufferObject{};
     GLuint m_trajectoryCutsBufferObject{};
+    GLuint m_trajectoryCutsElementBufferObject{};
     GLuint m_replicatedCutBufferObject{};
     GLuint m_replicatedCutNormalsBufferObject{};
     GLuint m_replicatedCutSmoothedNormalsBufferObject{};
     GLuint m_replicatedCutTextureBufferObject{};
+    GLuint m_replicatedCutElementBufferObject{};
+    GLuint m_replicatedCutInterleavedBufferObject{};
+    GLuint m_replicatedCutPackedBoundsBufferObject{};
+    GLuint m_sweepFramesBufferObject{};
+    GLuint m_sweepProfileBufferObject{};
+    GLuint m_proceduralVao{}; // no vertex attributes are enabled
+
+    // one vertex array per vertex configuration in every vertex format, the normals reuse the light ones
+    GLuint m_replicatedCutVaos[Vertex_configurations_count]{};
 
     std::shared_ptr<ShaderProgram> m_defaultShaderProgram = nullptr;
     std::shared_ptr<ShaderProgram> m_defaultTextureShaderProgram = nullptr;
     std::shared_ptr<ShaderProgram> m_defaultLightShaderProgram = nullptr;
     std::shared_ptr<ShaderProgram> m_defaultNormalsShaderProgram = nullptr;
+    std::shared_ptr<ShaderProgram> m_proceduralShaderProgram = nullptr;
+    std::shared_ptr<ShaderProgram> m_proceduralTextureShaderProgram = nullptr;
+    std::shared_ptr<ShaderProgram> m_proceduralLightShaderProgram = nullptr;
+    std::shared_ptr<ShaderProgram> m_proceduralNormalsShaderProgram = nullptr;
 
-    bool m_isMaterialMode = true;
-    std::shared_ptr<NaturalMaterial> m_material = nullptr;
+    SweepUniforms m_defaultUniforms;
+    SweepUniforms m_defaultTextureUniforms;
+    SweepUniforms m_defaultLightUniforms;
+    SweepUniforms m_defaultNormalsUniforms;
+    SweepUniforms m_proceduralUniforms;
+    SweepUniforms m_proceduralTextureUniforms;
+    SweepUniforms m_proceduralLightUniforms;
+    SweepUniforms m_proceduralNormalsUniforms;
+
+    bool m_isTextureMode = false;
     std::shared_ptr<Texture> m_texture = nullptr;
 
-    glm::mat4 m_scaleMatrix = glm::mat4(1.0f);
+    // indexed surfaces and the levels keep only the mesh of the drawn normals, the display mode switches between them
+    bool m_isIndexedMode = true;
+    bool m_isSmoothMesh = false;
+    bool m_isInterleavedMode = true;
+    bool m_isPackedMode = false;
+    bool m_isStreamingMode = false;
+    bool m_isProceduralMode = false;
+    bool m_isSweepPrepared = false;
+
+    std::vector<Lod> m_lods;
+    int m_lodLevel = 0; // 0 is the full surface, level i is m_lods[i - 1]
+    bool m_isLodMode = true;
+    bool m_isLodOutdated = true;
+    // the levels are rebuilt by a task after an edit, the render thread draws the full surface and uploads them once it is done
+    std::future<void> m_lodTask;
+    std::vector<Lod> m_generatedLods;
+    glm::vec3 m_boundsCenter = glm::vec3(0.0f);
+    float m_boundsRadius = 0.0f;
+    // the box of the trajectory, the sphere adds the largest profile radius to it
+    glm::vec3 m_trajectoryMin = glm::vec3(0.0f);
+    glm::vec3 m_trajectoryMax = glm::vec3(0.0f);
+    float m_maxCutParameter = 0.0f;
+    float m_profileRadius = 0.0f;
+    int m_replicatedCutVerticesSize = 0;
+    int m_replicatedCutIndicesSize = 0;
+    int m_trajectoryCutsIndicesSize = 0;
 };
 
 #endif
\ No newline at end of file
@@ -1,12 +1,17 @@
 #include "ResourcesManager.h"
 
+#include "GLState.h"
 #include "MaterialTypes.h"
 #include "ShaderProgram.h"
 #include "Texture.h"
+#include "TextScanner.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -16,6 +21,7 @@
 #include <memory>
 #include <vector>
 #include <filesystem>
+#include <iterator>
 
 ResourceManager::ResourceManager(std::string_view executablePath)
 {
@@ -23,6 +29,11 @@ ResourceManager::ResourceManager(std::string_view executablePath)
     m_path = executablePath.substr(0, found);
 }
 
+ResourceManager::~ResourceManager()
+{
+    GLState::deleteBuffers(1, &m_naturalMaterialsBufferObject);
+}
+
 std::string ResourceManager::getFileString(std::string_view relativeFilePath) const
 {
     std::ifstream f;
@@ -184,39 +195,58 @@ std::vector<std::string> ResourceManager::getTexturesNames()
 
 void ResourceManager::loadNaturalMaterial(std::string_view materialPath)
 {
-    std::ifstream f;
-
-    f.open(m_path + "/" + materialPath.data());
+    TextScanner scanner;
 
-    if (!f.is_open())
+    if (!scanner.open(m_path + "/" + materialPath.data()))
         std::cerr << "Failed to open natural materials file!" << std::endl;
     else
     {
         int size = 0;
 
-        f >> size;
+        scanner.read(size);
 
         NaturalMaterial material{};
 
-        std::string name;
-        glm::vec4* ambient = &material.ambient;
-        glm::vec4* diffuse = &material.diffuse;
-        glm::vec4* specular = &material.specular;
-        float* shininess = &material.shininess;
+        std::string_view name;
 
         for (int i = 0; i < size; ++i)
         {
-            f >> name;
-            f >> ambient->x >> ambient->y >> ambient->z >> ambient->w;
-            f >> diffuse->x >> diffuse->y >> diffuse->z >> diffuse->w;
-            f >> specular->x >> specular->y >> specular->z >> specular->w;
-            f >> *shininess;
+            scanner.read(name);
+            scanner.read(glm::value_ptr(material.ambient), 4);
+            scanner.read(glm::value_ptr(material.diffuse), 4);
+            scanner.read(glm::value_ptr(material.specular), 4);
+            scanner.read(material.shininess);
 
-            m_naturalMaterials.emplace(name, std::make_shared<NaturalMaterial>(material));
+            // materials before the error are kept
+            if (scanner.isFailed())
+                break;
+
+            m_naturalMaterials.emplace(std::string(name), std::make_shared<NaturalMaterial>(material));
         }
 
-        f.close();
+        scanner.close();
+    }
+
+    uploadNaturalMaterials();
+}
+
+void ResourceManager::uploadNaturalMaterials()
+{
+    // an empty buffer can not be bound, so there is always at least the default material
+    std::vector<NaturalMaterial> materials(std::max<size_t>(m_naturalMaterials.size(), 1));
+
+    int i = 0;
+    for (auto& material : m_naturalMaterials)
+    {
+        materials[i] = *material.second;
+        ++i;
     }
+
+    GLState::deleteBuffers(1, &m_naturalMaterialsBufferObject);
+    glCreateBuffers(1, &m_naturalMaterialsBufferObject);
+    glNamedBufferStorage(m_naturalMaterialsBufferObject, materials.size() * sizeof(NaturalMaterial), materials.data(), 0);
+
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, naturalMaterialsBufferBinding, m_naturalMaterialsBufferObject);
 }
 
 std::shared_ptr<NaturalMaterial> ResourceManager::getNaturalMaterial(std::string_view materialName)
@@ -236,6 +266,18 @@ std::vector<std::string> ResourceManager::getNaturalMaterialNames()
     return getNamesFromMap(m_naturalMaterials);
 }
 
+int ResourceManager::getNaturalMaterialIndex(std::string_view materialName)
+{
+    NaturalMaterialsMap::const_iterator it = m_naturalMaterials.find(materialName.data());
+
+    if (it != m_naturalMaterials.end())
+        return std::distance(m_naturalMaterials.cbegin(), it);
+
+    std::cerr << "Can't find the material: " << materialName << std::endl;
+
+    return -1;
+}
+
 std::string ResourceManager::getFullFilePath(std::string_view relativeFilePath) const
 {
     return static_cast<std::string>(m_path + "/" + relativeFilePath.data());
@@ -5,6 +5,8 @@
 #include "ShaderProgram.h"
 #include "Texture.h"
 
+#include <glad/glad.h>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -15,7 +17,7 @@ class ResourceManager
 {
 public:
     ResourceManager(std::string_view executablePath);
-    ~ResourceManager() = default;
+    ~ResourceManager();
 
     ResourceManager(const ResourceManager&) = delete;
     ResourceManager& operator=(const ResourceManager&) = delete;
@@ -31,14 +33,20 @@ public:
     std::shared_ptr<Texture> getTexture(std::string_view textureName);
     std::vector<std::string> getTexturesNames();
 
+    // all loaded materials are kept in one buffer in the order of their names, the shaders select them by index
     void loadNaturalMaterial(std::string_view materialPath);
     std::shared_ptr<NaturalMaterial> getNaturalMaterial(std::string_view materialName);
     std::vector<std::string> getNaturalMaterialNames();
+    // -1 for an unknown material, the indices change when another materials file is loaded
+    int getNaturalMaterialIndex(std::string_view materialName);
 
     std::string getFullFilePath(std::string_view relativeFilePath) const;
 
 private:
+    static constexpr GLuint naturalMaterialsBufferBinding = 6;
+
     std::string getFileString(std::string_view relativeFilePath) const;
+    void uploadNaturalMaterials();
 
     template<typename T>
     std::vector<std::string> getNamesFromMap(const std::map<std::string, T>& mapContainer) const;
@@ -51,6 +59,7 @@ private:
 
     typedef std::map<std::string, std::shared_ptr<NaturalMaterial>> NaturalMaterialsMap;
     NaturalMaterialsMap m_naturalMaterials;
+    GLuint m_naturalMaterialsBufferObject{};
 
     std::string m_path;
 };
@@ -0,0 +1,560 @@
+#include "Scene.h"
+
+#include "CutObjectFile.h"
+#include "CutObjectLoader.h"
+#include "GLState.h"
+#include "ReplicatedCutObject.h"
+#include "ResourcesManager.h"
+#include "TextScanner.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+    float getMaxScale(const glm::mat4& matrix)
+    {
+        return std::max({ glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])) });
+    }
+
+    // grows the first sphere until it contains the second one
+    void mergeSphere(glm::vec3& center, float& radius, const glm::vec3& otherCenter, float otherRadius)
+    {
+        if (otherRadius < 0.0f)
+            return;
+
+        glm::vec3 offset = otherCenter - center;
+        float distance = glm::length(offset);
+
+        if (radius >= 0.0f && distance + otherRadius <= radius)
+            return;
+
+        if (radius < 0.0f || distance + radius <= otherRadius)
+        {
+            center = otherCenter;
+            radius = otherRadius;
+            return;
+        }
+
+        float mergedRadius = 0.5f * (distance + radius + otherRadius);
+        center += offset * ((mergedRadius - radius) / distance);
+        radius = mergedRadius;
+    }
+}
+
+Scene::Scene(ResourceManager* resourceManager, ThreadPool* threadPool) :
+    m_resourceManager(resourceManager),
+    m_threadPool(threadPool)
+{
+    std::vector<std::string> textures = m_resourceManager->getTexturesNames();
+
+    if (!textures.empty())
+        m_defaultTexture = textures[0];
+}
+
+Scene::~Scene()
+{
+    // a loader waits for its task, so nothing is handed over after this
+    for (SharedCutObject& cutObject : m_cutObjects)
+    {
+        delete cutObject.loader;
+        delete cutObject.cutObject;
+    }
+
+    GLState::deleteBuffers(1, &m_instancesBufferObject);
+}
+
+bool Scene::load(std::string_view fullFilePath)
+{
+    TextScanner scanner;
+
+    if (!scanner.open(fullFilePath))
+    {
+        std::cerr << "Failed to open scene file!" << std::endl;
+        return false;
+    }
+
+    int size = 0;
+    scanner.read(size);
+
+    // parents are indexed inside the file
+    int firstNode = m_nodes.size();
+
+    for (int i = 0; i < size && !scanner.isFailed(); ++i)
+    {
+        std::string_view name;
+        int parent = -1;
+        std::string_view cutObjectFilePath;
+        std::string_view material;
+        glm::vec3 position(0.0f);
+        glm::vec3 rotation(0.0f);
+        glm::vec3 scale(1.0f);
+
+        scanner.read(name);
+        scanner.read(parent);
+        scanner.read(cutObjectFilePath);
+        scanner.read(material);
+        scanner.read(glm::value_ptr(position), 3);
+        scanner.read(glm::value_ptr(rotation), 3);
+        scanner.read(glm::value_ptr(scale), 3);
+
+        if (scanner.isFailed())
+            break;
+
+        // the resource manager looks up null terminated names, the tokens point into the file
+        std::string cutObjectFullFilePath = cutObjectFilePath == "-" ? std::string() : m_resourceManager->getFullFilePath(std::string(cutObjectFilePath));
+        int node = addNode(name, parent < 0 ? -1 : firstNode + parent, cutObjectFullFilePath, material == "-" ? std::string_view() : material);
+
+        if (node < 0)
+            return false;
+
+        setNodeTransform(node, position, rotation, scale);
+    }
+
+    return !scanner.isFailed();
+}
+
+int Scene::addNode(std::string_view name, int parent, std::string_view cutObjectFullFilePath, std::string_view material)
+{
+    if (parent < -1 || parent >= static_cast<int>(m_nodes.size()))
+    {
+        std::cerr << "Scene node " << name << " must be added after its parent!" << std::endl;
+        return -1;
+    }
+
+    int node = m_nodes.size();
+
+    Node& added = m_nodes.emplace_back();
+    added.name = name;
+    added.parent = parent;
+    added.material = material.empty() ? 0 : std::max(m_resourceManager->getNaturalMaterialIndex(std::string(material)), 0);
+
+    if (!cutObjectFullFilePath.empty())
+    {
+        added.cutObject = addCutObject(cutObjectFullFilePath);
+        m_cutObjects[added.cutObject].nodes.push_back(node);
+    }
+
+    if (parent < 0)
+        m_roots.push_back(node);
+    else
+        m_nodes[parent].children.push_back(node);
+
+    markTransformDirty(node);
+
+    return node;
+}
+
+int Scene::getNodesCount() const
+{
+    return m_nodes.size();
+}
+
+const std::string& Scene::getNodeName(int node) const
+{
+    return m_nodes[node].name;
+}
+
+int Scene::getNodeDepth(int node) const
+{
+    int depth = 0;
+
+    for (int parent = m_nodes[node].parent; parent >= 0; parent = m_nodes[parent].parent)
+        ++depth;
+
+    return depth;
+}
+
+void Scene::setNodeTransform(int node, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    Node& changed = m_nodes[node];
+    changed.position = position;
+    changed.rotation = rotation;
+    changed.scale = scale;
+
+    markTransformDirty(node);
+}
+
+glm::vec3 Scene::getNodePosition(int node) const
+{
+    return m_nodes[node].position;
+}
+
+glm::vec3 Scene::getNodeRotation(int node) const
+{
+    return m_nodes[node].rotation;
+}
+
+glm::vec3 Scene::getNodeScale(int node) const
+{
+    return m_nodes[node].scale;
+}
+
+void Scene::setNodeMaterial(int node, std::string_view material)
+{
+    int index = m_resourceManager->getNaturalMaterialIndex(std::string(material));
+
+    if (index >= 0)
+        m_nodes[node].material = index;
+}
+
+ReplicatedCutObject* Scene::getCutObject(int node) const
+{
+    if (node < 0 || node >= static_cast<int>(m_nodes.size()) || m_nodes[node].cutObject < 0)
+        return nullptr;
+
+    return m_cutObjects[m_nodes[node].cutObject].cutObject;
+}
+
+void Scene::invalidateCutObjectBounds(int node)
+{
+    if (m_nodes[node].cutObject < 0)
+        return;
+
+    for (int sharingNode : m_cutObjects[m_nodes[node].cutObject].nodes)
+        markBoundsDirty(sharingNode);
+}
+
+int Scene::getLoadingCutObjectsCount() const
+{
+    return m_loadingCutObjects.size();
+}
+
+int Scene::getFailedCutObjectsCount() const
+{
+    return m_failedCutObjectsCount;
+}
+
+float Scene::getLoadingProgress() const
+{
+    if (m_cutObjects.empty())
+        return 1.0f;
+
+    // the objects that are loaded already count as finished
+    float progress = m_cutObjects.size() - m_loadingCutObjects.size();
+
+    for (int cutObject : m_loadingCutObjects)
+        progress += m_cutObjects[cutObject].loader->getProgress();
+
+    return progress / m_cutObjects.size();
+}
+
+void Scene::update()
+{
+    takeLoadedCutObjects();
+    updateTransforms();
+    updateBounds();
+}
+
+void Scene::prepareToRender(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, int viewportHeight)
+{
+    glm::mat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
+
+    cull(viewProjectionMatrix);
+
+    m_instances.clear();
+    m_batches.clear();
+
+    for (int i : m_visibleCutObjects)
+    {
+        SharedCutObject& cutObject = m_cutObjects[i];
+
+        SceneBatch& batch = m_batches.emplace_back();
+        batch.cutObject = cutObject.cutObject;
+        batch.instances.first = m_instances.size();
+        batch.instances.count = cutObject.visibleNodes.size();
+
+        glm::vec3 boundsCenter = cutObject.cutObject->getBoundsCenter();
+        float boundsRadius = cutObject.cutObject->getBoundsRadius();
+
+        // the level of detail is chosen for the instance nearest to the camera
+        glm::mat4 nearestModelViewMatrix(1.0f);
+        float nearestDistance = 0.0f;
+
+        for (int node : cutObject.visibleNodes)
+        {
+            const Node& visible = m_nodes[node];
+
+            SceneInstance& instance = m_instances.emplace_back();
+            instance.modelMatrix = visible.worldMatrix;
+            instance.modelViewProjectionMatrix = viewProjectionMatrix * visible.worldMatrix;
+            instance.normalMatrix = visible.normalMatrix;
+            instance.materialIndex = visible.material;
+
+            glm::mat4 modelViewMatrix = viewMatrix * visible.worldMatrix;
+            float distance = -(modelViewMatrix * glm::vec4(boundsCenter, 1.0f)).z - boundsRadius * getMaxScale(modelViewMatrix);
+
+            if (node == cutObject.visibleNodes[0] || distance < nearestDistance)
+            {
+                nearestModelViewMatrix = modelViewMatrix;
+                nearestDistance = distance;
+            }
+        }
+
+        cutObject.cutObject->selectLod(nearestModelViewMatrix, projectionMatrix, viewportHeight);
+        cutObject.visibleNodes.clear();
+    }
+
+    m_visibleCutObjects.clear();
+
+    uploadInstances();
+}
+
+const std::vector<SceneBatch>& Scene::getBatches() const
+{
+    return m_batches;
+}
+
+int Scene::addCutObject(std::string_view fullFilePath)
+{
+    for (int i = 0; i < static_cast<int>(m_cutObjects.size()); ++i)
+    {
+        if (m_cutObjects[i].fullFilePath == fullFilePath)
+            return i;
+    }
+
+    int i = m_cutObjects.size();
+
+    // an empty object is shown until the loader hands over the preview
+    SharedCutObject& cutObject = m_cutObjects.emplace_back();
+    cutObject.fullFilePath = fullFilePath;
+    cutObject.cutObject = new ReplicatedCutObject(CutObjectData(), m_resourceManager, m_defaultTexture, m_threadPool);
+    cutObject.cutObject->upload();
+
+    cutObject.loader = new CutObjectLoader(m_resourceManager, m_threadPool);
+    cutObject.loader->load(fullFilePath, m_defaultTexture);
+
+    m_loadingCutObjects.push_back(i);
+
+    return i;
+}
+
+void Scene::takeLoadedCutObjects()
+{
+    for (int i = 0; i < static_cast<int>(m_loadingCutObjects.size());)
+    {
+        SharedCutObject& cutObject = m_cutObjects[m_loadingCutObjects[i]];
+
+        // checked before the object is taken, so the last one handed over is not missed
+        bool isLoading = cutObject.loader->isLoading();
+
+        if (ReplicatedCutObject* loadedCutObject = cutObject.loader->takeCutObject())
+        {
+            loadedCutObject->upload();
+            loadedCutObject->copyAppearance(*cutObject.cutObject);
+
+            delete cutObject.cutObject;
+            cutObject.cutObject = loadedCutObject;
+
+            for (int node : cutObject.nodes)
+                markBoundsDirty(node);
+        }
+
+        if (isLoading)
+        {
+            ++i;
+            continue;
+        }
+
+        if (cutObject.loader->getStage() == Loading_failed)
+            ++m_failedCutObjectsCount;
+
+        delete cutObject.loader;
+        cutObject.loader = nullptr;
+
+        m_loadingCutObjects[i] = m_loadingCutObjects.back();
+        m_loadingCutObjects.pop_back();
+    }
+}
+
+void Scene::markTransformDirty(int node)
+{
+    if (m_nodes[node].isTransformDirty)
+        return;
+
+    m_nodes[node].isTransformDirty = true;
+    m_transformDirtyNodes.push_back(node);
+}
+
+void Scene::markBoundsDirty(int node)
+{
+    // the ancestors of a dirty node are dirty already
+    for (; node >= 0 && !m_nodes[node].isBoundsDirty; node = m_nodes[node].parent)
+    {
+        m_nodes[node].isBoundsDirty = true;
+        m_boundsDirtyNodes.push_back(node);
+    }
+}
+
+void Scene::updateTransforms()
+{
+    if (m_transformDirtyNodes.empty())
+        return;
+
+    // a subtree is updated from its topmost changed node, the changed nodes below it are updated with it
+    std::sort(m_transformDirtyNodes.begin(), m_transformDirtyNodes.end());
+
+    std::vector<int> subtree;
+
+    for (int dirtyNode : m_transformDirtyNodes)
+    {
+        if (!m_nodes[dirtyNode].isTransformDirty)
+            continue;
+
+        subtree.push_back(dirtyNode);
+
+        while (!subtree.empty())
+        {
+            int node = subtree.back();
+            subtree.pop_back();
+
+            Node& updated = m_nodes[node];
+
+            glm::mat4 localMatrix = glm::translate(glm::mat4(1.0f), updated.position);
+            localMatrix = glm::rotate(localMatrix, glm::radians(updated.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+            localMatrix = glm::rotate(localMatrix, glm::radians(updated.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+            localMatrix = glm::rotate(localMatrix, glm::radians(updated.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+            localMatrix = glm::scale(localMatrix, updated.scale);
+
+            updated.worldMatrix = updated.parent < 0 ? localMatrix : m_nodes[updated.parent].worldMatrix * localMatrix;
+            updated.normalMatrix = glm::transpose(glm::inverse(updated.worldMatrix));
+            updated.isTransformDirty = false;
+
+            markBoundsDirty(node);
+
+            subtree.insert(subtree.end(), updated.children.begin(), updated.children.end());
+        }
+    }
+
+    m_transformDirtyNodes.clear();
+}
+
+void Scene::updateBounds()
+{
+    if (m_boundsDirtyNodes.empty())
+        return;
+
+    // children are stored after their parents, so they are merged into the parents in the reversed order
+    std::sort(m_boundsDirtyNodes.begin(), m_boundsDirtyNodes.end(), std::greater<int>());
+
+    for (int node : m_boundsDirtyNodes)
+    {
+        Node& updated = m_nodes[node];
+
+        updated.boundsCenter = glm::vec3(0.0f);
+        updated.boundsRadius = -1.0f;
+
+        if (updated.cutObject >= 0)
+        {
+            const ReplicatedCutObject* cutObject = m_cutObjects[updated.cutObject].cutObject;
+
+            updated.boundsCenter = glm::vec3(updated.worldMatrix * glm::vec4(cutObject->getBoundsCenter(), 1.0f));
+            updated.boundsRadius = cutObject->getBoundsRadius() * getMaxScale(updated.worldMatrix);
+        }
+
+        for (int child : updated.children)
+            mergeSphere(updated.boundsCenter, updated.boundsRadius, m_nodes[child].boundsCenter, m_nodes[child].boundsRadius);
+
+        updated.isBoundsDirty = false;
+    }
+
+    m_boundsDirtyNodes.clear();
+}
+
+void Scene::cull(const glm::mat4& viewProjectionMatrix)
+{
+    // planes of the frustum, the normals point inside
+    glm::vec4 planes[6];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        glm::vec4 row(viewProjectionMatrix[0][i], viewProjectionMatrix[1][i], viewProjectionMatrix[2][i], viewProjectionMatrix[3][i]);
+        glm::vec4 w(viewProjectionMatrix[0][3], viewProjectionMatrix[1][3], viewProjectionMatrix[2][3], viewProjectionMatrix[3][3]);
+
+        planes[2 * i] = w + row;
+        planes[2 * i + 1] = w - row;
+    }
+
+    for (glm::vec4& plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    // a subtree inside the frustum is not tested any more
+    std::vector<std::pair<int, bool>> subtrees;
+
+    for (int root : m_roots)
+        subtrees.emplace_back(root, false);
+
+    while (!subtrees.empty())
+    {
+        auto [node, isInside] = subtrees.back();
+        subtrees.pop_back();
+
+        const Node& tested = m_nodes[node];
+
+        if (tested.boundsRadius < 0.0f)
+            continue;
+
+        if (!isInside)
+        {
+            bool isOutside = false;
+            isInside = true;
+
+            for (const glm::vec4& plane : planes)
+            {
+                float distance = glm::dot(glm::vec3(plane), tested.boundsCenter) + plane.w;
+
+                if (distance < -tested.boundsRadius)
+                {
+                    isOutside = true;
+                    break;
+                }
+
+                if (distance < tested.boundsRadius)
+                    isInside = false;
+            }
+
+            if (isOutside)
+                continue;
+        }
+
+        if (tested.cutObject >= 0)
+        {
+            std::vector<int>& visibleNodes = m_cutObjects[tested.cutObject].visibleNodes;
+
+            if (visibleNodes.empty())
+                m_visibleCutObjects.push_back(tested.cutObject);
+
+            visibleNodes.push_back(node);
+        }
+
+        for (int child : tested.children)
+            subtrees.emplace_back(child, isInside);
+    }
+}
+
+void Scene::uploadInstances()
+{
+    if (m_instances.empty())
+        return;
+
+    // the storage is immutable, so a larger buffer is created when the visible instances do not fit
+    if (static_cast<int>(m_instances.size()) > m_instancesBufferCapacity)
+    {
+        m_instancesBufferCapacity = std::max<int>(m_instances.size(), 2 * m_instancesBufferCapacity);
+
+        GLState::deleteBuffers(1, &m_instancesBufferObject);
+        glCreateBuffers(1, &m_instancesBufferObject);
+        glNamedBufferStorage(m_instancesBufferObject, m_instancesBufferCapacity * sizeof(SceneInstance), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+
+    glNamedBufferSubData(m_instancesBufferObject, 0, m_instances.size() * sizeof(SceneInstance), m_instances.data());
+    GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, instancesBufferBinding, m_instancesBufferObject);
+}
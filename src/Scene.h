@@ -0,0 +1,155 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "CutObjectLoader.h"
+#include "ReplicatedCutObject.h"
+#include "ResourcesManager.h"
+#include "ThreadPool.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// one element of the instance buffer, the std430 layout of ObjectInstance in the shaders.
+// The matrices are computed once per visible object, so the shaders do not rebuild them for every vertex
+struct SceneInstance
+{
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    glm::mat4 modelViewProjectionMatrix = glm::mat4(1.0f);
+    glm::mat4 normalMatrix = glm::mat4(1.0f); // inverse transpose of the model matrix
+    int materialIndex = 0; // in the materials buffer of the resource manager
+    int padding[3]{};
+};
+
+static_assert(sizeof(SceneInstance) == 208, "SceneInstance must match the std430 layout of ObjectInstance!");
+
+// visible instances of one cut object, they are drawn with one instanced call per pass
+struct SceneBatch
+{
+    ReplicatedCutObject* cutObject = nullptr;
+    InstanceRange instances;
+};
+
+// Nodes with a local transform and a material, the nodes made from the same file share one cut object.
+// World matrices and bounding spheres are updated only for the nodes changed since the last frame,
+// and the hierarchy is culled against the view frustum from the roots down, so whole hidden subtrees are skipped
+class Scene
+{
+public:
+    Scene(ResourceManager* resourceManager, ThreadPool* threadPool);
+    ~Scene();
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // nodes read before an error are kept
+    bool load(std::string_view fullFilePath);
+
+    // the parent is added before its children, -1 for a root. A node without a cut object file groups its children,
+    // an empty or unknown material is the first one of the resource manager
+    int addNode(std::string_view name, int parent, std::string_view cutObjectFullFilePath, std::string_view material);
+
+    int getNodesCount() const;
+    const std::string& getNodeName(int node) const;
+    int getNodeDepth(int node) const;
+
+    // rotation in degrees around x, then y, then z
+    void setNodeTransform(int node, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+    glm::vec3 getNodePosition(int node) const;
+    glm::vec3 getNodeRotation(int node) const;
+    glm::vec3 getNodeScale(int node) const;
+
+    // an unknown material leaves the node unchanged
+    void setNodeMaterial(int node, std::string_view material);
+
+    // nullptr for a group node
+    ReplicatedCutObject* getCutObject(int node) const;
+    // the bounds of every node sharing the cut object are updated on the next frame
+    void invalidateCutObjectBounds(int node);
+
+    int getLoadingCutObjectsCount() const;
+    int getFailedCutObjectsCount() const;
+    float getLoadingProgress() const;
+
+    // takes the loaded cut objects and updates the changed nodes, called by the render thread every frame
+    void update();
+
+    // culls the nodes, selects the levels of detail and uploads the instances of the visible nodes grouped by cut object
+    void prepareToRender(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, int viewportHeight);
+    const std::vector<SceneBatch>& getBatches() const;
+
+private:
+    static constexpr GLuint instancesBufferBinding = 3;
+
+    struct Node
+    {
+        std::string name;
+        int parent = -1;
+        std::vector<int> children;
+
+        int cutObject = -1; // index in m_cutObjects, -1 for a group
+        int material = 0;
+
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::vec3 rotation = glm::vec3(0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+
+        glm::mat4 worldMatrix = glm::mat4(1.0f);
+        glm::mat4 normalMatrix = glm::mat4(1.0f); // changes only with the transform
+
+        // world space sphere around the cut object and the whole subtree, the radius is negative when it is empty
+        glm::vec3 boundsCenter = glm::vec3(0.0f);
+        float boundsRadius = -1.0f;
+
+        bool isTransformDirty = false;
+        bool isBoundsDirty = false;
+    };
+
+    struct SharedCutObject
+    {
+        std::string fullFilePath;
+        ReplicatedCutObject* cutObject = nullptr;
+        CutObjectLoader* loader = nullptr; // deleted when the loading is over
+        std::vector<int> nodes;
+        std::vector<int> visibleNodes;
+    };
+
+    int addCutObject(std::string_view fullFilePath);
+    void takeLoadedCutObjects();
+
+    void markTransformDirty(int node);
+    void markBoundsDirty(int node);
+    void updateTransforms();
+    void updateBounds();
+
+    void cull(const glm::mat4& viewProjectionMatrix);
+    void uploadInstances();
+
+    ResourceManager* m_resourceManager = nullptr;
+    ThreadPool* m_threadPool = nullptr;
+
+    std::string m_defaultTexture;
+
+    // parents are stored before their children
+    std::vector<Node> m_nodes;
+    std::vector<int> m_roots;
+    std::vector<int> m_transformDirtyNodes;
+    std::vector<int> m_boundsDirtyNodes;
+
+    std::vector<SharedCutObject> m_cutObjects;
+    std::vector<int> m_loadingCutObjects;
+    int m_failedCutObjectsCount = 0;
+
+    // rebuilt every frame, only the visible part of the scene is visited
+    std::vector<int> m_visibleCutObjects;
+    std::vector<SceneInstance> m_instances;
+    std::vector<SceneBatch> m_batches;
+
+    GLuint m_instancesBufferObject{};
+    int m_instancesBufferCapacity = 0;
+};
+
+#endif
@@ -1,12 +1,43 @@
 #include "ShaderProgram.h"
 
+#include "GLState.h"
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    template<typename T>
+    bool isUniformType(GLenum type)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return type == GL_BOOL;
+        else if constexpr (std::is_same_v<T, int>)
+            return type == GL_INT || type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_CUBE;
+        else if constexpr (std::is_same_v<T, float>)
+            return type == GL_FLOAT;
+        else if constexpr (std::is_same_v<T, glm::vec2>)
+            return type == GL_FLOAT_VEC2;
+        else if constexpr (std::is_same_v<T, glm::vec3>)
+            return type == GL_FLOAT_VEC3;
+        else if constexpr (std::is_same_v<T, glm::vec4>)
+            return type == GL_FLOAT_VEC4;
+        else if constexpr (std::is_same_v<T, glm::mat2>)
+            return type == GL_FLOAT_MAT2;
+        else if constexpr (std::is_same_v<T, glm::mat3>)
+            return type == GL_FLOAT_MAT3;
+        else
+            return type == GL_FLOAT_MAT4;
+    }
+}
 
 ShaderProgram::ShaderProgram(std::string_view vertexShader, std::string_view fragmentShader)
 {
@@ -40,7 +71,10 @@ ShaderProgram::ShaderProgram(std::string_view vertexShader, std::string_view fra
         std::cerr << "ERROR::SHADER: Link time error:\n" << infoLog << std::endl;
     }
     else
+    {
         m_isCompiled = true;
+        reflectUniforms();
+    }
 
     glDeleteShader(vertexShaderID);
     glDeleteShader(fragmentShaderID);
@@ -85,7 +119,10 @@ ShaderProgram::ShaderProgram(std::string_view vertexShader, std::string_view geo
         std::cerr << "ERROR::SHADER: Link time error:\n" << infoLog << std::endl;
     }
     else
+    {
         m_isCompiled = true;
+        reflectUniforms();
+    }
 
     glDeleteShader(vertexShaderID);
     glDeleteShader(geomShaderID);
@@ -125,7 +162,7 @@ bool ShaderProgram::getIsCompiled() const
 
 void ShaderProgram::use() const
 {
-    glUseProgram(m_ID);
+    GLState::useProgram(m_ID);
 }
 
 GLuint ShaderProgram::getID() const
@@ -138,6 +175,7 @@ ShaderProgram& ShaderProgram::operator=(ShaderProgram&& shaderProgram) noexcept
     glDeleteProgram(m_ID);
     m_ID = shaderProgram.m_ID;
     m_isCompiled = shaderProgram.m_isCompiled;
+    m_uniforms = std::move(shaderProgram.m_uniforms);
 
     shaderProgram.m_ID = 0;
     shaderProgram.m_isCompiled = false;
@@ -149,66 +187,205 @@ ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept
 {
     m_ID = shaderProgram.m_ID;
     m_isCompiled = shaderProgram.m_isCompiled;
+    m_uniforms = std::move(shaderProgram.m_uniforms);
 
     shaderProgram.m_ID = 0;
     shaderProgram.m_isCompiled = false;
 }
 
+void ShaderProgram::reflectUniforms()
+{
+    GLint uniformsCount = 0;
+    GLint maxNameLength = 0;
+
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &uniformsCount);
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::string name(maxNameLength, '\0');
+
+    for (GLint i = 0; i < uniformsCount; ++i)
+    {
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+
+        glGetActiveUniform(m_ID, i, maxNameLength, &nameLength, &size, &type, name.data());
+
+        std::string uniformName(name.data(), nameLength);
+        GLint location = glGetUniformLocation(m_ID, uniformName.c_str());
+
+        // members of the uniform blocks have no location
+        if (location < 0)
+            continue;
+
+        // arrays are reported by their first element, members of struct arrays such as
+        // "light[0].position" are reported one by one and are kept as they are
+        bool isArray = uniformName.ends_with("[0]");
+
+        if (!isArray)
+        {
+            m_uniforms.push_back(UniformInfo{ uniformName, location, type });
+            continue;
+        }
+
+        std::string arrayName = uniformName.substr(0, uniformName.size() - 3);
+        m_uniforms.push_back(UniformInfo{ arrayName, location, type });
+
+        for (GLint j = 0; j < size; ++j)
+        {
+            std::string elementName = arrayName + "[" + std::to_string(j) + "]";
+            m_uniforms.push_back(UniformInfo{ elementName, glGetUniformLocation(m_ID, elementName.c_str()), type });
+        }
+    }
+
+    std::sort(m_uniforms.begin(), m_uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) { return a.name < b.name; });
+}
+
+const ShaderProgram::UniformInfo* ShaderProgram::findUniform(std::string_view name) const
+{
+    auto it = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), name, [](const UniformInfo& uniform, std::string_view name) { return uniform.name < name; });
+
+    if (it == m_uniforms.end() || it->name != name)
+        return nullptr;
+
+    return &*it;
+}
+
+template<typename T>
+Uniform<T> ShaderProgram::getUniform(std::string_view name) const
+{
+    const UniformInfo* uniform = findUniform(name);
+
+    if (uniform == nullptr)
+        return Uniform<T>();
+
+    if (!isUniformType<T>(uniform->type))
+    {
+        std::cerr << "Uniform " << name << " has another type!" << std::endl;
+        return Uniform<T>();
+    }
+
+    return Uniform<T>{ uniform->location };
+}
+
+template Uniform<bool> ShaderProgram::getUniform<bool>(std::string_view name) const;
+template Uniform<int> ShaderProgram::getUniform<int>(std::string_view name) const;
+template Uniform<float> ShaderProgram::getUniform<float>(std::string_view name) const;
+template Uniform<glm::vec2> ShaderProgram::getUniform<glm::vec2>(std::string_view name) const;
+template Uniform<glm::vec3> ShaderProgram::getUniform<glm::vec3>(std::string_view name) const;
+template Uniform<glm::vec4> ShaderProgram::getUniform<glm::vec4>(std::string_view name) const;
+template Uniform<glm::mat2> ShaderProgram::getUniform<glm::mat2>(std::string_view name) const;
+template Uniform<glm::mat3> ShaderProgram::getUniform<glm::mat3>(std::string_view name) const;
+template Uniform<glm::mat4> ShaderProgram::getUniform<glm::mat4>(std::string_view name) const;
+
+GLint ShaderProgram::getUniformLocation(std::string_view name) const
+{
+    const UniformInfo* uniform = findUniform(name);
+    return uniform != nullptr ? uniform->location : -1;
+}
+
 // utility uniform functions
  // ------------------------------------------------------------------------
 void ShaderProgram::setBool(std::string_view name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(m_ID, name.data()), static_cast<int>(value));
+    glUniform1i(getUniformLocation(name), static_cast<int>(value));
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setInt(std::string_view name, int value) const
 {
-    glUniform1i(glGetUniformLocation(m_ID, name.data()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setFloat(std::string_view name, float value) const
 {
-    glUniform1f(glGetUniformLocation(m_ID, name.data()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setVec2(std::string_view name, const glm::vec2& value) const
 {
-    glUniform2fv(glGetUniformLocation(m_ID, name.data()), 1, glm::value_ptr(value));
+    glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 void ShaderProgram::setVec2(std::string_view name, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(m_ID, name.data()), x, y);
+    glUniform2f(getUniformLocation(name), x, y);
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setVec3(std::string_view name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(m_ID, name.data()), 1, glm::value_ptr(value));
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 void ShaderProgram::setVec3(std::string_view name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(m_ID, name.data()), x, y, z);
+    glUniform3f(getUniformLocation(name), x, y, z);
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setVec4(std::string_view name, const glm::vec4& value) const
 {
-    glUniform4fv(glGetUniformLocation(m_ID, name.data()), 1, glm::value_ptr(value));
+    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 void ShaderProgram::setVec4(std::string_view name, float x, float y, float z, float w) const
 {
-    glUniform4f(glGetUniformLocation(m_ID, name.data()), x, y, z, w);
+    glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setMat2(std::string_view name, const glm::mat2& mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(m_ID, name.data()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setMat3(std::string_view name, const glm::mat3& mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(m_ID, name.data()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 // ------------------------------------------------------------------------
 void ShaderProgram::setMat4(std::string_view name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_ID, name.data()), 1, GL_FALSE, glm::value_ptr(mat));
-}
\ No newline at end of file
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+// handle based setters
+// ------------------------------------------------------------------------
+void ShaderProgram::setBool(Uniform<bool> uniform, bool value) const
+{
+    glUniform1i(uniform.location, static_cast<int>(value));
+}
+
+void ShaderProgram::setInt(Uniform<int> uniform, int value) const
+{
+    glUniform1i(uniform.location, value);
+}
+
+void ShaderProgram::setFloat(Uniform<float> uniform, float value) const
+{
+    glUniform1f(uniform.location, value);
+}
+
+void ShaderProgram::setVec2(Uniform<glm::vec2> uniform, const glm::vec2& value) const
+{
+    glUniform2fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec3(Uniform<glm::vec3> uniform, const glm::vec3& value) const
+{
+    glUniform3fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec4(Uniform<glm::vec4> uniform, const glm::vec4& value) const
+{
+    glUniform4fv(uniform.location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setMat2(Uniform<glm::mat2> uniform, const glm::mat2& mat) const
+{
+    glUniformMatrix2fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void ShaderProgram::setMat3(Uniform<glm::mat3> uniform, const glm::mat3& mat) const
+{
+    glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void ShaderProgram::setMat4(Uniform<glm::mat4> uniform, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+}
@@ -6,6 +6,14 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
+
+// Location of an active uniform of type T, a uniform the program does not use keeps -1 and setting it does nothing
+template<typename T>
+struct Uniform
+{
+    GLint location = -1;
+};
 
 class ShaderProgram
 {
@@ -24,6 +32,12 @@ public:
     void use() const;
     GLuint getID() const;
 
+    // uniforms are reflected once when the program is linked, the lookups do not call OpenGL;
+    // a uniform of another type is reported and its handle is left empty
+    template<typename T>
+    Uniform<T> getUniform(std::string_view name) const;
+    GLint getUniformLocation(std::string_view name) const;
+
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(std::string_view name, bool value) const;
@@ -47,11 +61,35 @@ public:
     // ------------------------------------------------------------------------
     void setMat4(std::string_view name, const glm::mat4& mat) const;
 
+    // handle based setters for the hot paths
+    // ------------------------------------------------------------------------
+    void setBool(Uniform<bool> uniform, bool value) const;
+    void setInt(Uniform<int> uniform, int value) const;
+    void setFloat(Uniform<float> uniform, float value) const;
+    void setVec2(Uniform<glm::vec2> uniform, const glm::vec2& value) const;
+    void setVec3(Uniform<glm::vec3> uniform, const glm::vec3& value) const;
+    void setVec4(Uniform<glm::vec4> uniform, const glm::vec4& value) const;
+    void setMat2(Uniform<glm::mat2> uniform, const glm::mat2& mat) const;
+    void setMat3(Uniform<glm::mat3> uniform, const glm::mat3& mat) const;
+    void setMat4(Uniform<glm::mat4> uniform, const glm::mat4& mat) const;
+
 private:
+    struct UniformInfo
+    {
+        std::string name;
+        GLint location = -1;
+        GLenum type = 0;
+    };
+
     bool createShader(std::string_view source, const GLenum shaderType, GLuint& shaderID) const;
+    void reflectUniforms();
+    const UniformInfo* findUniform(std::string_view name) const;
 
     bool m_isCompiled = false;
     GLuint m_ID = 0;
+
+    // sorted by name, array elements are stored one by one and the array name is the first element
+    std::vector<UniformInfo> m_uniforms;
 };
 
 #endif
\ No newline at end of file
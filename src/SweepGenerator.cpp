@@ -0,0 +1,1447 @@
+#include "SweepGenerator.h"
+
+#include "ThreadPool.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+void SweepGenerator::setThreadPool(ThreadPool* threadPool)
+{
+    m_threadPool = threadPool;
+}
+
+ThreadPool* SweepGenerator::getThreadPool() const
+{
+    return m_threadPool;
+}
+
+void SweepGenerator::setFrameMode(FrameModes frameMode)
+{
+    m_frameMode = frameMode;
+}
+
+FrameModes SweepGenerator::getFrameMode() const
+{
+    return m_frameMode;
+}
+
+void SweepGenerator::setReferenceXAxes(std::vector<glm::vec3> xAxes)
+{
+    m_referenceXAxes = std::move(xAxes);
+}
+
+std::vector<glm::vec3> SweepGenerator::getFrameXAxes() const
+{
+    std::vector<glm::vec3> xAxes(m_frames.size);
+
+    for (int i = 0; i < m_frames.size; ++i)
+        xAxes[i] = m_frames.getXAxis(i);
+
+    return xAxes;
+}
+
+bool SweepGenerator::isValidInput(const SweepInput& input)
+{
+    if (input.cut == nullptr || input.cutSize < 3)
+    {
+        std::cerr << "Sweep cut must contain at least 3 points!" << std::endl;
+        return false;
+    }
+
+    if (input.trajectory == nullptr || input.trajectorySize < 3)
+    {
+        std::cerr << "Sweep trajectory must contain at least 3 points!" << std::endl;
+        return false;
+    }
+
+    if (input.cutParameters == nullptr || input.cutParametersSize < input.trajectorySize)
+    {
+        std::cerr << "Sweep cut parameters amount is less than trajectory points amount!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int SweepGenerator::getTrajectoryCutsSize(int cutSize, int trajectorySize)
+{
+    return (cutSize + 2) * trajectorySize;
+}
+
+int SweepGenerator::getReplicatedCutSize(int cutSize, int trajectorySize)
+{
+    return (trajectorySize - 1) * cutSize * 2 * 3 + getCapSize(cutSize) * 2;
+}
+
+int SweepGenerator::getIndexedSmoothVerticesSize(int cutSize, int trajectorySize)
+{
+    return getTrajectoryCutsSize(cutSize, trajectorySize) + getIndexedSmoothCapSize(cutSize) * 2;
+}
+
+int SweepGenerator::getIndexedFlatVerticesSize(int cutSize, int trajectorySize)
+{
+    return trajectorySize * (cutSize + 1) * flatVertexSlotsSize + getIndexedFlatCapSize(cutSize) * 2;
+}
+
+int SweepGenerator::getCapSize(int cutSize)
+{
+    return cutSize * 3;
+}
+
+int SweepGenerator::getIndexedSmoothCapSize(int cutSize)
+{
+    // only the rim, the cap triangles take the center of the end ring
+    return cutSize;
+}
+
+int SweepGenerator::getIndexedFlatCapSize(int cutSize)
+{
+    return cutSize + 1;
+}
+
+void SweepGenerator::generateTrajectoryCuts(const SweepInput& input, glm::vec3* translatedCut)
+{
+    prepareRings(input);
+
+    parallelFor(0, input.trajectorySize, input.cutSize, [&](int begin, int end)
+    {
+        generateRings(input, translatedCut, begin, end);
+    });
+}
+
+void SweepGenerator::prepareRings(const SweepInput& input)
+{
+    calcOriginTranslatedCut(input);
+    calcFrames(input);
+
+    m_profile.assign(m_originTranslatedCut.data(), input.cutSize);
+}
+
+bool SweepGenerator::updateTrajectoryCuts(const SweepInput& input, glm::vec3* translatedCut, SweepRange& changedRange, bool isTrajectoryChanged)
+{
+    int trajectorySize = input.trajectorySize;
+
+    if (m_frames.size != trajectorySize || m_profile.size != input.cutSize)
+        return false;
+
+    int begin = std::max(changedRange.begin, 0);
+    int end = std::min(changedRange.end, trajectorySize);
+
+    if (begin >= end)
+    {
+        changedRange = SweepRange();
+        return true;
+    }
+
+    int framesBegin = begin;
+    int framesEnd = end;
+
+    if (!isTrajectoryChanged)
+    {
+        for (int i = begin; i < end; ++i)
+            m_frames.scale[i] = input.cutParameters[i];
+    }
+    else
+    {
+        // a frame depends on the neighbouring points, zero length segments carry directions further
+        framesBegin = std::max(begin - 2, 0);
+        framesEnd = std::min(end + 2, trajectorySize);
+
+        while (framesBegin > 0 && glm::length(input.trajectory[framesBegin] - input.trajectory[framesBegin - 1]) <= 1e-6f)
+            --framesBegin;
+        while (framesEnd < trajectorySize && glm::length(input.trajectory[framesEnd] - input.trajectory[framesEnd - 1]) <= 1e-6f)
+            ++framesEnd;
+
+        if (m_frameMode == Legacy_frames)
+        {
+            if (!updateLegacyFrames(input, begin, framesBegin, framesEnd))
+                return false;
+        }
+        else
+        {
+            if (!updateRotationMinimizingFrames(input, begin, framesBegin, framesEnd))
+                return false;
+        }
+    }
+
+    generateRings(input, translatedCut, framesBegin, framesEnd);
+
+    changedRange = SweepRange{ framesBegin, framesEnd };
+    return true;
+}
+
+void SweepGenerator::generateRings(const SweepInput& input, glm::vec3* translatedCut, int begin, int end) const
+{
+    int cutSize = input.cutSize;
+    int firstRingIndex = (begin - m_firstStoredRing) * (cutSize + 2);
+
+    ProfileTransform::transform(m_profile, m_frames, begin, end, translatedCut + firstRingIndex + 1, cutSize + 2);
+
+    for (int i = begin; i < end; ++i)
+    {
+        int ringIndex = (i - m_firstStoredRing) * (cutSize + 2);
+
+        translatedCut[ringIndex] = m_frameCenters[i];
+        translatedCut[ringIndex + cutSize + 1] = translatedCut[ringIndex + 1];
+    }
+}
+
+void SweepGenerator::calcFrames(const SweepInput& input)
+{
+    int trajectorySize = input.trajectorySize;
+
+    // an edit spreads its rotation minimizing twist over the frames around it, so a new pass would turn every cut
+    // after the edit; the frames of an unchanged trajectory are kept instead
+    if (m_frameMode == Rotation_minimizing_frames && m_isRotationMinimizingFrames && m_referenceXAxes.empty() && isFramesTrajectory(input))
+    {
+        for (int i = 0; i < trajectorySize; ++i)
+            m_frames.scale[i] = input.cutParameters[i];
+
+        return;
+    }
+
+    m_isRotationMinimizingFrames = m_frameMode == Rotation_minimizing_frames;
+
+    m_frames.resize(trajectorySize);
+    m_frameCenters.resize(trajectorySize);
+    m_frameHandedness.assign(trajectorySize, 1.0f);
+
+    if (m_frameMode == Legacy_frames)
+        calcLegacyFrames(input);
+    else
+        calcRotationMinimizingFrames(input);
+}
+
+bool SweepGenerator::isFramesTrajectory(const SweepInput& input) const
+{
+    return m_frames.size == input.trajectorySize && std::equal(m_frameCenters.begin(), m_frameCenters.end(), input.trajectory);
+}
+
+void SweepGenerator::calcLegacyFrames(const SweepInput& input)
+{
+    int trajectorySize = input.trajectorySize;
+
+    m_isChangeVectorOrientation.assign(trajectorySize, false);
+    calcVectorsOrientationInTrajectory(input, 1, trajectorySize - 1);
+
+    // frames depend on the previous ones, so they are calculated sequentially
+    glm::mat3 rotate{};
+
+    for (int i = 0; i < trajectorySize; ++i)
+    {
+        rotate = calcLegacyFrame(input, i, rotate);
+        setLegacyFrame(input, i, rotate);
+    }
+}
+
+bool SweepGenerator::updateLegacyFrames(const SweepInput& input, int changedBegin, int framesBegin, int& framesEnd)
+{
+    int trajectorySize = input.trajectorySize;
+
+    // the first frame sets the y axis of every frame and the first point shifts every cut,
+    // the window reaches it over zero length segments too
+    if (changedBegin <= 2 || framesBegin == 0)
+        return false;
+
+    calcVectorsOrientationInTrajectory(input, std::max(framesBegin, 1), std::min(framesEnd, trajectorySize - 1));
+
+    glm::mat3 rotate = getFrameRotation(framesBegin - 1);
+
+    // frames after the window only change when a degenerate frame carries the previous rotation
+    for (int i = framesBegin; i < trajectorySize; ++i)
+    {
+        rotate = calcLegacyFrame(input, i, rotate);
+
+        if (i >= framesEnd && rotate[0] == m_frames.getXAxis(i) && rotate[1] == m_frames.getYAxis(i))
+            break;
+
+        setLegacyFrame(input, i, rotate);
+        framesEnd = std::max(framesEnd, i + 1);
+    }
+
+    return true;
+}
+
+glm::mat3 SweepGenerator::calcLegacyFrame(const SweepInput& input, int i, const glm::mat3& prevRotate)
+{
+    const glm::vec3* trajectory = input.trajectory;
+    int trajectorySize = input.trajectorySize;
+
+    glm::vec3& y = m_legacyY;
+
+    glm::vec3 p1{}, p2{}, p3{};
+    glm::vec3 x{}, z{};
+
+    if (i == 0)
+    {
+        p1 = trajectory[0];
+        p2 = trajectory[1];
+        p3 = trajectory[2];
+
+        glm::vec3 a = p2 - p1;
+        glm::vec3 b = p3 - p2;
+
+        if (std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6))
+        {
+            z = glm::normalize(a);
+            y = glm::vec3(0.0f, 1.0f, 0.0f);
+            x = glm::normalize(glm::cross(z, y));
+            y = glm::normalize(glm::cross(x, z));
+        }
+        else
+        {
+            z = glm::normalize(a);
+            y = glm::normalize(glm::cross(a, b));
+            x = glm::normalize(glm::cross(z, y));
+
+            glm::vec3 nextX = glm::normalize(-a) + glm::normalize(b);
+            if (m_isChangeVectorOrientation[i + 1]) nextX = -nextX;
+
+            float angle1 = glm::acos(glm::dot(x, nextX));
+            float angle2 = glm::acos(glm::dot(-x, nextX));
+
+            if (angle2 < angle1) x = -x;
+        }
+    }
+    else if (i == trajectorySize - 1)
+    {
+        p1 = trajectory[i - 2];
+        p2 = trajectory[i - 1];
+        p3 = trajectory[i];
+
+        glm::vec3 a = p2 - p1;
+        glm::vec3 b = p3 - p2;
+
+        if (!(std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6)))
+        {
+            z = glm::normalize(b);
+            x = glm::normalize(glm::cross(z, y));
+
+            glm::vec3 prevX = glm::normalize(-a) + glm::normalize(b);
+            if (m_isChangeVectorOrientation[i - 1]) prevX = -prevX;
+
+            float angle1 = glm::acos(glm::dot(x, prevX));
+            float angle2 = glm::acos(glm::dot(-x, prevX));
+
+            if (angle2 < angle1) x = -x;
+        }
+    }
+    else
+    {
+        p1 = trajectory[i - 1];
+        p2 = trajectory[i];
+        p3 = trajectory[i + 1];
+
+        glm::vec3 a = glm::normalize(p1 - p2);
+        glm::vec3 b = glm::normalize(p3 - p2);
+
+        if (!(std::abs(1.0 - std::abs(glm::dot(glm::normalize(a), glm::normalize(b))) <= 1e-6)))
+        {
+            x = glm::normalize(a + b);
+            z = glm::normalize(glm::cross(x, y));
+
+            if (m_isChangeVectorOrientation[i]) x = -x;
+        }
+    }
+
+    if (glm::length(x) > 1e-6 && glm::length(y) > 1e-6 && glm::length(z) > 1e-6)
+        return glm::mat3(x, y, z);
+
+    return prevRotate;
+}
+
+void SweepGenerator::setLegacyFrame(const SweepInput& input, int i, const glm::mat3& rotate)
+{
+    const glm::vec3* trajectory = input.trajectory;
+    int trajectorySize = input.trajectorySize;
+
+    // every cut except the first one is shifted by the first trajectory point
+    glm::vec3 translate = i == 0 ? trajectory[0] : trajectory[i] - trajectory[0];
+
+    m_frames.set(i, rotate, translate, input.cutParameters[i]);
+    m_frameCenters[i] = trajectory[i];
+
+    // legacy frames can be mirrored or face against the trajectory, which flips the profile winding
+    glm::vec3 direction = i < trajectorySize - 1 ? trajectory[i + 1] - trajectory[i] : trajectory[i] - trajectory[i - 1];
+    m_frameHandedness[i] = glm::dot(glm::cross(rotate[0], rotate[1]), direction) < 0.0f ? -1.0f : 1.0f;
+}
+
+glm::mat3 SweepGenerator::getFrameRotation(int i) const
+{
+    glm::vec3 x = m_frames.getXAxis(i);
+    glm::vec3 y = m_frames.getYAxis(i);
+
+    // the third axis never reaches the cuts, only the handedness is kept separately
+    return glm::mat3(x, y, glm::cross(x, y));
+}
+
+glm::vec3 SweepGenerator::getSegmentDirection(const SweepInput& input, int i) const
+{
+    const glm::vec3* trajectory = input.trajectory;
+
+    // a zero length segment takes the previous direction, leading ones take the first direction
+    for (int k = i; k >= 0; --k)
+    {
+        glm::vec3 segment = trajectory[k + 1] - trajectory[k];
+
+        if (glm::length(segment) > 1e-6f)
+            return glm::normalize(segment);
+    }
+
+    for (int k = i + 1; k < input.trajectorySize - 1; ++k)
+    {
+        glm::vec3 segment = trajectory[k + 1] - trajectory[k];
+
+        if (glm::length(segment) > 1e-6f)
+            return glm::normalize(segment);
+    }
+
+    return glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+void SweepGenerator::calcTrajectoryTangents(const SweepInput& input, int begin, int end)
+{
+    int trajectorySize = input.trajectorySize;
+
+    m_trajectoryTangents.resize(trajectorySize);
+
+    for (int i = begin; i < end; ++i)
+    {
+        if (i == 0)
+            m_trajectoryTangents[i] = getSegmentDirection(input, 0);
+        else if (i == trajectorySize - 1)
+            m_trajectoryTangents[i] = getSegmentDirection(input, trajectorySize - 2);
+        else
+        {
+            // inner cuts lie in the bisector plane of the adjacent segments like the legacy ones
+            glm::vec3 prevDirection = getSegmentDirection(input, i - 1);
+            glm::vec3 direction = getSegmentDirection(input, i);
+            glm::vec3 tangent = prevDirection + direction;
+
+            m_trajectoryTangents[i] = glm::length(tangent) > 1e-6f ? glm::normalize(tangent) : direction;
+        }
+    }
+}
+
+void SweepGenerator::calcRotationMinimizingFrames(const SweepInput& input)
+{
+    const glm::vec3* trajectory = input.trajectory;
+    int trajectorySize = input.trajectorySize;
+
+    calcTrajectoryTangents(input, 0, trajectorySize);
+
+    // the first reference axis is the binormal of the first bend, or the world up axis for a straight start
+    glm::vec3 tangent = m_trajectoryTangents[0];
+    glm::vec3 y(0.0f, 1.0f, 0.0f);
+
+    m_referenceBendIndex = trajectorySize;
+
+    for (int i = 1; i < trajectorySize - 1; ++i)
+    {
+        glm::vec3 binormal = glm::cross(trajectory[i] - trajectory[i - 1], trajectory[i + 1] - trajectory[i]);
+
+        if (glm::length(binormal) > 1e-6f)
+        {
+            y = glm::normalize(binormal);
+            m_referenceBendIndex = i;
+            break;
+        }
+    }
+
+    if (std::abs(glm::dot(y, tangent)) > 1.0f - 1e-3f)
+        y = std::abs(tangent.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    glm::vec3 x = glm::normalize(glm::cross(y, tangent));
+    bool isReferenced = static_cast<int>(m_referenceXAxes.size()) == trajectorySize;
+
+    for (int i = 0; i < trajectorySize; ++i)
+    {
+        if (i > 0)
+            x = calcRotationMinimizingX(input, i, x);
+
+        // the reference axis is moved into the normal plane, a degenerate one keeps the carried axis
+        if (isReferenced)
+        {
+            glm::vec3 reference = m_referenceXAxes[i] - glm::dot(m_referenceXAxes[i], m_trajectoryTangents[i]) * m_trajectoryTangents[i];
+
+            if (glm::length(reference) > 1e-6f)
+                x = glm::normalize(reference);
+        }
+
+        setRotationMinimizingFrame(input, i, x);
+    }
+}
+
+bool SweepGenerator::updateRotationMinimizingFrames(const SweepInput& input, int changedBegin, int framesBegin, int framesEnd)
+{
+    int trajectorySize = input.trajectorySize;
+
+    // the first frame follows the first bend, moving anything up to it turns every frame.
+    // A window from the first frame has no previous frame to continue
+    if (changedBegin - 1 <= m_referenceBendIndex || framesBegin == 0)
+        return false;
+
+    calcTrajectoryTangents(input, framesBegin, framesEnd);
+
+    int framesSize = framesEnd - framesBegin;
+    m_updatedFrameAxes.resize(framesSize);
+
+    glm::vec3 x = m_frames.getXAxis(framesBegin - 1);
+
+    for (int i = framesBegin; i < framesEnd; ++i)
+    {
+        x = calcRotationMinimizingX(input, i, x);
+        m_updatedFrameAxes[i - framesBegin] = x;
+    }
+
+    // the window ends with a twist against the unchanged frames, it is spread over the window
+    // instead of turning every following frame
+    if (framesEnd < trajectorySize)
+    {
+        glm::vec3 nextX = calcRotationMinimizingX(input, framesEnd, x);
+        glm::vec3 storedX = m_frames.getXAxis(framesEnd);
+        glm::vec3 tangent = m_trajectoryTangents[framesEnd];
+
+        float twist = std::atan2(glm::dot(glm::cross(nextX, storedX), tangent), glm::dot(nextX, storedX));
+
+        for (int k = 0; k < framesSize; ++k)
+        {
+            float angle = twist * (k + 1) / (framesSize + 1);
+            glm::vec3 frameTangent = m_trajectoryTangents[framesBegin + k];
+            glm::vec3& frameX = m_updatedFrameAxes[k];
+
+            frameX = glm::normalize(frameX * std::cos(angle) + glm::cross(frameTangent, frameX) * std::sin(angle));
+        }
+    }
+
+    for (int i = framesBegin; i < framesEnd; ++i)
+        setRotationMinimizingFrame(input, i, m_updatedFrameAxes[i - framesBegin]);
+
+    return true;
+}
+
+glm::vec3 SweepGenerator::calcRotationMinimizingX(const SweepInput& input, int i, const glm::vec3& prevX) const
+{
+    const glm::vec3* trajectory = input.trajectory;
+
+    glm::vec3 tangent = m_trajectoryTangents[i - 1];
+    glm::vec3 nextTangent = m_trajectoryTangents[i];
+    glm::vec3 x = prevX;
+
+    // double reflection method (Wang et al. 2008)
+    glm::vec3 v1 = trajectory[i] - trajectory[i - 1];
+    float c1 = glm::dot(v1, v1);
+
+    if (c1 > 1e-12f)
+    {
+        glm::vec3 reflectedX = x - (2.0f / c1) * glm::dot(v1, x) * v1;
+        glm::vec3 reflectedTangent = tangent - (2.0f / c1) * glm::dot(v1, tangent) * v1;
+
+        glm::vec3 v2 = nextTangent - reflectedTangent;
+        float c2 = glm::dot(v2, v2);
+
+        x = c2 > 1e-12f ? reflectedX - (2.0f / c2) * glm::dot(v2, reflectedX) * v2 : reflectedX;
+    }
+
+    // keeps rounding errors from accumulating over long trajectories
+    x = x - glm::dot(x, nextTangent) * nextTangent;
+    if (glm::length(x) > 1e-6f)
+        x = glm::normalize(x);
+
+    return x;
+}
+
+void SweepGenerator::setRotationMinimizingFrame(const SweepInput& input, int i, const glm::vec3& x)
+{
+    glm::vec3 tangent = m_trajectoryTangents[i];
+    glm::vec3 y = glm::cross(tangent, x);
+
+    m_frames.set(i, glm::mat3(x, y, tangent), input.trajectory[i], input.cutParameters[i]);
+    m_frameCenters[i] = input.trajectory[i];
+}
+
+void SweepGenerator::generateReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output)
+{
+    calcOriginTranslatedCut(input);
+    calcQuadNormals(input, translatedCut);
+    calcRingVertexNormals(input);
+
+    generateSurface(input, translatedCut, output);
+    generateCaps(input, translatedCut, translatedCut + (input.trajectorySize - 1) * (input.cutSize + 2), output);
+    generateSmoothedNormals(input, output);
+}
+
+void SweepGenerator::generateSurface(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output) const
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    parallelFor(0, cutNum - 1, cutSize, [&](int begin, int end)
+    {
+        generateSurfaceRange(input, translatedCut, output, begin, end);
+    });
+}
+
+void SweepGenerator::generateSurfaceRange(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output, int begin, int end) const
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+
+    int repCutIndex = (begin - m_firstOutputQuad) * cutSize * 6;
+
+    for (int i = begin; i < end; ++i)
+    {
+        float orientation = m_profileOrientation * getFrameHandedness(i);
+
+        float x1 = ((cutNum - 1 + i) % (cutNum - 1)) / static_cast<float>(cutNum - 1);
+        float x2 = ((cutNum - 1 + i + 1) % (cutNum - 1)) / static_cast<float>(cutNum - 1);
+
+        if (i == cutNum - 2)
+            x2 = 1.0f;
+
+        for (int j = 1; j < pointsInCutNum - 1; ++j)
+        {
+            int currentCutIndex = (i - m_firstStoredRing) * pointsInCutNum + j;
+            int nextCutIndex = currentCutIndex + pointsInCutNum;
+
+            glm::vec3 point1 = translatedCut[currentCutIndex];
+            glm::vec3 point2 = translatedCut[currentCutIndex + 1];
+            glm::vec3 point3 = translatedCut[nextCutIndex];
+            glm::vec3 point4 = translatedCut[nextCutIndex + 1];
+
+            output.positions[repCutIndex] = point1;
+            output.positions[repCutIndex + 1] = point2;
+            output.positions[repCutIndex + 2] = point3;
+            output.positions[repCutIndex + 3] = point2;
+            output.positions[repCutIndex + 4] = point3;
+            output.positions[repCutIndex + 5] = point4;
+
+            float y1 = ((cutSize + j - 1) % cutSize) / static_cast<float>(cutSize);
+            float y2 = ((cutSize + j) % cutSize) / static_cast<float>(cutSize);
+
+            if (j == pointsInCutNum - 2)
+                y2 = 1.0f;
+
+            glm::vec2 texCoord1(x1, y1);
+            glm::vec2 texCoord2(x1, y2);
+            glm::vec2 texCoord3(x2, y1);
+            glm::vec2 texCoord4(x2, y2);
+
+            output.textureCoords[repCutIndex] = texCoord1;
+            output.textureCoords[repCutIndex + 1] = texCoord2;
+            output.textureCoords[repCutIndex + 2] = texCoord3;
+            output.textureCoords[repCutIndex + 3] = texCoord2;
+            output.textureCoords[repCutIndex + 4] = texCoord3;
+            output.textureCoords[repCutIndex + 5] = texCoord4;
+
+            glm::vec3 normal2first = glm::cross(point1 - point2, point3 - point2);
+            glm::vec3 normal2second = glm::cross(point3 - point2, point4 - point2);
+            glm::vec3 normal3first = glm::cross(point1 - point3, point2 - point3);
+            glm::vec3 normal3second = glm::cross(point2 - point3, point4 - point3);
+
+            glm::vec3 normal1 = glm::cross(point2 - point1, point3 - point1);
+            glm::vec3 normal2 = (normal2first + normal2second) / 2.0f;
+            glm::vec3 normal3 = (normal3first + normal3second) / 2.0f;
+            glm::vec3 normal4 = glm::cross(point2 - point4, point3 - point4);
+
+            // normals are flipped to the inner side here, the output takes them negated
+            if (orientation > 0)
+            {
+                normal1 = -normal1;
+                normal2 = -normal2;
+                normal3 = -normal3;
+                normal4 = -normal4;
+            }
+
+            output.normals[repCutIndex] = -normal1;
+            output.normals[repCutIndex + 1] = normal2;
+            output.normals[repCutIndex + 2] = -normal3;
+            output.normals[repCutIndex + 3] = normal2;
+            output.normals[repCutIndex + 4] = -normal3;
+            output.normals[repCutIndex + 5] = normal4;
+
+            repCutIndex += 6;
+        }
+    }
+}
+
+void SweepGenerator::generateCaps(const SweepInput& input, const glm::vec3* startRing, const glm::vec3* endRing, const SweepOutput& output)
+{
+    int cutSize = input.cutSize;
+    int trajectorySize = input.trajectorySize;
+
+    int repCutIndex = (trajectorySize - 1 - m_firstOutputQuad) * cutSize * 6;
+
+    calcCapsTextureCoords(input);
+
+    glm::vec3 center0 = startRing[0];
+    glm::vec3 normal = input.trajectory[0] - input.trajectory[1];
+
+    for (int i = 1; i < cutSize + 1; ++i)
+    {
+        output.positions[repCutIndex] = center0;
+        output.positions[repCutIndex + 1] = startRing[i];
+        output.positions[repCutIndex + 2] = startRing[i + 1];
+
+        glm::vec2 translateVec(0.5, 0.5);
+
+        output.textureCoords[repCutIndex] = glm::vec2(0, 0) + translateVec;
+        output.textureCoords[repCutIndex + 1] = m_originTranslatedNormalizedCut[i - 1] + translateVec;
+        output.textureCoords[repCutIndex + 2] = m_originTranslatedNormalizedCut[i == cutSize ? 0 : i] + translateVec;
+
+        output.normals[repCutIndex] = normal;
+        output.normals[repCutIndex + 1] = normal;
+        output.normals[repCutIndex + 2] = normal;
+
+        repCutIndex += 3;
+    }
+
+    glm::vec3 center1 = endRing[0];
+    normal = input.trajectory[trajectorySize - 1] - input.trajectory[trajectorySize - 2];
+
+    for (int i = 0; i < cutSize; ++i)
+    {
+        output.positions[repCutIndex] = center1;
+        output.positions[repCutIndex + 1] = endRing[i + 1];
+        output.positions[repCutIndex + 2] = endRing[i + 2];
+
+        glm::vec2 translateVec(0.5, 0.5);
+
+        output.textureCoords[repCutIndex] = glm::vec2(0, 0) + translateVec;
+        output.textureCoords[repCutIndex + 1] = m_originTranslatedNormalizedCut[i] + translateVec;
+        output.textureCoords[repCutIndex + 2] = m_originTranslatedNormalizedCut[i == cutSize - 1 ? 0 : i + 1] + translateVec;
+
+        output.normals[repCutIndex] = normal;
+        output.normals[repCutIndex + 1] = normal;
+        output.normals[repCutIndex + 2] = normal;
+
+        repCutIndex += 3;
+    }
+}
+
+void SweepGenerator::generateSmoothedNormals(const SweepInput& input, const SweepOutput& output) const
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    parallelFor(0, cutNum - 1, cutSize, [&](int begin, int end)
+    {
+        generateSmoothedNormalsRange(input, output, begin, end);
+    });
+
+    generateCapsSmoothedNormals(input, m_ringVertexNormals.data(), m_ringVertexNormals.data() + (cutNum - 1) * cutSize, output);
+}
+
+void SweepGenerator::generateCapsSmoothedNormals(const SweepInput& input, const glm::vec3* startRingNormals, const glm::vec3* endRingNormals, const SweepOutput& output) const
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    // cap centers keep the cap normal, rims share the boundary ring vertex normals
+    int startCutIndex = (cutNum - 1 - m_firstOutputQuad) * cutSize * 6;
+    int endCutIndex = startCutIndex + cutSize * 3;
+
+    glm::vec3 startNormal = glm::normalize(output.normals[startCutIndex]);
+    glm::vec3 endNormal = glm::normalize(output.normals[endCutIndex]);
+
+    for (int j = 0; j < cutSize; ++j)
+    {
+        int nextj = j == cutSize - 1 ? 0 : j + 1;
+
+        output.smoothedNormals[startCutIndex + 3 * j] = startNormal;
+        output.smoothedNormals[startCutIndex + 3 * j + 1] = startRingNormals[j];
+        output.smoothedNormals[startCutIndex + 3 * j + 2] = startRingNormals[nextj];
+
+        output.smoothedNormals[endCutIndex + 3 * j] = endNormal;
+        output.smoothedNormals[endCutIndex + 3 * j + 1] = endRingNormals[j];
+        output.smoothedNormals[endCutIndex + 3 * j + 2] = endRingNormals[nextj];
+    }
+}
+
+void SweepGenerator::generateSmoothedNormalsRange(const SweepInput& input, const SweepOutput& output, int begin, int end) const
+{
+    int cutSize = input.cutSize;
+
+    for (int i = begin; i < end; ++i)
+    {
+        int rectIndex = (i - m_firstOutputQuad) * cutSize * 6;
+        int ringIndex = (i - m_firstStoredRing) * cutSize;
+        int nextRingIndex = ringIndex + cutSize;
+
+        for (int j = 0; j < cutSize; ++j)
+        {
+            int nextj = j == cutSize - 1 ? 0 : j + 1;
+
+            glm::vec3 smoothedNormal1 = m_ringVertexNormals[ringIndex + j];
+            glm::vec3 smoothedNormal2 = m_ringVertexNormals[ringIndex + nextj];
+            glm::vec3 smoothedNormal3 = m_ringVertexNormals[nextRingIndex + j];
+            glm::vec3 smoothedNormal4 = m_ringVertexNormals[nextRingIndex + nextj];
+
+            output.smoothedNormals[rectIndex] = smoothedNormal1;
+            output.smoothedNormals[rectIndex + 1] = smoothedNormal2;
+            output.smoothedNormals[rectIndex + 2] = smoothedNormal3;
+            output.smoothedNormals[rectIndex + 3] = smoothedNormal2;
+            output.smoothedNormals[rectIndex + 4] = smoothedNormal3;
+            output.smoothedNormals[rectIndex + 5] = smoothedNormal4;
+
+            rectIndex += 6;
+        }
+    }
+}
+
+void SweepGenerator::generateIndexedSmoothReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex)
+{
+    calcOriginTranslatedCut(input);
+    calcCapsTextureCoords(input);
+    calcQuadNormals(input, translatedCut);
+    calcRingVertexNormals(input);
+
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+    int translatedCutSize = getTrajectoryCutsSize(cutSize, cutNum);
+
+    parallelFor(0, cutNum, cutSize, [&](int begin, int end)
+    {
+        generateIndexedSmoothRings(input, translatedCut, output, begin, end);
+    });
+
+    generateIndexedSmoothRims(input, translatedCut, output);
+
+    int startRimIndex = translatedCutSize;
+    int endRimIndex = translatedCutSize + cutSize;
+    int endRingIndex = (cutNum - 1) * pointsInCutNum;
+
+    parallelFor(0, cutNum - 1, cutSize, [&](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            int index = i * cutSize * 6;
+
+            for (int j = 1; j < pointsInCutNum - 1; ++j)
+            {
+                unsigned int currentCutIndex = baseVertex + i * pointsInCutNum + j;
+                unsigned int nextCutIndex = baseVertex + (i + 1) * pointsInCutNum + j;
+
+                output.indices[index] = currentCutIndex;
+                output.indices[index + 1] = currentCutIndex + 1;
+                output.indices[index + 2] = nextCutIndex;
+                output.indices[index + 3] = currentCutIndex + 1;
+                output.indices[index + 4] = nextCutIndex;
+                output.indices[index + 5] = nextCutIndex + 1;
+
+                index += 6;
+            }
+        }
+    });
+
+    int index = (cutNum - 1) * cutSize * 6;
+
+    for (int j = 0; j < cutSize; ++j)
+    {
+        int nextj = j == cutSize - 1 ? 0 : j + 1;
+
+        output.indices[index] = baseVertex;
+        output.indices[index + 1] = baseVertex + startRimIndex + j;
+        output.indices[index + 2] = baseVertex + startRimIndex + nextj;
+
+        index += 3;
+    }
+
+    for (int j = 0; j < cutSize; ++j)
+    {
+        int nextj = j == cutSize - 1 ? 0 : j + 1;
+
+        output.indices[index] = baseVertex + endRingIndex;
+        output.indices[index + 1] = baseVertex + endRimIndex + j;
+        output.indices[index + 2] = baseVertex + endRimIndex + nextj;
+
+        index += 3;
+    }
+}
+
+void SweepGenerator::generateIndexedSmoothRings(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, int begin, int end) const
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+
+    for (int i = begin; i < end; ++i)
+    {
+        int ringIndex = i * pointsInCutNum;
+
+        for (int j = 0; j < cutSize; ++j)
+            output.normals[ringIndex + j + 1] = m_ringVertexNormals[i * cutSize + j];
+
+        output.normals[ringIndex + cutSize + 1] = output.normals[ringIndex + 1];
+
+        for (int k = 0; k < pointsInCutNum; ++k)
+        {
+            output.positions[ringIndex + k] = translatedCut[ringIndex + k];
+            output.textureCoords[ringIndex + k] = getSurfaceTextureCoord(input, i, k);
+        }
+
+        // ring centers are only used by the caps
+        if (i == 0)
+            output.normals[ringIndex] = glm::normalize(input.trajectory[0] - input.trajectory[1]);
+        else if (i == cutNum - 1)
+            output.normals[ringIndex] = glm::normalize(input.trajectory[cutNum - 1] - input.trajectory[cutNum - 2]);
+        else
+            output.normals[ringIndex] = glm::vec3(0.0f);
+
+        if (i == 0 || i == cutNum - 1)
+            output.textureCoords[ringIndex] = glm::vec2(0.5f, 0.5f);
+    }
+}
+
+void SweepGenerator::generateIndexedSmoothRims(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output) const
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+    int translatedCutSize = getTrajectoryCutsSize(cutSize, cutNum);
+
+    // caps share the ring centers, rims are split because of the different texture coordinates
+    int startRimIndex = translatedCutSize;
+    int endRimIndex = translatedCutSize + cutSize;
+    int endRingIndex = (cutNum - 1) * pointsInCutNum;
+
+    for (int j = 0; j < cutSize; ++j)
+    {
+        output.positions[startRimIndex + j] = translatedCut[j + 1];
+        output.normals[startRimIndex + j] = output.normals[j + 1];
+        output.textureCoords[startRimIndex + j] = m_originTranslatedNormalizedCut[j] + glm::vec2(0.5f, 0.5f);
+
+        output.positions[endRimIndex + j] = translatedCut[endRingIndex + j + 1];
+        output.normals[endRimIndex + j] = output.normals[endRingIndex + j + 1];
+        output.textureCoords[endRimIndex + j] = m_originTranslatedNormalizedCut[j] + glm::vec2(0.5f, 0.5f);
+    }
+}
+
+void SweepGenerator::updateReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output, const SweepRange& changedRings, SweepRange& surfaceVertices, SweepRange& capsVertices)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    // quads next to the changed rings change their shape, their neighbours only the smoothed normals
+    SweepRange quads{ std::max(changedRings.begin - 1, 0), std::min(changedRings.end, cutNum - 1) };
+    SweepRange normalRings{ std::max(changedRings.begin - 1, 0), std::min(changedRings.end + 1, cutNum) };
+    SweepRange smoothedQuads{ std::max(normalRings.begin - 1, 0), std::min(normalRings.end, cutNum - 1) };
+
+    calcQuadNormalsRange(input, translatedCut, quads.begin, quads.end);
+    calcRingVertexNormalsRange(input, normalRings.begin, normalRings.end);
+
+    generateSurfaceRange(input, translatedCut, output, quads.begin, quads.end);
+    generateSmoothedNormalsRange(input, output, smoothedQuads.begin, smoothedQuads.end);
+
+    surfaceVertices = SweepRange{ smoothedQuads.begin * cutSize * 6, smoothedQuads.end * cutSize * 6 };
+    capsVertices = SweepRange();
+
+    if (normalRings.begin == 0 || normalRings.end == cutNum)
+    {
+        generateCaps(input, translatedCut, translatedCut + (cutNum - 1) * (cutSize + 2), output);
+        generateCapsSmoothedNormals(input, m_ringVertexNormals.data(), m_ringVertexNormals.data() + (cutNum - 1) * cutSize, output);
+
+        capsVertices = SweepRange{ (cutNum - 1) * cutSize * 6, getReplicatedCutSize(cutSize, cutNum) };
+    }
+}
+
+void SweepGenerator::updateIndexedSmoothReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, const SweepRange& changedRings, SweepRange& ringVertices, SweepRange& rimVertices)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+    int translatedCutSize = getTrajectoryCutsSize(cutSize, cutNum);
+
+    SweepRange quads{ std::max(changedRings.begin - 1, 0), std::min(changedRings.end, cutNum - 1) };
+    SweepRange normalRings{ std::max(changedRings.begin - 1, 0), std::min(changedRings.end + 1, cutNum) };
+
+    calcQuadNormalsRange(input, translatedCut, quads.begin, quads.end);
+    calcRingVertexNormalsRange(input, normalRings.begin, normalRings.end);
+
+    generateIndexedSmoothRings(input, translatedCut, output, normalRings.begin, normalRings.end);
+
+    ringVertices = SweepRange{ normalRings.begin * (cutSize + 2), normalRings.end * (cutSize + 2) };
+    rimVertices = SweepRange();
+
+    if (normalRings.begin == 0 || normalRings.end == cutNum)
+    {
+        generateIndexedSmoothRims(input, translatedCut, output);
+
+        rimVertices = SweepRange{ translatedCutSize, translatedCutSize + cutSize * 2 };
+    }
+}
+
+void SweepGenerator::prepareChunks(const SweepInput& input)
+{
+    prepareRings(input);
+
+    m_profileOrientation = calcProfileOrientation(input);
+}
+
+void SweepGenerator::generateTrajectoryCutsChunk(const SweepInput& input, const SweepRange& rings, glm::vec3* translatedCut)
+{
+    m_firstStoredRing = rings.begin;
+
+    parallelFor(rings.begin, rings.end, input.cutSize, [&](int begin, int end)
+    {
+        generateRings(input, translatedCut, begin, end);
+    });
+
+    m_firstStoredRing = 0;
+}
+
+void SweepGenerator::generateReplicatedCutChunk(const SweepInput& input, const SweepRange& quads, const SweepOutput& output)
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+
+    // the boundary ring vertex normals of the chunk also need the quads just outside of it
+    SweepRange rings{ std::max(quads.begin - 1, 0), std::min(quads.end + 2, cutNum) };
+    int ringsSize = rings.end - rings.begin;
+
+    m_firstStoredRing = rings.begin;
+    m_firstOutputQuad = quads.begin;
+
+    m_chunkTranslatedCut.resize(ringsSize * pointsInCutNum);
+    m_quadNormals.resize((ringsSize - 1) * cutSize);
+    m_ringVertexNormals.resize(ringsSize * cutSize);
+
+    glm::vec3* translatedCut = m_chunkTranslatedCut.data();
+
+    parallelFor(rings.begin, rings.end, cutSize, [&](int begin, int end)
+    {
+        generateRings(input, translatedCut, begin, end);
+    });
+
+    parallelFor(rings.begin, rings.end - 1, cutSize, [&](int begin, int end)
+    {
+        calcQuadNormalsRange(input, translatedCut, begin, end);
+    });
+
+    parallelFor(quads.begin, quads.end + 1, cutSize, [&](int begin, int end)
+    {
+        calcRingVertexNormalsRange(input, begin, end);
+    });
+
+    parallelFor(quads.begin, quads.end, cutSize, [&](int begin, int end)
+    {
+        generateSurfaceRange(input, translatedCut, output, begin, end);
+        generateSmoothedNormalsRange(input, output, begin, end);
+    });
+
+    // the caps are written after the last chunk, the start ring is kept until then
+    if (quads.begin == 0)
+    {
+        m_startRing.assign(translatedCut, translatedCut + pointsInCutNum);
+        m_startRingNormals.assign(m_ringVertexNormals.begin(), m_ringVertexNormals.begin() + cutSize);
+    }
+
+    if (quads.end == cutNum - 1)
+    {
+        int endRing = cutNum - 1 - rings.begin;
+
+        generateCaps(input, m_startRing.data(), translatedCut + endRing * pointsInCutNum, output);
+        generateCapsSmoothedNormals(input, m_startRingNormals.data(), m_ringVertexNormals.data() + endRing * cutSize, output);
+    }
+
+    m_firstStoredRing = 0;
+    m_firstOutputQuad = 0;
+}
+
+void SweepGenerator::getProceduralFrames(const SweepInput& input, const SweepRange& rings, SweepFrame* frames) const
+{
+    float profileOrientation = calcProfileOrientation(input);
+
+    for (int i = rings.begin; i < rings.end; ++i)
+    {
+        SweepFrame& frame = frames[i - rings.begin];
+
+        frame.xAxis = m_frames.getXAxis(i);
+        frame.yAxis = m_frames.getYAxis(i);
+        frame.translation = glm::vec3(m_frames.translation[0][i], m_frames.translation[1][i], m_frames.translation[2][i]);
+        frame.center = m_frameCenters[i];
+        frame.scale = m_frames.scale[i];
+        frame.orientation = profileOrientation * getFrameHandedness(i);
+    }
+}
+
+void SweepGenerator::getProceduralProfile(const SweepInput& input, glm::vec4* profile)
+{
+    calcCapsTextureCoords(input);
+
+    for (int i = 0; i < input.cutSize; ++i)
+        profile[i] = glm::vec4(m_originTranslatedCut[i], m_originTranslatedNormalizedCut[i] + glm::vec2(0.5f, 0.5f));
+}
+
+void SweepGenerator::generateIndexedFlatReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex)
+{
+    calcOriginTranslatedCut(input);
+    calcCapsTextureCoords(input);
+    calcQuadNormals(input, translatedCut);
+
+    int cutNum = input.trajectorySize;
+
+    m_flatVertexSlotsUsed.assign(cutNum * (input.cutSize + 1), 0);
+
+    parallelFor(0, cutNum, input.cutSize, [&](int begin, int end)
+    {
+        clearIndexedFlatRings(input, translatedCut, output, begin, end);
+    });
+
+    generateIndexedFlatQuads(input, output, baseVertex, 0, cutNum - 1);
+    generateIndexedFlatCaps(input, translatedCut, output, baseVertex);
+}
+
+void SweepGenerator::updateIndexedFlatReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, const SweepRange& changedRings, unsigned int baseVertex,
+                                                    SweepRange& ringVertices, SweepRange& capsVertices, SweepRange& quadIndices)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+    int ringVerticesSize = (cutSize + 1) * flatVertexSlotsSize;
+
+    // the quads around the changed rings get new normals, so every ring they touch is welded again. The quads around
+    // those rings are visited again in the order of the full generation, the rings next to them keep their welds
+    SweepRange weldedRings{ std::max(changedRings.begin - 1, 0), std::min(changedRings.end + 1, cutNum) };
+    SweepRange quads{ std::max(weldedRings.begin - 1, 0), std::min(weldedRings.end, cutNum - 1) };
+
+    calcQuadNormalsRange(input, translatedCut, quads.begin, quads.end);
+
+    clearIndexedFlatRings(input, translatedCut, output, weldedRings.begin, weldedRings.end);
+    generateIndexedFlatQuads(input, output, baseVertex, quads.begin, quads.end);
+
+    ringVertices = SweepRange{ weldedRings.begin * ringVerticesSize, weldedRings.end * ringVerticesSize };
+    quadIndices = SweepRange{ quads.begin * cutSize * 6, quads.end * cutSize * 6 };
+    capsVertices = SweepRange();
+
+    // the caps follow the end rings and the direction of the end segments
+    if (weldedRings.begin == 0 || weldedRings.end == cutNum)
+    {
+        generateIndexedFlatCaps(input, translatedCut, output, baseVertex);
+
+        capsVertices = SweepRange{ cutNum * ringVerticesSize, cutNum * ringVerticesSize + (cutSize + 1) * 2 };
+    }
+}
+
+void SweepGenerator::clearIndexedFlatRings(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, int begin, int end)
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+
+    // unused slots repeat the ring point, so they do not widen the packed chunk bounds
+    for (int i = begin; i < end; ++i)
+    {
+        for (int k = 1; k < pointsInCutNum; ++k)
+        {
+            int ringPoint = i * (cutSize + 1) + k - 1;
+            glm::vec2 textureCoord = getSurfaceTextureCoord(input, i, k);
+
+            for (int slot = 0; slot < flatVertexSlotsSize; ++slot)
+            {
+                int vertex = ringPoint * flatVertexSlotsSize + slot;
+
+                output.positions[vertex] = translatedCut[i * pointsInCutNum + k];
+                output.normals[vertex] = glm::vec3(0.0f);
+                output.textureCoords[vertex] = textureCoord;
+            }
+
+            m_flatVertexSlotsUsed[ringPoint] = 0;
+        }
+    }
+}
+
+void SweepGenerator::generateIndexedFlatQuads(const SweepInput& input, const SweepIndexedOutput& output, unsigned int baseVertex, int begin, int end)
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+
+    auto getVertex = [&](int i, int k, const glm::vec3& normal)
+    {
+        int ringPoint = i * (cutSize + 1) + k - 1;
+        int firstVertex = ringPoint * flatVertexSlotsSize;
+        int& slotsUsed = m_flatVertexSlotsUsed[ringPoint];
+
+        // equal normals are also matched, so the zero normals of degenerate quads share a vertex too
+        for (int slot = 0; slot < slotsUsed; ++slot)
+        {
+            glm::vec3 slotNormal = output.normals[firstVertex + slot];
+
+            if (slotNormal == normal || glm::dot(slotNormal, normal) > 1.0f - 1e-6f)
+                return firstVertex + slot;
+        }
+
+        // only invalid normals, which match nothing, can use up the slots
+        if (slotsUsed == flatVertexSlotsSize)
+            return firstVertex + slotsUsed - 1;
+
+        int vertex = firstVertex + slotsUsed++;
+        output.normals[vertex] = normal;
+
+        return vertex;
+    };
+
+    for (int i = begin; i < end; ++i)
+    {
+        int index = i * cutSize * 6;
+
+        for (int j = 1; j < pointsInCutNum - 1; ++j)
+        {
+            glm::vec3 normal = m_quadNormals[i * cutSize + j - 1];
+            if (glm::length(normal) > 0.0f)
+                normal = glm::normalize(normal);
+
+            unsigned int vertex1 = baseVertex + getVertex(i, j, normal);
+            unsigned int vertex2 = baseVertex + getVertex(i, j + 1, normal);
+            unsigned int vertex3 = baseVertex + getVertex(i + 1, j, normal);
+            unsigned int vertex4 = baseVertex + getVertex(i + 1, j + 1, normal);
+
+            output.indices[index] = vertex1;
+            output.indices[index + 1] = vertex2;
+            output.indices[index + 2] = vertex3;
+            output.indices[index + 3] = vertex2;
+            output.indices[index + 4] = vertex3;
+            output.indices[index + 5] = vertex4;
+
+            index += 6;
+        }
+    }
+}
+
+void SweepGenerator::generateIndexedFlatCaps(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex) const
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+    int cutNum = input.trajectorySize;
+
+    int verticesSize = cutNum * (cutSize + 1) * flatVertexSlotsSize;
+    int index = (cutNum - 1) * cutSize * 6;
+
+    for (int cap = 0; cap < 2; ++cap)
+    {
+        int ringIndex = cap == 0 ? 0 : (cutNum - 1) * pointsInCutNum;
+        glm::vec3 normal = cap == 0 ?
+            glm::normalize(input.trajectory[0] - input.trajectory[1]) :
+            glm::normalize(input.trajectory[cutNum - 1] - input.trajectory[cutNum - 2]);
+
+        int centerIndex = verticesSize;
+
+        output.positions[centerIndex] = translatedCut[ringIndex];
+        output.normals[centerIndex] = normal;
+        output.textureCoords[centerIndex] = glm::vec2(0.5f, 0.5f);
+
+        for (int j = 0; j < cutSize; ++j)
+        {
+            output.positions[centerIndex + j + 1] = translatedCut[ringIndex + j + 1];
+            output.normals[centerIndex + j + 1] = normal;
+            output.textureCoords[centerIndex + j + 1] = m_originTranslatedNormalizedCut[j] + glm::vec2(0.5f, 0.5f);
+        }
+
+        for (int j = 0; j < cutSize; ++j)
+        {
+            int nextj = j == cutSize - 1 ? 0 : j + 1;
+
+            output.indices[index] = baseVertex + centerIndex;
+            output.indices[index + 1] = baseVertex + centerIndex + j + 1;
+            output.indices[index + 2] = baseVertex + centerIndex + nextj + 1;
+
+            index += 3;
+        }
+
+        verticesSize += cutSize + 1;
+    }
+}
+
+void SweepGenerator::calcQuadNormals(const SweepInput& input, const glm::vec3* translatedCut)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    m_quadNormals.resize((cutNum - 1) * cutSize);
+    m_profileOrientation = calcProfileOrientation(input);
+
+    parallelFor(0, cutNum - 1, cutSize, [&](int begin, int end)
+    {
+        calcQuadNormalsRange(input, translatedCut, begin, end);
+    });
+}
+
+void SweepGenerator::calcQuadNormalsRange(const SweepInput& input, const glm::vec3* translatedCut, int begin, int end)
+{
+    int cutSize = input.cutSize;
+    int pointsInCutNum = cutSize + 2;
+
+    for (int i = begin; i < end; ++i)
+    {
+        // the outward side only depends on the profile winding and the frame handedness
+        float orientation = m_profileOrientation * getFrameHandedness(i);
+
+        for (int j = 1; j < pointsInCutNum - 1; ++j)
+        {
+            int currentCutIndex = (i - m_firstStoredRing) * pointsInCutNum + j;
+            int nextCutIndex = currentCutIndex + pointsInCutNum;
+
+            glm::vec3 point1 = translatedCut[currentCutIndex];
+            glm::vec3 point2 = translatedCut[currentCutIndex + 1];
+            glm::vec3 point3 = translatedCut[nextCutIndex];
+            glm::vec3 point4 = translatedCut[nextCutIndex + 1];
+
+            // half of the diagonals cross product is the quad vector area
+            m_quadNormals[(i - m_firstStoredRing) * cutSize + j - 1] = orientation * 0.5f * glm::cross(point4 - point1, point3 - point2);
+        }
+    }
+}
+
+void SweepGenerator::calcRingVertexNormals(const SweepInput& input)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    m_ringVertexNormals.resize(cutNum * cutSize);
+
+    parallelFor(0, cutNum, cutSize, [&](int begin, int end)
+    {
+        calcRingVertexNormalsRange(input, begin, end);
+    });
+}
+
+void SweepGenerator::calcRingVertexNormalsRange(const SweepInput& input, int begin, int end)
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    glm::vec3 startNormal = glm::normalize(input.trajectory[0] - input.trajectory[1]);
+    glm::vec3 endNormal = glm::normalize(input.trajectory[cutNum - 1] - input.trajectory[cutNum - 2]);
+
+    for (int i = begin; i < end; ++i)
+    {
+        int quadIndex = (i - m_firstStoredRing) * cutSize;
+        int prevQuadIndex = quadIndex - cutSize;
+
+        for (int j = 0; j < cutSize; ++j)
+        {
+            int prevj = j == 0 ? cutSize - 1 : j - 1;
+
+            glm::vec3 normal{};
+
+            if (i > 0)
+                normal += m_quadNormals[prevQuadIndex + prevj] + m_quadNormals[prevQuadIndex + j];
+
+            if (i < cutNum - 1)
+                normal += m_quadNormals[quadIndex + prevj] + m_quadNormals[quadIndex + j];
+
+            if (glm::length(normal) > 0.0f)
+                normal = glm::normalize(normal);
+
+            // boundary rings are shared with the caps and lean halfway towards them
+            if (i == 0)
+                normal = glm::normalize(normal + startNormal);
+            else if (i == cutNum - 1)
+                normal = glm::normalize(normal + endNormal);
+
+            m_ringVertexNormals[quadIndex + j] = normal;
+        }
+    }
+}
+
+float SweepGenerator::calcProfileOrientation(const SweepInput& input) const
+{
+    float doubledArea = 0.0f;
+
+    for (int i = 0; i < input.cutSize; ++i)
+    {
+        const glm::vec2& point = input.cut[i];
+        const glm::vec2& nextPoint = input.cut[i == input.cutSize - 1 ? 0 : i + 1];
+
+        doubledArea += point.x * nextPoint.y - nextPoint.x * point.y;
+    }
+
+    return doubledArea < 0.0f ? -1.0f : 1.0f;
+}
+
+float SweepGenerator::getFrameHandedness(int i) const
+{
+    return i < static_cast<int>(m_frameHandedness.size()) ? m_frameHandedness[i] : 1.0f;
+}
+
+void SweepGenerator::calcCapsTextureCoords(const SweepInput& input)
+{
+    int cutSize = input.cutSize;
+
+    float maxLength = 0;
+    for (int i = 0; i < cutSize; ++i)
+    {
+        float length = glm::length(m_originTranslatedCut[i]);
+
+        if (length > maxLength)
+            maxLength = length;
+    }
+
+    m_originTranslatedNormalizedCut.resize(cutSize);
+    for (int i = 0; i < cutSize; ++i)
+        m_originTranslatedNormalizedCut[i] = m_originTranslatedCut[i] * 0.5f / maxLength;
+}
+
+glm::vec2 SweepGenerator::getSurfaceTextureCoord(const SweepInput& input, int i, int k) const
+{
+    int cutSize = input.cutSize;
+    int cutNum = input.trajectorySize;
+
+    float x = i == cutNum - 1 ? 1.0f : i / static_cast<float>(cutNum - 1);
+    float y = k == cutSize + 1 ? 1.0f : (k - 1) / static_cast<float>(cutSize);
+
+    return glm::vec2(x, y);
+}
+
+void SweepGenerator::parallelFor(int begin, int end, int cutSize, const std::function<void(int, int)>& task) const
+{
+    if (m_threadPool == nullptr)
+    {
+        task(begin, end);
+        return;
+    }
+
+    // every range should have enough profile points to be worth a task
+    int minRangeSize = std::max(1, parallelMinPointsInRange / std::max(cutSize, 1));
+    m_threadPool->parallelFor(begin, end, task, minRangeSize);
+}
+
+void SweepGenerator::calcOriginTranslatedCut(const SweepInput& input)
+{
+    int cutSize = input.cutSize;
+
+    m_originTranslatedCut.resize(cutSize);
+
+    glm::vec3 cutCenter{};
+    for (int i = 0; i < cutSize; ++i)
+        cutCenter += glm::vec3(input.cut[i], 0.0f);
+    cutCenter /= cutSize;
+
+    glm::mat4 tran = glm::translate(glm::mat4(1.0f), -cutCenter);
+    for (int i = 0; i < cutSize; ++i)
+    {
+        m_originTranslatedCut[i] = glm::vec2(tran * glm::vec4(input.cut[i], 0.0f, 1.0f));
+    }
+}
+
+void SweepGenerator::calcVectorsOrientationInTrajectory(const SweepInput& input, int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        glm::vec3 p1 = input.trajectory[i - 1];
+        glm::vec3 p2 = input.trajectory[i];
+        glm::vec3 p3 = input.trajectory[i + 1];
+
+        glm::vec3 a = p2 - p1;
+        glm::vec3 b = p3 - p2;
+
+        float product = a.x * b.y - a.y * b.x;
+
+        m_isChangeVectorOrientation[i] = product > 0 ? true : false;
+    }
+}
\ No newline at end of file
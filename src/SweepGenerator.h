@@ -0,0 +1,235 @@
+#ifndef SWEEP_GENERATOR_H
+#define SWEEP_GENERATOR_H
+
+#include "Enums.h"
+#include "ProfileTransform.h"
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+struct SweepInput
+{
+    const glm::vec2* cut = nullptr;
+    int cutSize = 0;
+
+    const glm::vec3* trajectory = nullptr;
+    int trajectorySize = 0;
+
+    const float* cutParameters = nullptr;
+    int cutParametersSize = 0;
+};
+
+// View over caller-provided storage, stride allows writing into interleaved vertices
+template<typename T>
+struct SweepAttribute
+{
+    SweepAttribute() = default;
+    SweepAttribute(T* data, int stride = sizeof(T)) : data(data), stride(stride) {}
+
+    T& operator[](int index) const
+    {
+        return *reinterpret_cast<T*>(reinterpret_cast<char*>(data) + static_cast<size_t>(index) * stride);
+    }
+
+    T* data = nullptr;
+    int stride = sizeof(T);
+};
+
+// Caller-provided storage, every attribute must hold getReplicatedCutSize() elements
+struct SweepOutput
+{
+    SweepAttribute<glm::vec3> positions;
+    SweepAttribute<glm::vec3> normals;
+    SweepAttribute<glm::vec3> smoothedNormals;
+    SweepAttribute<glm::vec2> textureCoords;
+};
+
+// Indexed surface storage, vertices are shared between quads
+struct SweepIndexedOutput
+{
+    SweepAttribute<glm::vec3> positions;
+    SweepAttribute<glm::vec3> normals;
+    SweepAttribute<glm::vec2> textureCoords;
+    unsigned int* indices = nullptr;
+};
+
+// Half-open range of trajectory points, rings or vertices
+struct SweepRange
+{
+    int begin = 0;
+    int end = 0;
+};
+
+// Frame of one ring as the procedural vertex shader reads it, point j of the ring is
+// translation + scale * (profile[j].x * xAxis + profile[j].y * yAxis) for the centered profile
+struct SweepFrame
+{
+    glm::vec3 xAxis{};
+    float scale = 0.0f;
+    glm::vec3 yAxis{};
+    float orientation = 1.0f; // the sign that turns the quad normals of the ring outwards
+    glm::vec3 translation{};
+    float translationPadding = 0.0f;
+    glm::vec3 center{};
+    float centerPadding = 0.0f;
+};
+
+static_assert(sizeof(SweepFrame) == 64, "SweepFrame must match the std430 layout of SweepFrame in the shaders!");
+
+class SweepGenerator
+{
+public:
+    // with a thread pool every ring range is generated in parallel, the output is the same as without it
+    void setThreadPool(ThreadPool* threadPool);
+    ThreadPool* getThreadPool() const;
+
+    // legacy frames keep the old bisector orientation, rotation minimizing ones do not twist on 3D trajectories
+    void setFrameMode(FrameModes frameMode);
+    FrameModes getFrameMode() const;
+
+    // rotation minimizing frames of the next generations turn their x axes towards these, one for every trajectory point,
+    // instead of carrying the first axis along the trajectory; an empty vector goes back to the carried axes
+    void setReferenceXAxes(std::vector<glm::vec3> xAxes);
+    std::vector<glm::vec3> getFrameXAxes() const;
+
+    static bool isValidInput(const SweepInput& input);
+
+    // ring layout: center, cutSize profile points, first profile point repeated
+    static int getTrajectoryCutsSize(int cutSize, int trajectorySize);
+    static int getReplicatedCutSize(int cutSize, int trajectorySize);
+
+    // smooth vertices reuse the ring layout and add split caps, flat vertices keep flatVertexSlotsSize slots for every ring
+    // point after the center, so a ring is welded again in place, and then the caps
+    static int getIndexedSmoothVerticesSize(int cutSize, int trajectorySize);
+    static int getIndexedFlatVerticesSize(int cutSize, int trajectorySize);
+
+    // every layout ends with the start cap and then the end cap, each of this many vertices
+    static int getCapSize(int cutSize);
+    static int getIndexedSmoothCapSize(int cutSize);
+    static int getIndexedFlatCapSize(int cutSize);
+
+    void generateTrajectoryCuts(const SweepInput& input, glm::vec3* translatedCut);
+    void generateReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output);
+
+    // both write getReplicatedCutSize() indices
+    void generateIndexedSmoothReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex = 0);
+    void generateIndexedFlatReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex = 0);
+
+    // after trajectory points or cut parameters in changedRange are edited only the frames and rings around them are
+    // calculated again, changedRange is replaced by the changed rings, false means everything has to be generated again
+    bool updateTrajectoryCuts(const SweepInput& input, glm::vec3* translatedCut, SweepRange& changedRange, bool isTrajectoryChanged);
+
+    // rewrite the vertices touched by the changed rings and return their ranges, caps ranges are empty when they stay the same
+    void updateReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output, const SweepRange& changedRings, SweepRange& surfaceVertices, SweepRange& capsVertices);
+    void updateIndexedSmoothReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, const SweepRange& changedRings, SweepRange& ringVertices, SweepRange& rimVertices);
+    // the flat surface is welded again only around the changed rings, the ranges are relative to the output
+    void updateIndexedFlatReplicatedCut(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, const SweepRange& changedRings, unsigned int baseVertex,
+                                        SweepRange& ringVertices, SweepRange& capsVertices, SweepRange& quadIndices);
+
+    // streaming: the frames are calculated for the whole trajectory once, then the rings and the surface are generated
+    // in chunks into storage sized for the chunk, the full generation functions are not needed
+    void prepareChunks(const SweepInput& input);
+
+    // writes the rings of the range from the start of translatedCut
+    void generateTrajectoryCutsChunk(const SweepInput& input, const SweepRange& rings, glm::vec3* translatedCut);
+
+    // writes the vertices of the quads range from the start of the output, the rings on both sides of the chunk are
+    // generated again so that its smoothed normals match the neighbouring chunks; the last chunk is followed by the caps,
+    // its output holds cutSize * 6 more vertices, and the first chunk has to be generated before it
+    void generateReplicatedCutChunk(const SweepInput& input, const SweepRange& quads, const SweepOutput& output);
+
+    // procedural rendering keeps only the frames and the profile, both are valid once the rings are generated or the chunks
+    // are prepared; a profile point holds the centered position and then the cap texture coordinate
+    void getProceduralFrames(const SweepInput& input, const SweepRange& rings, SweepFrame* frames) const;
+    void getProceduralProfile(const SweepInput& input, glm::vec4* profile);
+
+private:
+    static constexpr int parallelMinPointsInRange = 4096;
+    // a ring point is touched by 4 quads at most, so it is split into 4 flat vertices at most
+    static constexpr int flatVertexSlotsSize = 4;
+
+    void parallelFor(int begin, int end, int cutSize, const std::function<void(int, int)>& task) const;
+
+    void calcOriginTranslatedCut(const SweepInput& input);
+    void prepareRings(const SweepInput& input);
+    void calcVectorsOrientationInTrajectory(const SweepInput& input, int begin, int end);
+    void generateRings(const SweepInput& input, glm::vec3* translatedCut, int begin, int end) const;
+
+    void calcFrames(const SweepInput& input);
+    bool isFramesTrajectory(const SweepInput& input) const;
+    glm::mat3 getFrameRotation(int i) const;
+
+    void calcLegacyFrames(const SweepInput& input);
+    bool updateLegacyFrames(const SweepInput& input, int changedBegin, int framesBegin, int& framesEnd);
+    glm::mat3 calcLegacyFrame(const SweepInput& input, int i, const glm::mat3& prevRotate);
+    void setLegacyFrame(const SweepInput& input, int i, const glm::mat3& rotate);
+
+    void calcRotationMinimizingFrames(const SweepInput& input);
+    bool updateRotationMinimizingFrames(const SweepInput& input, int changedBegin, int framesBegin, int framesEnd);
+    glm::vec3 calcRotationMinimizingX(const SweepInput& input, int i, const glm::vec3& prevX) const;
+    void setRotationMinimizingFrame(const SweepInput& input, int i, const glm::vec3& x);
+
+    glm::vec3 getSegmentDirection(const SweepInput& input, int i) const;
+    void calcTrajectoryTangents(const SweepInput& input, int begin, int end);
+
+    void generateSurface(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output) const;
+    void generateSurfaceRange(const SweepInput& input, const glm::vec3* translatedCut, const SweepOutput& output, int begin, int end) const;
+    void generateCaps(const SweepInput& input, const glm::vec3* startRing, const glm::vec3* endRing, const SweepOutput& output);
+    void generateSmoothedNormals(const SweepInput& input, const SweepOutput& output) const;
+    void generateSmoothedNormalsRange(const SweepInput& input, const SweepOutput& output, int begin, int end) const;
+    void generateCapsSmoothedNormals(const SweepInput& input, const glm::vec3* startRingNormals, const glm::vec3* endRingNormals, const SweepOutput& output) const;
+
+    void generateIndexedSmoothRings(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, int begin, int end) const;
+    void generateIndexedSmoothRims(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output) const;
+
+    // the welds of a ring point depend on the order of the quads around it, so the quads are always visited in order
+    void clearIndexedFlatRings(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, int begin, int end);
+    void generateIndexedFlatQuads(const SweepInput& input, const SweepIndexedOutput& output, unsigned int baseVertex, int begin, int end);
+    void generateIndexedFlatCaps(const SweepInput& input, const glm::vec3* translatedCut, const SweepIndexedOutput& output, unsigned int baseVertex) const;
+
+    // quad normals are outward and scaled by the quad area, ring vertex normals are their normalized sums
+    void calcQuadNormals(const SweepInput& input, const glm::vec3* translatedCut);
+    void calcQuadNormalsRange(const SweepInput& input, const glm::vec3* translatedCut, int begin, int end);
+    void calcRingVertexNormals(const SweepInput& input);
+    void calcRingVertexNormalsRange(const SweepInput& input, int begin, int end);
+    float calcProfileOrientation(const SweepInput& input) const;
+    float getFrameHandedness(int i) const;
+    void calcCapsTextureCoords(const SweepInput& input);
+    glm::vec2 getSurfaceTextureCoord(const SweepInput& input, int i, int k) const;
+
+    std::vector<glm::vec2> m_originTranslatedCut;
+    std::vector<glm::vec2> m_originTranslatedNormalizedCut;
+    std::vector<bool> m_isChangeVectorOrientation;
+
+    ProfileSoA m_profile;
+    FramesSoA m_frames;
+    std::vector<glm::vec3> m_frameCenters;
+    std::vector<glm::vec3> m_trajectoryTangents;
+    std::vector<float> m_frameHandedness;
+    std::vector<glm::vec3> m_updatedFrameAxes;
+    std::vector<glm::vec3> m_referenceXAxes;
+    bool m_isRotationMinimizingFrames = false;
+    glm::vec3 m_legacyY{};
+    int m_referenceBendIndex = 0;
+
+    std::vector<glm::vec3> m_quadNormals;
+    std::vector<glm::vec3> m_ringVertexNormals;
+    float m_profileOrientation = 1.0f;
+    std::vector<int> m_flatVertexSlotsUsed; // for every ring point after the center
+
+    // ring sized storage starts at m_firstStoredRing and the output at m_firstOutputQuad, both are 0 unless a chunk is generated
+    int m_firstStoredRing = 0;
+    int m_firstOutputQuad = 0;
+    std::vector<glm::vec3> m_chunkTranslatedCut;
+    std::vector<glm::vec3> m_startRing;
+    std::vector<glm::vec3> m_startRingNormals;
+
+    ThreadPool* m_threadPool = nullptr;
+    FrameModes m_frameMode = Rotation_minimizing_frames;
+};
+
+#endif
@@ -0,0 +1,201 @@
+#include "SweepLod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr int maxSpanSize = 4096;
+
+    float calcChordDistance(const glm::vec3& point, const glm::vec3& chordBegin, const glm::vec3& chordEnd, float& t)
+    {
+        glm::vec3 chord = chordEnd - chordBegin;
+        float chordLength2 = glm::dot(chord, chord);
+
+        t = chordLength2 > 0.0f ? std::clamp(glm::dot(point - chordBegin, chord) / chordLength2, 0.0f, 1.0f) : 0.0f;
+
+        return glm::length(point - (chordBegin + t * chord));
+    }
+
+    float calcChordDistance(const glm::vec2& point, const glm::vec2& chordBegin, const glm::vec2& chordEnd)
+    {
+        float t = 0.0f;
+        return calcChordDistance(glm::vec3(point, 0.0f), glm::vec3(chordBegin, 0.0f), glm::vec3(chordEnd, 0.0f), t);
+    }
+
+    float calcTurnAngle(const glm::vec2& direction1, const glm::vec2& direction2)
+    {
+        float length = glm::length(direction1) * glm::length(direction2);
+
+        if (length == 0.0f)
+            return 0.0f;
+
+        return std::acos(std::clamp(glm::dot(direction1, direction2) / length, -1.0f, 1.0f));
+    }
+}
+
+SweepInput SweepLodInput::getInput() const
+{
+    SweepInput input;
+
+    input.cut = cut.data();
+    input.cutSize = cut.size();
+    input.trajectory = trajectory.data();
+    input.trajectorySize = trajectory.size();
+    input.cutParameters = cutParameters.data();
+    input.cutParametersSize = cutParameters.size();
+
+    return input;
+}
+
+std::vector<int> SweepLod::decimateTrajectory(const SweepInput& input, float profileRadius, float maxChordError, float& maxError)
+{
+    int size = input.trajectorySize;
+    maxError = 0.0f;
+
+    if (size <= 2)
+    {
+        std::vector<int> indices(size);
+
+        for (int i = 0; i < size; ++i)
+            indices[i] = i;
+
+        return indices;
+    }
+
+    std::vector<bool> isKept(size, false);
+    isKept[0] = true;
+    isKept[size - 1] = true;
+
+    // Douglas-Peucker with an explicit stack, long paths would overflow the recursion
+    std::vector<std::pair<int, int>> spans{ { 0, size - 1 } };
+
+    while (!spans.empty())
+    {
+        auto [begin, end] = spans.back();
+        spans.pop_back();
+
+        // long spans are halved without a test, the scan of a span whose farthest point sits
+        // near one of its ends would make the whole pass quadratic
+        if (end - begin > maxSpanSize)
+        {
+            int middle = (begin + end) / 2;
+
+            isKept[middle] = true;
+            spans.push_back({ begin, middle });
+            spans.push_back({ middle, end });
+            continue;
+        }
+
+        int farthest = -1;
+        float farthestError = 0.0f;
+
+        for (int i = begin + 1; i < end; ++i)
+        {
+            float t = 0.0f;
+            float distance = calcChordDistance(input.trajectory[i], input.trajectory[begin], input.trajectory[end], t);
+
+            float scale = input.cutParameters[begin] + t * (input.cutParameters[end] - input.cutParameters[begin]);
+            float error = distance + std::abs(input.cutParameters[i] - scale) * profileRadius;
+
+            if (error > farthestError)
+            {
+                farthestError = error;
+                farthest = i;
+            }
+        }
+
+        if (farthest != -1 && farthestError > maxChordError)
+        {
+            isKept[farthest] = true;
+            spans.push_back({ begin, farthest });
+            spans.push_back({ farthest, end });
+        }
+        else
+            maxError = std::max(maxError, farthestError);
+    }
+
+    std::vector<int> indices;
+
+    for (int i = 0; i < size; ++i)
+        if (isKept[i])
+            indices.push_back(i);
+
+    return indices;
+}
+
+std::vector<int> SweepLod::decimateProfile(const glm::vec2* cut, int cutSize, float maxAngle, float& maxError)
+{
+    std::vector<int> indices{ 0 };
+    maxError = 0.0f;
+
+    for (int i = 1; i < cutSize; ++i)
+    {
+        glm::vec2 direction1 = cut[i] - cut[indices.back()];
+        glm::vec2 direction2 = cut[(i + 1) % cutSize] - cut[i];
+
+        if (calcTurnAngle(direction1, direction2) > maxAngle)
+            indices.push_back(i);
+    }
+
+    if (indices.size() < 3)
+    {
+        indices.clear();
+
+        for (int i = 0; i < 3 && i < cutSize; ++i)
+            indices.push_back(i * cutSize / 3);
+    }
+
+    int keptSize = indices.size();
+
+    for (int k = 0; k < keptSize; ++k)
+    {
+        int begin = indices[k];
+        int end = k + 1 < keptSize ? indices[k + 1] : indices[0] + cutSize;
+
+        for (int i = begin + 1; i < end; ++i)
+            maxError = std::max(maxError, calcChordDistance(cut[i % cutSize], cut[begin], cut[end % cutSize]));
+    }
+
+    return indices;
+}
+
+float SweepLod::calcProfileRadius(const glm::vec2* cut, int cutSize)
+{
+    float radius = 0.0f;
+
+    for (int i = 0; i < cutSize; ++i)
+        radius = std::max(radius, glm::length(cut[i]));
+
+    return radius;
+}
+
+SweepLodInput SweepLod::decimate(const SweepInput& input, float maxChordError, float maxAngle)
+{
+    SweepLodInput lod;
+
+    float profileRadius = calcProfileRadius(input.cut, input.cutSize);
+    float maxScale = *std::max_element(input.cutParameters, input.cutParameters + input.cutParametersSize);
+
+    float trajectoryError = 0.0f;
+    float profileError = 0.0f;
+
+    std::vector<int> trajectoryIndices = decimateTrajectory(input, profileRadius, maxChordError, trajectoryError);
+    std::vector<int> cutIndices = decimateProfile(input.cut, input.cutSize, maxAngle, profileError);
+
+    for (int i : trajectoryIndices)
+    {
+        lod.trajectory.push_back(input.trajectory[i]);
+        lod.cutParameters.push_back(input.cutParameters[i]);
+    }
+
+    for (int i : cutIndices)
+        lod.cut.push_back(input.cut[i]);
+
+    lod.trajectoryIndices = std::move(trajectoryIndices);
+
+    lod.maxError = trajectoryError + profileError * maxScale;
+
+    return lod;
+}
@@ -0,0 +1,40 @@
+#ifndef SWEEP_LOD_H
+#define SWEEP_LOD_H
+
+#include "SweepGenerator.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Decimated copy of a sweep input, the points are picked from the full input
+struct SweepLodInput
+{
+    SweepInput getInput() const;
+
+    std::vector<glm::vec2> cut;
+    std::vector<glm::vec3> trajectory;
+    std::vector<float> cutParameters;
+    std::vector<int> trajectoryIndices; // of the kept points in the full input
+
+    // largest object space distance between the decimated and the full surface, estimated
+    float maxError = 0.0f;
+};
+
+namespace SweepLod
+{
+    // keeps the trajectory points needed to stay within maxChordError of the full path,
+    // a cut scale change counts as a deviation of the profile radius times the scale difference,
+    // the first and the last points are always kept
+    std::vector<int> decimateTrajectory(const SweepInput& input, float profileRadius, float maxChordError, float& maxError);
+
+    // keeps the profile points where the closed profile turns by more than maxAngle (radians)
+    // since the previous kept point, at least 3 points are kept
+    std::vector<int> decimateProfile(const glm::vec2* cut, int cutSize, float maxAngle, float& maxError);
+
+    float calcProfileRadius(const glm::vec2* cut, int cutSize);
+
+    SweepLodInput decimate(const SweepInput& input, float maxChordError, float maxAngle);
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include "TextScanner.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    const char* skipSpaces(const char* position, const char* end)
+    {
+        while (position != end && isSpace(*position))
+            ++position;
+
+        return position;
+    }
+
+    const char* skipToken(const char* position, const char* end)
+    {
+        while (position != end && !isSpace(*position))
+            ++position;
+
+        return position;
+    }
+
+    // the whole token has to be a number, iostreams would stop at the first wrong character instead.
+    // Returns the token end or nullptr, the token is not scanned before parsing
+    template<typename T>
+    const char* parseNumber(const char* position, const char* end, T& value)
+    {
+        // from_chars does not take the plus sign
+        const char* begin = position != end && *position == '+' ? position + 1 : position;
+
+        std::from_chars_result result = std::from_chars(begin, end, value);
+
+        if (result.ec != std::errc() || (result.ptr != end && !isSpace(*result.ptr)))
+            return nullptr;
+
+        return result.ptr;
+    }
+
+    // index of the value in the output of a sampled read, -1 when it is skipped
+    int getSampledValue(int value, int groupSize, int groupsCount, int stride)
+    {
+        if (stride == 1)
+            return value;
+
+        int group = value / groupSize;
+        int sampledGroup = -1;
+
+        if (group % stride == 0)
+            sampledGroup = group / stride;
+        else if (group == groupsCount - 1)
+            sampledGroup = group / stride + 1;
+
+        return sampledGroup >= 0 ? sampledGroup * groupSize + value % groupSize : -1;
+    }
+}
+
+bool TextScanner::open(std::string_view path)
+{
+    close();
+
+    m_path = path;
+
+    if (!m_file.open(path))
+        return false;
+
+    m_position = m_file.getData();
+    m_end = m_position + m_file.getSize();
+
+    return true;
+}
+
+void TextScanner::close()
+{
+    m_file.close();
+    m_position = nullptr;
+    m_end = nullptr;
+    m_isFailed = false;
+}
+
+bool TextScanner::isFailed() const
+{
+    return m_isFailed;
+}
+
+bool TextScanner::isEnd()
+{
+    m_position = skipSpaces(m_position, m_end);
+    return m_position == m_end;
+}
+
+bool TextScanner::read(int& value)
+{
+    if (!skipToNextToken())
+        return false;
+
+    const char* tokenEnd = parseNumber(m_position, m_end, value);
+
+    if (tokenEnd == nullptr)
+    {
+        fail(m_position, "expected an integer, found \"" + std::string(m_position, skipToken(m_position, m_end)) + "\"");
+        return false;
+    }
+
+    m_position = tokenEnd;
+    return true;
+}
+
+bool TextScanner::read(float& value)
+{
+    if (!skipToNextToken())
+        return false;
+
+    const char* tokenEnd = parseNumber(m_position, m_end, value);
+
+    if (tokenEnd == nullptr)
+    {
+        fail(m_position, "expected a number, found \"" + std::string(m_position, skipToken(m_position, m_end)) + "\"");
+        return false;
+    }
+
+    m_position = tokenEnd;
+    return true;
+}
+
+bool TextScanner::read(std::string_view& token)
+{
+    if (!skipToNextToken())
+        return false;
+
+    const char* tokenEnd = skipToken(m_position, m_end);
+
+    token = std::string_view(m_position, tokenEnd - m_position);
+    m_position = tokenEnd;
+
+    return true;
+}
+
+bool TextScanner::read(float* values, int count, ThreadPool* threadPool)
+{
+    return read(values, 1, count, 1, threadPool);
+}
+
+bool TextScanner::read(float* values, int groupSize, int groupsCount, int stride, ThreadPool* threadPool)
+{
+    int count = groupSize * groupsCount;
+
+    if (threadPool != nullptr && count >= parallelMinValuesCount && m_end - m_position > 2 * parallelChunkSize)
+        return readParallel(values, groupSize, groupsCount, stride, threadPool);
+
+    for (int i = 0; i < count; ++i)
+    {
+        int sampledValue = getSampledValue(i, groupSize, groupsCount, stride);
+
+        if (sampledValue >= 0)
+        {
+            if (!read(values[sampledValue]))
+                return false;
+        }
+        else
+        {
+            if (!skipToNextToken())
+                return false;
+
+            m_position = skipToken(m_position, m_end);
+        }
+    }
+
+    return true;
+}
+
+int TextScanner::getSampledGroupsCount(int groupsCount, int stride)
+{
+    if (groupsCount == 0)
+        return 0;
+
+    return (groupsCount - 1) / stride + 1 + ((groupsCount - 1) % stride != 0 ? 1 : 0);
+}
+
+bool TextScanner::readParallel(float* values, int groupSize, int groupsCount, int stride, ThreadPool* threadPool)
+{
+    if (m_isFailed)
+        return false;
+
+    int count = groupSize * groupsCount;
+
+    // the rest of the file is split at whitespace, so that no token is shared by two chunks
+    std::vector<const char*> bounds{ m_position };
+
+    while (bounds.back() != m_end)
+    {
+        const char* bound = m_end - bounds.back() > parallelChunkSize ? bounds.back() + parallelChunkSize : m_end;
+        bounds.push_back(skipToken(bound, m_end));
+    }
+
+    int chunksCount = bounds.size() - 1;
+
+    // the tokens are counted first, then every chunk knows the index of its first value
+    std::vector<int> firstValues(chunksCount + 1, 0);
+
+    threadPool->parallelFor(0, chunksCount, [&](int begin, int end)
+    {
+        for (int k = begin; k < end; ++k)
+        {
+            int tokensCount = 0;
+
+            for (const char* position = skipSpaces(bounds[k], bounds[k + 1]); position != bounds[k + 1]; position = skipSpaces(position, bounds[k + 1]))
+            {
+                position = skipToken(position, bounds[k + 1]);
+                ++tokensCount;
+            }
+
+            firstValues[k + 1] = tokensCount;
+        }
+    });
+
+    for (int k = 0; k < chunksCount; ++k)
+        firstValues[k + 1] = static_cast<int>(std::min<long long>(static_cast<long long>(firstValues[k]) + firstValues[k + 1], count + 1LL));
+
+    if (firstValues[chunksCount] < count)
+    {
+        fail(m_end, "unexpected end of file");
+        return false;
+    }
+
+    int usedChunksCount = std::upper_bound(firstValues.begin(), firstValues.end(), count - 1) - firstValues.begin();
+
+    // the earliest wrong token of every chunk and the end of the last value
+    std::vector<const char*> errors(usedChunksCount, nullptr);
+    const char* valuesEnd = m_position;
+
+    threadPool->parallelFor(0, usedChunksCount, [&](int begin, int end)
+    {
+        for (int k = begin; k < end; ++k)
+        {
+            const char* position = bounds[k];
+
+            for (int i = firstValues[k]; i < std::min(firstValues[k + 1], count); ++i)
+            {
+                position = skipSpaces(position, bounds[k + 1]);
+
+                int sampledValue = getSampledValue(i, groupSize, groupsCount, stride);
+                const char* tokenEnd = sampledValue >= 0 ? parseNumber(position, bounds[k + 1], values[sampledValue]) : skipToken(position, bounds[k + 1]);
+
+                if (tokenEnd == nullptr)
+                {
+                    errors[k] = position;
+                    break;
+                }
+
+                position = tokenEnd;
+
+                if (i == count - 1)
+                    valuesEnd = position;
+            }
+        }
+    });
+
+    for (const char* error : errors)
+    {
+        if (error != nullptr)
+        {
+            fail(error, "expected a number, found \"" + std::string(error, skipToken(error, m_end)) + "\"");
+            return false;
+        }
+    }
+
+    m_position = valuesEnd;
+    return true;
+}
+
+bool TextScanner::skipToNextToken()
+{
+    if (m_isFailed)
+        return false;
+
+    m_position = skipSpaces(m_position, m_end);
+
+    if (m_position == m_end)
+    {
+        fail(m_end, "unexpected end of file");
+        return false;
+    }
+
+    return true;
+}
+
+void TextScanner::fail(const char* position, std::string_view message)
+{
+    // lines are only counted for the report
+    int line = 1 + std::count(m_file.getData(), position, '\n');
+
+    std::cerr << m_path << ":" << line << ": " << message << "!" << std::endl;
+
+    m_isFailed = true;
+}
@@ -0,0 +1,51 @@
+#ifndef TEXT_SCANNER_H
+#define TEXT_SCANNER_H
+
+#include "MappedFile.h"
+
+#include <string>
+#include <string_view>
+
+class ThreadPool;
+
+// Whitespace separated tokens of a mapped text file. Numbers are read with std::from_chars, so the locale is not involved.
+// The first failed read reports the file and the line to std::cerr, every following read fails too
+class TextScanner
+{
+public:
+    bool open(std::string_view path);
+    void close();
+
+    bool isFailed() const;
+
+    // skips the whitespace, true when nothing is left
+    bool isEnd();
+
+    bool read(int& value);
+    bool read(float& value);
+    bool read(std::string_view& token);
+
+    // with a thread pool long runs of values are split into chunks of the file which are parsed in parallel
+    bool read(float* values, int count, ThreadPool* threadPool = nullptr);
+
+    // reads every stride-th group of groupSize values and the last group, the values between are skipped without parsing.
+    // values has room for getSampledGroupsCount(groupsCount, stride) groups
+    bool read(float* values, int groupSize, int groupsCount, int stride, ThreadPool* threadPool = nullptr);
+    static int getSampledGroupsCount(int groupsCount, int stride);
+
+private:
+    static constexpr int parallelMinValuesCount = 1 << 16;
+    static constexpr int parallelChunkSize = 1 << 20;
+
+    bool readParallel(float* values, int groupSize, int groupsCount, int stride, ThreadPool* threadPool);
+    bool skipToNextToken();
+    void fail(const char* position, std::string_view message);
+
+    MappedFile m_file;
+    std::string m_path;
+    const char* m_position = nullptr;
+    const char* m_end = nullptr;
+    bool m_isFailed = false;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(int threadsCount)
+{
+    if (threadsCount <= 0)
+        threadsCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_workers.reserve(threadsCount);
+
+    for (int i = 0; i < threadsCount; ++i)
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+int ThreadPool::getThreadsCount() const
+{
+    return m_workers.size();
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::future<void> future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(packagedTask));
+    }
+
+    m_condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::parallelFor(int begin, int end, const std::function<void(int, int)>& task, int minRangeSize)
+{
+    int size = end - begin;
+
+    if (size <= 0)
+        return;
+
+    int rangesCount = std::min(getThreadsCount() * 4, (size + minRangeSize - 1) / std::max(minRangeSize, 1));
+
+    if (rangesCount <= 1)
+    {
+        task(begin, end);
+        return;
+    }
+
+    int rangeSize = (size + rangesCount - 1) / rangesCount;
+    rangesCount = (size + rangeSize - 1) / rangeSize;
+
+    struct ParallelForState
+    {
+        std::atomic<int> nextRange = 0;
+        int doneRanges = 0;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    // helpers may start after all ranges are taken, so the state outlives this call
+    auto state = std::make_shared<ParallelForState>();
+
+    auto runRanges = [state, &task, begin, end, rangeSize, rangesCount]()
+    {
+        for (int range = state->nextRange++; range < rangesCount; range = state->nextRange++)
+        {
+            int rangeBegin = begin + range * rangeSize;
+            task(rangeBegin, std::min(rangeBegin + rangeSize, end));
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            if (++state->doneRanges == rangesCount)
+                state->condition.notify_all();
+        }
+    };
+
+    int helpersCount = std::min(getThreadsCount(), rangesCount - 1);
+    for (int i = 0; i < helpersCount; ++i)
+        submit(runRanges);
+
+    runRanges();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state, rangesCount]() { return state->doneRanges == rangesCount; });
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_isStopping || !m_tasks.empty(); });
+
+            if (m_isStopping && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
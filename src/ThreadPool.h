@@ -0,0 +1,43 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // 0 threads means one worker per hardware thread
+    ThreadPool(int threadsCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+
+    int getThreadsCount() const;
+
+    std::future<void> submit(std::function<void()> task);
+
+    // splits [begin, end) into ranges of at least minRangeSize elements and returns when all of them are done,
+    // the calling thread works on the ranges too, so it is safe to call from a pool task
+    void parallelFor(int begin, int end, const std::function<void(int, int)>& task, int minRangeSize = 1);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::packaged_task<void()>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isStopping = false;
+};
+
+#endif
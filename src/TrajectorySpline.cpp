@@ -0,0 +1,303 @@
+#include "TrajectorySpline.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // rows are control points, columns are coefficients of 1, t, t^2, t^3
+    constexpr float polylineBasis[4][4]{
+        { 0.0f,  0.0f,  0.0f,  0.0f },
+        { 1.0f, -1.0f,  0.0f,  0.0f },
+        { 0.0f,  1.0f,  0.0f,  0.0f },
+        { 0.0f,  0.0f,  0.0f,  0.0f } };
+
+    constexpr float catmullRomBasis[4][4]{
+        { 0.0f, -0.5f,  1.0f, -0.5f },
+        { 1.0f,  0.0f, -2.5f,  1.5f },
+        { 0.0f,  0.5f,  2.0f, -1.5f },
+        { 0.0f,  0.0f, -0.5f,  0.5f } };
+
+    constexpr float bSplineBasis[4][4]{
+        { 1.0f / 6.0f, -0.5f,  0.5f, -1.0f / 6.0f },
+        { 4.0f / 6.0f,  0.0f, -1.0f,  0.5f },
+        { 1.0f / 6.0f,  0.5f,  0.5f, -0.5f },
+        { 0.0f,         0.0f,  0.0f,  1.0f / 6.0f } };
+
+    // x, y, z and the cut parameter multiplied by the profile radius, so scale changes bend the curve too
+    struct CurvePoint
+    {
+        glm::vec4 value;
+        int segment = 0;
+        float t = 0.0f;
+    };
+
+    float calcTurnAngle(const glm::vec4& direction1, const glm::vec4& direction2)
+    {
+        float length = glm::length(direction1) * glm::length(direction2);
+
+        if (length == 0.0f)
+            return 0.0f;
+
+        return std::acos(std::clamp(glm::dot(direction1, direction2) / length, -1.0f, 1.0f));
+    }
+
+    double getCurvePosition(const CurvePoint& point)
+    {
+        return point.segment + static_cast<double>(point.t);
+    }
+
+    float calcDistanceToChord(const glm::vec4& point, const glm::vec4& begin, const glm::vec4& end)
+    {
+        glm::vec4 chord = end - begin;
+        float lengthSquared = glm::dot(chord, chord);
+        float t = lengthSquared > 0.0f ? std::clamp(glm::dot(point - begin, chord) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+
+        return glm::length(point - (begin + t * chord));
+    }
+
+    // presamples [first, last) lie between begin and end, the chord is split at the farthest of them
+    // until all of them are within maxChordError, the split points are appended to samples in order
+    void splitChord(const std::vector<CurvePoint>& presamples, int first, int last, const CurvePoint& begin, const CurvePoint& end, float maxChordError, std::vector<CurvePoint>& samples)
+    {
+        int farthest = -1;
+        float maxDistance = maxChordError;
+
+        for (int j = first; j < last; ++j)
+        {
+            float distance = calcDistanceToChord(presamples[j].value, begin.value, end.value);
+
+            if (distance > maxDistance)
+            {
+                farthest = j;
+                maxDistance = distance;
+            }
+        }
+
+        if (farthest < 0)
+            return;
+
+        splitChord(presamples, first, farthest, begin, presamples[farthest], maxChordError, samples);
+        samples.push_back(presamples[farthest]);
+        splitChord(presamples, farthest + 1, last, presamples[farthest], end, maxChordError, samples);
+    }
+}
+
+void TrajectorySpline::setControlPoints(const TrajectorySplineInput& input)
+{
+    m_curve = input.curve;
+
+    const float (*basis)[4] = m_curve == Polyline_curve ? polylineBasis : m_curve == Catmull_rom_curve ? catmullRomBasis : bSplineBasis;
+    std::copy(&basis[0][0], &basis[0][0] + 16, &m_basis[0][0]);
+
+    // end points are repeated: once for Catmull-Rom and polyline, twice for B-spline and NURBS
+    // so that the curve is clamped to them
+    int padding = m_curve == B_spline_curve || m_curve == Nurbs_curve ? 2 : 1;
+    int paddedSize = input.size > 0 ? input.size + 2 * padding : 0;
+
+    for (std::vector<float>& control : m_control)
+        control.resize(paddedSize);
+
+    for (int i = 0; i < paddedSize; ++i)
+    {
+        int index = std::clamp(i - padding, 0, input.size - 1);
+        float weight = m_curve == Nurbs_curve && input.weights ? input.weights[index] : 1.0f;
+
+        m_control[0][i] = weight * input.controlPoints[index].x;
+        m_control[1][i] = weight * input.controlPoints[index].y;
+        m_control[2][i] = weight * input.controlPoints[index].z;
+        m_control[3][i] = weight * input.cutParameters[index];
+        m_control[4][i] = weight;
+    }
+}
+
+int TrajectorySpline::getSegmentsCount() const
+{
+    return std::max(static_cast<int>(m_control[0].size()) - 3, 0);
+}
+
+void TrajectorySpline::evaluate(int segment, const float* t, int count, glm::vec3* points, float* cutParameters) const
+{
+    std::vector<float> values[5];
+
+    for (int c = 0; c < 5; ++c)
+    {
+        // the segment polynomial of this coordinate, so the loop over the samples has no inner loop
+        // and the compiler vectorizes it
+        float coefficients[4]{};
+
+        for (int k = 0; k < 4; ++k)
+            for (int p = 0; p < 4; ++p)
+                coefficients[p] += m_basis[k][p] * m_control[c][segment + k];
+
+        values[c].resize(count);
+        float* value = values[c].data();
+
+        for (int j = 0; j < count; ++j)
+            value[j] = ((coefficients[3] * t[j] + coefficients[2]) * t[j] + coefficients[1]) * t[j] + coefficients[0];
+    }
+
+    for (int j = 0; j < count; ++j)
+    {
+        float weight = values[4][j];
+
+        points[j] = glm::vec3(values[0][j], values[1][j], values[2][j]) / weight;
+        cutParameters[j] = values[3][j] / weight;
+    }
+}
+
+void TrajectorySpline::sample(float maxChordError, float maxAngle, float profileRadius, std::vector<glm::vec3>& trajectory, std::vector<float>& cutParameters) const
+{
+    trajectory.clear();
+    cutParameters.clear();
+
+    int segmentsCount = getSegmentsCount();
+
+    if (segmentsCount == 0)
+        return;
+
+    // a polyline is already made of its samples
+    if (m_curve == Polyline_curve)
+    {
+        for (int i = 1; i < segmentsCount + 2; ++i)
+        {
+            trajectory.push_back(glm::vec3(m_control[0][i], m_control[1][i], m_control[2][i]));
+            cutParameters.push_back(m_control[3][i]);
+        }
+
+        return;
+    }
+
+    // the curve is first evaluated at a fixed number of points per segment to estimate its bends
+    std::vector<float> presampleT(presamplesInSegment + 1);
+
+    for (int j = 0; j <= presamplesInSegment; ++j)
+        presampleT[j] = static_cast<float>(j) / presamplesInSegment;
+
+    std::vector<glm::vec3> points(presamplesInSegment + 1);
+    std::vector<float> scales(presamplesInSegment + 1);
+    std::vector<CurvePoint> presamples;
+    presamples.reserve(segmentsCount * presamplesInSegment + 1);
+
+    for (int i = 0; i < segmentsCount; ++i)
+    {
+        evaluate(i, presampleT.data(), presamplesInSegment + 1, points.data(), scales.data());
+
+        int last = i == segmentsCount - 1 ? presamplesInSegment : presamplesInSegment - 1;
+
+        for (int j = 0; j <= last; ++j)
+            presamples.push_back({ glm::vec4(points[j], scales[j] * profileRadius), i, presampleT[j] });
+    }
+
+    int presamplesCount = presamples.size();
+
+    std::vector<float> turnAngles(presamplesCount, 0.0f);
+
+    for (int j = 1; j < presamplesCount - 1; ++j)
+        turnAngles[j] = calcTurnAngle(presamples[j].value - presamples[j - 1].value, presamples[j + 1].value - presamples[j].value);
+
+    // an arc that turns by angle over length needs angle / maxAngle samples for the angle limit
+    // and sqrt(angle * length / (8 * maxChordError)) samples for the sagitta limit
+    std::vector<int> sampleSegments{ 0 };
+    std::vector<float> sampleT{ 0.0f };
+
+    float samplesSum = 0.0f;
+
+    for (int j = 0; j < presamplesCount - 1; ++j)
+    {
+        const CurvePoint& begin = presamples[j];
+        const CurvePoint& end = presamples[j + 1];
+
+        float angle = 0.5f * (turnAngles[j] + turnAngles[j + 1]);
+        float length = glm::length(end.value - begin.value);
+
+        float samples = std::max(angle / maxAngle, std::sqrt(angle * length / (8.0f * maxChordError)));
+
+        float endT = end.segment == begin.segment ? end.t : 1.0f;
+
+        for (float m = std::floor(samplesSum) + 1.0f; m <= samplesSum + samples; m += 1.0f)
+        {
+            float fraction = (m - samplesSum) / samples;
+
+            sampleSegments.push_back(begin.segment);
+            sampleT.push_back(begin.t + fraction * (endT - begin.t));
+        }
+
+        samplesSum += samples;
+    }
+
+    if (sampleSegments.back() != segmentsCount - 1 || sampleT.back() != 1.0f)
+    {
+        sampleSegments.push_back(segmentsCount - 1);
+        sampleT.push_back(1.0f);
+    }
+
+    evaluateSamples(sampleSegments, sampleT, trajectory, cutParameters);
+
+    // the estimate misses where a straight part meets a bend, so a chord that passes farther than maxChordError
+    // from the presamples between its ends is split at them
+    std::vector<CurvePoint> samples{ { glm::vec4(trajectory[0], cutParameters[0] * profileRadius), sampleSegments[0], sampleT[0] } };
+    int firstPresample = 0;
+
+    for (int i = 1; i < static_cast<int>(sampleT.size()); ++i)
+    {
+        CurvePoint begin = samples.back();
+        CurvePoint end{ glm::vec4(trajectory[i], cutParameters[i] * profileRadius), sampleSegments[i], sampleT[i] };
+
+        while (firstPresample < presamplesCount && getCurvePosition(presamples[firstPresample]) <= getCurvePosition(begin))
+            ++firstPresample;
+
+        int lastPresample = firstPresample;
+
+        while (lastPresample < presamplesCount && getCurvePosition(presamples[lastPresample]) < getCurvePosition(end))
+            ++lastPresample;
+
+        splitChord(presamples, firstPresample, lastPresample, begin, end, maxChordError, samples);
+        samples.push_back(end);
+    }
+
+    // a straight curve gets only its end points, but a sweep needs at least three rings,
+    // so the middle of the curve is sampled too
+    if (static_cast<int>(samples.size()) < minSamplesSize)
+    {
+        float middle = 0.5f * segmentsCount;
+        int middleSegment = std::min(static_cast<int>(middle), segmentsCount - 1);
+
+        samples.insert(samples.begin() + 1, CurvePoint{ glm::vec4(0.0f), middleSegment, middle - middleSegment });
+    }
+
+    if (samples.size() == sampleT.size())
+        return;
+
+    sampleSegments.resize(samples.size());
+    sampleT.resize(samples.size());
+
+    for (int i = 0; i < static_cast<int>(samples.size()); ++i)
+    {
+        sampleSegments[i] = samples[i].segment;
+        sampleT[i] = samples[i].t;
+    }
+
+    evaluateSamples(sampleSegments, sampleT, trajectory, cutParameters);
+}
+
+void TrajectorySpline::evaluateSamples(const std::vector<int>& segments, const std::vector<float>& t, std::vector<glm::vec3>& points, std::vector<float>& cutParameters) const
+{
+    int samplesCount = t.size();
+
+    points.resize(samplesCount);
+    cutParameters.resize(samplesCount);
+
+    // samples are ordered by segment, every run of one segment is evaluated in one batch
+    for (int begin = 0; begin < samplesCount;)
+    {
+        int end = begin + 1;
+
+        while (end < samplesCount && segments[end] == segments[begin])
+            ++end;
+
+        evaluate(segments[begin], t.data() + begin, end - begin, points.data() + begin, cutParameters.data() + begin);
+
+        begin = end;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef TRAJECTORY_SPLINE_H
+#define TRAJECTORY_SPLINE_H
+
+#include "Enums.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct TrajectorySplineInput
+{
+    const glm::vec3* controlPoints = nullptr;
+    const float* cutParameters = nullptr;
+    const float* weights = nullptr; // NURBS only, nullptr means all weights are 1
+    int size = 0;
+
+    TrajectoryCurves curve = Polyline_curve;
+};
+
+// Uniform cubic curve over the control points: Catmull-Rom passes through every control point,
+// B-spline and NURBS pass through the first and the last ones.
+// Cut parameters are interpolated with the same basis as the points
+class TrajectorySpline
+{
+public:
+    void setControlPoints(const TrajectorySplineInput& input);
+
+    int getSegmentsCount() const;
+
+    // batch evaluation of one segment, t in [0, 1]
+    void evaluate(int segment, const float* t, int count, glm::vec3* points, float* cutParameters) const;
+
+    // places samples densely in tight bends and sparsely on straight parts, so that the polyline through them
+    // stays within about maxChordError of the curve and turns by at most maxAngle (radians) between samples,
+    // cut parameter changes are measured as a distance multiplied by profileRadius
+    void sample(float maxChordError, float maxAngle, float profileRadius, std::vector<glm::vec3>& trajectory, std::vector<float>& cutParameters) const;
+
+private:
+    // samples are ordered by segment
+    void evaluateSamples(const std::vector<int>& segments, const std::vector<float>& t, std::vector<glm::vec3>& points, std::vector<float>& cutParameters) const;
+
+    static constexpr int presamplesInSegment = 16;
+    static constexpr int minSamplesSize = 3;
+
+    TrajectoryCurves m_curve = Polyline_curve;
+
+    // padded control points in homogeneous coordinates as separate arrays: x, y, z, cut parameter, weight
+    std::vector<float> m_control[5];
+
+    // basis polynomial coefficients: weight of control point k is sum of m_basis[k][p] * t^p
+    float m_basis[4][4]{};
+};
+
+#endif
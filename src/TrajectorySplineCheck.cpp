@@ -0,0 +1,134 @@
+#include "TrajectorySpline.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr float maxChordError = 1e-3f;
+    constexpr float maxAngle = 0.0872665f; // 5 degrees
+    constexpr float profileRadius = 1.0f;
+
+    // the chords are checked at the presamples only, so the error between them may slightly exceed the limit
+    constexpr float chordErrorTolerance = 1.5f * maxChordError;
+    constexpr int densePointsInSegment = 256;
+    constexpr int minSamplesSize = 3;
+
+    float calcDistanceToSegment(const glm::vec3& point, const glm::vec3& begin, const glm::vec3& end)
+    {
+        glm::vec3 direction = end - begin;
+        float lengthSquared = glm::dot(direction, direction);
+        float t = lengthSquared > 0.0f ? std::clamp(glm::dot(point - begin, direction) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+
+        return glm::length(point - (begin + t * direction));
+    }
+
+    // largest distance from a dense evaluation of the curve to the polyline through the samples
+    float calcChordError(const TrajectorySpline& spline, const std::vector<glm::vec3>& trajectory)
+    {
+        std::vector<float> t(densePointsInSegment + 1);
+
+        for (int j = 0; j <= densePointsInSegment; ++j)
+            t[j] = static_cast<float>(j) / densePointsInSegment;
+
+        std::vector<glm::vec3> points(t.size());
+        std::vector<float> cutParameters(t.size());
+
+        float chordError = 0.0f;
+
+        for (int i = 0; i < spline.getSegmentsCount(); ++i)
+        {
+            spline.evaluate(i, t.data(), t.size(), points.data(), cutParameters.data());
+
+            for (const glm::vec3& point : points)
+            {
+                float distance = std::numeric_limits<float>::max();
+
+                for (size_t k = 0; k + 1 < trajectory.size(); ++k)
+                    distance = std::min(distance, calcDistanceToSegment(point, trajectory[k], trajectory[k + 1]));
+
+                chordError = std::max(chordError, distance);
+            }
+        }
+
+        return chordError;
+    }
+
+    bool checkCurve(const char* name, const std::vector<glm::vec3>& controlPoints, TrajectoryCurves curve)
+    {
+        std::vector<float> cutParameters(controlPoints.size(), 1.0f);
+        std::vector<float> weights(controlPoints.size(), 1.0f);
+
+        TrajectorySplineInput input;
+        input.controlPoints = controlPoints.data();
+        input.cutParameters = cutParameters.data();
+        input.weights = weights.data();
+        input.size = controlPoints.size();
+        input.curve = curve;
+
+        TrajectorySpline spline;
+        spline.setControlPoints(input);
+
+        std::vector<glm::vec3> trajectory;
+        std::vector<float> sampledCutParameters;
+        spline.sample(maxChordError, maxAngle, profileRadius, trajectory, sampledCutParameters);
+
+        int samplesSize = trajectory.size();
+        float chordError = samplesSize > 1 ? calcChordError(spline, trajectory) : 0.0f;
+
+        std::cout << name << ": " << samplesSize << " samples, chord error " << chordError << std::endl;
+
+        if (samplesSize < minSamplesSize)
+        {
+            std::cerr << name << " has fewer samples than a sweep needs!" << std::endl;
+            return false;
+        }
+
+        if (chordError > chordErrorTolerance)
+        {
+            std::cerr << name << " chord error is above the tolerance!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool checkCurves(const char* name, const std::vector<glm::vec3>& controlPoints)
+    {
+        std::string prefix = std::string(name) + " ";
+
+        bool isPassed = checkCurve((prefix + "Catmull-Rom").c_str(), controlPoints, Catmull_rom_curve);
+        isPassed = checkCurve((prefix + "B-spline").c_str(), controlPoints, B_spline_curve) && isPassed;
+        isPassed = checkCurve((prefix + "NURBS").c_str(), controlPoints, Nurbs_curve) && isPassed;
+
+        return isPassed;
+    }
+}
+
+// samples straight and bent spline trajectories, exits with 1 when a sampling is too short for a sweep
+// or strays from the curve by more than the tolerance
+int main()
+{
+    std::vector<glm::vec3> collinear;
+
+    for (int i = 0; i < 5; ++i)
+        collinear.push_back(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+
+    std::vector<glm::vec3> straightAndBend = collinear;
+
+    for (int i = 1; i < 5; ++i)
+        straightAndBend.push_back(glm::vec3(4.0f, static_cast<float>(i), 0.0f));
+
+    std::vector<glm::vec3> twoPoints{ glm::vec3(0.0f), glm::vec3(1.0f, 2.0f, 3.0f) };
+
+    bool isPassed = checkCurves("collinear", collinear);
+    isPassed = checkCurves("straight and bend", straightAndBend) && isPassed;
+    isPassed = checkCurves("two points", twoPoints) && isPassed;
+
+    return isPassed ? 0 : 1;
+}
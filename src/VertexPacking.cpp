@@ -0,0 +1,405 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+    constexpr float unorm16Max = 65535.0f;
+
+    // bits of a level in PackedPosition::levels
+    constexpr int levelBits = 5;
+    constexpr int maxLevel = (1 << levelBits) - 1;
+
+    // a step of at least 2^-22 of the largest coordinate keeps the grid points and the decoded sums exact floats
+    constexpr int exactStepBits = 22;
+
+    // steps and their inverses stay normal floats
+    constexpr int minStepExponent = -100;
+    constexpr int maxStepExponent = 120;
+
+    struct PositionKey
+    {
+        uint32_t bits[3]{};
+
+        bool operator==(const PositionKey& key) const = default;
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& key) const
+        {
+            uint64_t hash = key.bits[0];
+            hash = hash * 0x9E3779B97F4A7C15ull ^ key.bits[1];
+            hash = hash * 0x9E3779B97F4A7C15ull ^ key.bits[2];
+
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    // grid exponents of the moved positions, the largest step exponent of the chunks that hold a copy
+    using GridExponents = std::unordered_map<PositionKey, glm::ivec3, PositionKeyHash>;
+
+    PositionKey getPositionKey(const glm::vec3& position)
+    {
+        return PositionKey{ std::bit_cast<uint32_t>(position.x), std::bit_cast<uint32_t>(position.y), std::bit_cast<uint32_t>(position.z) };
+    }
+
+    void mergeGridExponents(GridExponents& gridExponents, const glm::vec3& position, const glm::ivec3& exponents)
+    {
+        auto [it, isInserted] = gridExponents.try_emplace(getPositionKey(position), exponents);
+
+        if (!isInserted)
+            it->second = glm::max(it->second, exponents);
+    }
+
+    float calcPowerOfTwo(int exponent)
+    {
+        return std::bit_cast<float>(static_cast<uint32_t>(exponent + 127) << 23);
+    }
+
+    bool isGridFitted(float extent, int exponent)
+    {
+        return extent <= unorm16Max * calcPowerOfTwo(exponent) || exponent >= maxStepExponent;
+    }
+
+    int calcStepExponent(float extent, float maxCoordinate)
+    {
+        int exponent = maxCoordinate > 0.0f ? std::max(std::ilogb(maxCoordinate) - exactStepBits, minStepExponent) : 0;
+
+        while (!isGridFitted(extent, exponent))
+            ++exponent;
+
+        return exponent;
+    }
+
+    // scaling by powers of two and rounding are exact, so every copy of a position snaps to the same float
+    glm::vec3 snapToGrid(const glm::vec3& position, const glm::ivec3& gridExponents)
+    {
+        glm::vec3 snapped;
+
+        for (int k = 0; k < 3; ++k)
+            snapped[k] = std::round(position[k] * calcPowerOfTwo(-gridExponents[k])) * calcPowerOfTwo(gridExponents[k]);
+
+        return snapped;
+    }
+
+    // false when the snapped position is outside of the chunk grid
+    bool packPosition(const glm::vec3& position, const glm::ivec3& gridExponents, const glm::ivec3& stepExponents, const PackedChunkBounds& bounds, PackedPosition& packedPosition)
+    {
+        glm::vec3 snapped = snapToGrid(position, gridExponents);
+        int levels = 0;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            int level = gridExponents[k] - stepExponents[k];
+            float value = (snapped[k] - bounds.origin[k]) * calcPowerOfTwo(-stepExponents[k]);
+
+            if (!(value >= 0.0f && value <= unorm16Max) || level < 0 || level > maxLevel)
+                return false;
+
+            packedPosition.value[k] = static_cast<uint16_t>(value);
+            levels |= level << (k * levelBits);
+        }
+
+        packedPosition.levels = static_cast<uint16_t>(levels);
+        return true;
+    }
+
+    glm::ivec3 unpackLevels(uint16_t levels)
+    {
+        return glm::ivec3(levels & maxLevel, (levels >> levelBits) & maxLevel, (levels >> (2 * levelBits)) & maxLevel);
+    }
+
+    int packSnorm10(float value)
+    {
+        return static_cast<int>(std::round(std::clamp(value, -1.0f, 1.0f) * 511.0f)) & 0x3FF;
+    }
+
+    float unpackSnorm10(uint32_t bits)
+    {
+        // sign extension of the 10-bit two's complement value
+        int value = static_cast<int>(bits << 22) >> 22;
+        return std::max(value / 511.0f, -1.0f);
+    }
+}
+
+int PositionQuantization::getChunksCount(int verticesSize)
+{
+    return (verticesSize + chunkSize - 1) / chunkSize;
+}
+
+void PositionQuantization::setSections(const std::vector<SweepRange>& sections)
+{
+    m_sections = sections;
+    m_packedSections.clear();
+
+    int packedBegin = 0;
+
+    for (const SweepRange& section : m_sections)
+    {
+        int packedEnd = packedBegin + section.end - section.begin;
+        m_packedSections.push_back(SweepRange{ packedBegin, packedEnd });
+
+        packedBegin = getChunksCount(packedEnd) * chunkSize;
+    }
+}
+
+const std::vector<SweepRange>& PositionQuantization::getPackedSections() const
+{
+    return m_packedSections;
+}
+
+int PositionQuantization::getPackedVerticesSize() const
+{
+    return m_packedSections.empty() ? 0 : m_packedSections.back().end;
+}
+
+int PositionQuantization::getPackedVertex(int vertex) const
+{
+    int section = 0;
+
+    while (section + 1 < static_cast<int>(m_sections.size()) && vertex >= m_sections[section + 1].begin)
+        ++section;
+
+    return m_packedSections[section].begin + vertex - m_sections[section].begin;
+}
+
+void PositionQuantization::build(SweepAttribute<glm::vec3> positions, SweepAttribute<PackedPosition> packedPositions)
+{
+    int chunksCount = getChunksCount(getPackedVerticesSize());
+
+    auto forEachVertex = [this](auto&& function)
+    {
+        for (int i = 0; i < static_cast<int>(m_sections.size()); ++i)
+        {
+            for (int vertex = m_sections[i].begin; vertex < m_sections[i].end; ++vertex)
+                function(vertex, m_packedSections[i].begin + vertex - m_sections[i].begin);
+        }
+    };
+
+    std::vector<glm::vec3> mins(chunksCount, glm::vec3(std::numeric_limits<float>::max()));
+    std::vector<glm::vec3> maxs(chunksCount, glm::vec3(std::numeric_limits<float>::lowest()));
+
+    forEachVertex([&](int vertex, int packedVertex)
+    {
+        int chunk = packedVertex / chunkSize;
+
+        mins[chunk] = glm::min(mins[chunk], positions[vertex]);
+        maxs[chunk] = glm::max(maxs[chunk], positions[vertex]);
+    });
+
+    m_stepExponents.assign(chunksCount, glm::ivec3(0));
+
+    for (int i = 0; i < chunksCount; ++i)
+    {
+        // padding chunks between the sections hold no vertex
+        if (mins[i].x > maxs[i].x)
+            continue;
+
+        glm::vec3 maxCoordinates = glm::max(glm::abs(mins[i]), glm::abs(maxs[i]));
+
+        for (int k = 0; k < 3; ++k)
+            m_stepExponents[i][k] = calcStepExponent(maxs[i][k] - mins[i][k], maxCoordinates[k]);
+    }
+
+    // copies of a position share an id, found in an open addressing table of the first vertex of every position
+    std::vector<int> positionIds(m_sections.empty() ? 0 : m_sections.back().end);
+    int positionsCount = 0;
+
+    {
+        std::vector<int> firstVertices(std::bit_ceil(positionIds.size() * 2 + 1), -1);
+        size_t mask = firstVertices.size() - 1;
+
+        forEachVertex([&](int vertex, int)
+        {
+            PositionKey key = getPositionKey(positions[vertex]);
+            size_t slot = PositionKeyHash()(key) & mask;
+
+            while (firstVertices[slot] >= 0 && getPositionKey(positions[firstVertices[slot]]) != key)
+                slot = (slot + 1) & mask;
+
+            if (firstVertices[slot] < 0)
+            {
+                firstVertices[slot] = vertex;
+                positionIds[vertex] = positionsCount++;
+            }
+            else
+                positionIds[vertex] = positionIds[firstVertices[slot]];
+        });
+    }
+
+    // snapping to a coarser grid of a shared position may widen a chunk, or its grid may be too many levels
+    // above the chunk step, then the step grows and the shared grids are found again
+    std::vector<glm::ivec3> gridExponents;
+    bool isFitted = false;
+
+    while (!isFitted)
+    {
+        gridExponents.assign(positionsCount, glm::ivec3(std::numeric_limits<int>::min()));
+
+        forEachVertex([&](int vertex, int packedVertex)
+        {
+            int id = positionIds[vertex];
+            gridExponents[id] = glm::max(gridExponents[id], m_stepExponents[packedVertex / chunkSize]);
+        });
+
+        std::vector<glm::ivec3> maxGridExponents(m_stepExponents);
+        mins.assign(chunksCount, glm::vec3(std::numeric_limits<float>::max()));
+        maxs.assign(chunksCount, glm::vec3(std::numeric_limits<float>::lowest()));
+
+        forEachVertex([&](int vertex, int packedVertex)
+        {
+            int chunk = packedVertex / chunkSize;
+            glm::ivec3 exponents = gridExponents[positionIds[vertex]];
+            glm::vec3 snapped = snapToGrid(positions[vertex], exponents);
+
+            mins[chunk] = glm::min(mins[chunk], snapped);
+            maxs[chunk] = glm::max(maxs[chunk], snapped);
+            maxGridExponents[chunk] = glm::max(maxGridExponents[chunk], exponents);
+        });
+
+        isFitted = true;
+
+        for (int i = 0; i < chunksCount; ++i)
+        {
+            if (mins[i].x > maxs[i].x)
+                continue;
+
+            for (int k = 0; k < 3; ++k)
+            {
+                int exponent = std::max(m_stepExponents[i][k], maxGridExponents[i][k] - maxLevel);
+
+                while (!isGridFitted(maxs[i][k] - mins[i][k], exponent))
+                    ++exponent;
+
+                if (exponent != m_stepExponents[i][k])
+                {
+                    m_stepExponents[i][k] = exponent;
+                    isFitted = false;
+                }
+            }
+        }
+    }
+
+    // the snapped minimum lies on the grid of the chunk, so it is the origin
+    m_bounds.assign(chunksCount, PackedChunkBounds());
+
+    for (int i = 0; i < chunksCount; ++i)
+    {
+        glm::vec3 origin = mins[i].x > maxs[i].x ? glm::vec3(0.0f) : mins[i];
+        glm::vec3 step(calcPowerOfTwo(m_stepExponents[i].x), calcPowerOfTwo(m_stepExponents[i].y), calcPowerOfTwo(m_stepExponents[i].z));
+
+        m_bounds[i] = PackedChunkBounds{ glm::vec4(origin, 0.0f), glm::vec4(step, 0.0f) };
+    }
+
+    forEachVertex([&](int vertex, int packedVertex)
+    {
+        int chunk = packedVertex / chunkSize;
+        packPosition(positions[vertex], gridExponents[positionIds[vertex]], m_stepExponents[chunk], m_bounds[chunk], packedPositions[packedVertex]);
+    });
+}
+
+bool PositionQuantization::update(SweepAttribute<glm::vec3> positions, const std::vector<SweepRange>& changedVertices, SweepAttribute<PackedPosition> packedPositions) const
+{
+    GridExponents gridExponents;
+
+    // a copy that did not move keeps its grid, which is the one of its copies outside of the changed vertices
+    for (const SweepRange& range : changedVertices)
+    {
+        for (int i = range.begin; i < range.end; ++i)
+        {
+            int packedVertex = getPackedVertex(i);
+            int chunk = packedVertex / chunkSize;
+
+            if (chunk >= static_cast<int>(m_bounds.size()))
+                return false;
+
+            glm::ivec3 exponents = m_stepExponents[chunk];
+            glm::ivec3 previousExponents = exponents + unpackLevels(packedPositions[packedVertex].levels);
+
+            PackedPosition previous = packedPositions[packedVertex];
+            PackedPosition packedPosition;
+
+            if (packPosition(positions[i], previousExponents, exponents, m_bounds[chunk], packedPosition) && std::equal(packedPosition.value, packedPosition.value + 3, previous.value))
+                exponents = previousExponents;
+
+            mergeGridExponents(gridExponents, positions[i], exponents);
+        }
+    }
+
+    for (const SweepRange& range : changedVertices)
+    {
+        for (int i = range.begin; i < range.end; ++i)
+        {
+            int packedVertex = getPackedVertex(i);
+            int chunk = packedVertex / chunkSize;
+
+            if (!packPosition(positions[i], gridExponents[getPositionKey(positions[i])], m_stepExponents[chunk], m_bounds[chunk], packedPositions[packedVertex]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+glm::vec3 PositionQuantization::unpack(const PackedPosition& packedPosition, int packedVertex) const
+{
+    const PackedChunkBounds& bounds = m_bounds[packedVertex / chunkSize];
+    glm::vec3 value(packedPosition.value[0], packedPosition.value[1], packedPosition.value[2]);
+
+    // the same expression as in the vertex shaders
+    return glm::vec3(bounds.origin) + value * glm::vec3(bounds.step);
+}
+
+const std::vector<PackedChunkBounds>& PositionQuantization::getBounds() const
+{
+    return m_bounds;
+}
+
+uint32_t VertexPacking::packNormal(const glm::vec3& normal)
+{
+    // cap normals are not unit length, only the direction is kept
+    float length = glm::length(normal);
+    glm::vec3 direction = length > 0.0f ? normal / length : normal;
+
+    return packSnorm10(direction.x) | (packSnorm10(direction.y) << 10) | (packSnorm10(direction.z) << 20);
+}
+
+glm::vec3 VertexPacking::unpackNormal(uint32_t packedNormal)
+{
+    return glm::vec3(unpackSnorm10(packedNormal), unpackSnorm10(packedNormal >> 10), unpackSnorm10(packedNormal >> 20));
+}
+
+uint16_t VertexPacking::packUnorm16(float value)
+{
+    return static_cast<uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * unorm16Max));
+}
+
+void VertexPacking::pack(const SweepOutput& source, const PositionQuantization& quantization, const SweepRange& range, PackedSmoothedVertex* output)
+{
+    for (int i = range.begin; i < range.end; ++i)
+    {
+        PackedSmoothedVertex& vertex = output[quantization.getPackedVertex(i)];
+
+        vertex.normal = packNormal(source.normals[i]);
+        vertex.smoothedNormal = packNormal(source.smoothedNormals[i]);
+        vertex.textureCoord[0] = packUnorm16(source.textureCoords[i].x);
+        vertex.textureCoord[1] = packUnorm16(source.textureCoords[i].y);
+    }
+}
+
+void VertexPacking::pack(const SweepIndexedOutput& source, const PositionQuantization& quantization, const SweepRange& range, PackedVertex* output)
+{
+    for (int i = range.begin; i < range.end; ++i)
+    {
+        PackedVertex& vertex = output[quantization.getPackedVertex(i)];
+
+        vertex.normal = packNormal(source.normals[i]);
+        vertex.textureCoord[0] = packUnorm16(source.textureCoords[i].x);
+        vertex.textureCoord[1] = packUnorm16(source.textureCoords[i].y);
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include "SweepGenerator.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// position on the grid of its chunk, value * step + origin, levels keeps log2(grid / chunk step) of every axis
+// in 5 bits, the grid is coarser than the chunk step when the position is shared with a coarser chunk
+struct PackedPosition
+{
+    uint16_t value[3]{};
+    uint16_t levels = 0;
+};
+
+// 16 bytes: packed position, normal as GL_INT_2_10_10_10_REV and unorm16 texture coordinates
+struct PackedVertex
+{
+    PackedPosition position;
+    uint32_t normal = 0;
+    uint16_t textureCoord[2]{};
+};
+
+// 20 bytes, the same layout with the smoothed normal after the flat one
+struct PackedSmoothedVertex
+{
+    PackedPosition position;
+    uint32_t normal = 0;
+    uint32_t smoothedNormal = 0;
+    uint16_t textureCoord[2]{};
+};
+
+// std430 element of the shader storage buffer read by the vertex shaders
+struct PackedChunkBounds
+{
+    glm::vec4 origin{};
+    glm::vec4 step{};
+};
+
+// Positions are quantized on a grid of every chunkSize consecutive packed vertices. The steps are powers of two
+// fitted to the bounds of their chunk, a position found in several chunks snaps to the coarsest of their grids,
+// which holds the finer ones, so all its copies decode to the same float and the surface has no cracks.
+// Every section of the source vertices starts a new chunk, so the caps do not widen the chunks of the rings,
+// the padding between the sections is never drawn
+class PositionQuantization
+{
+public:
+    static constexpr int chunkSize = 4096;
+
+    static int getChunksCount(int verticesSize);
+
+    // consecutive ranges of the source vertices, the packed ones are drawn section by section
+    void setSections(const std::vector<SweepRange>& sections);
+    const std::vector<SweepRange>& getPackedSections() const;
+    int getPackedVerticesSize() const;
+    int getPackedVertex(int vertex) const;
+
+    // fits the grids to the positions of all sections and packs them into packedPositions[getPackedVertex(i)]
+    void build(SweepAttribute<glm::vec3> positions, SweepAttribute<PackedPosition> packedPositions);
+
+    // packs the changed vertices again on the kept grids, all copies of a moved position have to be among them,
+    // returns false when one of them no longer fits into its chunk and build() has to be called again
+    bool update(SweepAttribute<glm::vec3> positions, const std::vector<SweepRange>& changedVertices, SweepAttribute<PackedPosition> packedPositions) const;
+
+    glm::vec3 unpack(const PackedPosition& packedPosition, int packedVertex) const;
+
+    const std::vector<PackedChunkBounds>& getBounds() const;
+
+private:
+    std::vector<SweepRange> m_sections;
+    std::vector<SweepRange> m_packedSections;
+
+    std::vector<glm::ivec3> m_stepExponents;
+    std::vector<PackedChunkBounds> m_bounds;
+};
+
+namespace VertexPacking
+{
+    uint32_t packNormal(const glm::vec3& normal);
+    glm::vec3 unpackNormal(uint32_t packedNormal);
+
+    uint16_t packUnorm16(float value);
+
+    // packs the normals and texture coordinates of vertices [range.begin, range.end) of the source into
+    // output[quantization.getPackedVertex(i)], the positions are packed by the quantization
+    void pack(const SweepOutput& source, const PositionQuantization& quantization, const SweepRange& range, PackedSmoothedVertex* output);
+    void pack(const SweepIndexedOutput& source, const PositionQuantization& quantization, const SweepRange& range, PackedVertex* output);
+}
+
+#endif
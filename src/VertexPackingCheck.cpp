@@ -0,0 +1,266 @@
+#include "SweepGenerator.h"
+#include "VertexPacking.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int trajectorySize = 3000;
+    constexpr int cutSize = 16;
+    constexpr float profileRadius = 0.5f;
+
+    // a small move of a middle ring keeps the grids, a large move of a cap may fit them again
+    constexpr int editedPoints[]{ trajectorySize / 2, 0 };
+    constexpr float editOffsets[]{ 0.01f, 0.3f };
+
+    // a chunk step is at most 2 / 65535 of the chunk size, a position shared by chunks snaps to the grid of the coarsest one,
+    // so the error is measured against the largest chunk that holds the position
+    constexpr float maxChunkError = 4.0f / 65535.0f;
+
+    enum Layouts
+    {
+        Non_indexed_layout,
+        Indexed_smooth_layout,
+        Indexed_flat_layout
+    };
+
+    struct Surface
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> smoothedNormals;
+        std::vector<glm::vec2> textureCoords;
+        std::vector<unsigned int> indices;
+
+        SweepOutput getOutput()
+        {
+            return SweepOutput{ positions.data(), normals.data(), smoothedNormals.data(), textureCoords.data() };
+        }
+
+        SweepIndexedOutput getIndexedOutput()
+        {
+            return SweepIndexedOutput{ positions.data(), normals.data(), textureCoords.data(), indices.data() };
+        }
+    };
+
+    void generateSurface(SweepGenerator& generator, const SweepInput& input, const std::vector<glm::vec3>& translatedCut, Layouts layout, Surface& surface)
+    {
+        int verticesSize = SweepGenerator::getReplicatedCutSize(cutSize, trajectorySize);
+
+        if (layout == Indexed_smooth_layout)
+            verticesSize = SweepGenerator::getIndexedSmoothVerticesSize(cutSize, trajectorySize);
+        else if (layout == Indexed_flat_layout)
+            verticesSize = SweepGenerator::getIndexedFlatVerticesSize(cutSize, trajectorySize);
+
+        surface.positions.assign(verticesSize, glm::vec3(0.0f));
+        surface.normals.assign(verticesSize, glm::vec3(0.0f));
+        surface.smoothedNormals.assign(verticesSize, glm::vec3(0.0f));
+        surface.textureCoords.assign(verticesSize, glm::vec2(0.0f));
+        surface.indices.assign(SweepGenerator::getReplicatedCutSize(cutSize, trajectorySize), 0);
+
+        if (layout == Non_indexed_layout)
+            generator.generateReplicatedCut(input, translatedCut.data(), surface.getOutput());
+        else if (layout == Indexed_smooth_layout)
+            generator.generateIndexedSmoothReplicatedCut(input, translatedCut.data(), surface.getIndexedOutput());
+        else
+            generator.generateIndexedFlatReplicatedCut(input, translatedCut.data(), surface.getIndexedOutput());
+    }
+
+    std::vector<SweepRange> updateSurface(SweepGenerator& generator, const SweepInput& input, const std::vector<glm::vec3>& translatedCut, const SweepRange& changedRings, Layouts layout, Surface& surface)
+    {
+        SweepRange changedVertices[2];
+        SweepRange changedIndices;
+
+        if (layout == Non_indexed_layout)
+            generator.updateReplicatedCut(input, translatedCut.data(), surface.getOutput(), changedRings, changedVertices[0], changedVertices[1]);
+        else if (layout == Indexed_smooth_layout)
+            generator.updateIndexedSmoothReplicatedCut(input, translatedCut.data(), surface.getIndexedOutput(), changedRings, changedVertices[0], changedVertices[1]);
+        else
+            generator.updateIndexedFlatReplicatedCut(input, translatedCut.data(), surface.getIndexedOutput(), changedRings, 0, changedVertices[0], changedVertices[1], changedIndices);
+
+        return { changedVertices[0], changedVertices[1] };
+    }
+
+    // the same sections as the packed surface of ReplicatedCutObject
+    std::vector<SweepRange> getSections(int verticesSize, Layouts layout)
+    {
+        int capSize = SweepGenerator::getCapSize(cutSize);
+
+        if (layout == Indexed_smooth_layout)
+            capSize = SweepGenerator::getIndexedSmoothCapSize(cutSize);
+        else if (layout == Indexed_flat_layout)
+            capSize = SweepGenerator::getIndexedFlatCapSize(cutSize);
+
+        int capsBegin = verticesSize - capSize * 2;
+
+        return { SweepRange{ 0, capsBegin }, SweepRange{ capsBegin, capsBegin + capSize }, SweepRange{ capsBegin + capSize, verticesSize } };
+    }
+
+    std::array<float, 3> getPositionKey(const glm::vec3& position)
+    {
+        return { position.x, position.y, position.z };
+    }
+
+    // largest error relative to the largest side of the largest chunk that holds the position, and the copies of a position
+    // that decode to different points, the error relative to the own chunk of a copy is only reported
+    bool checkQuantization(const std::string& name, const PositionQuantization& quantization, const std::vector<glm::vec3>& positions, const std::vector<PackedPosition>& packedPositions)
+    {
+        int chunksCount = PositionQuantization::getChunksCount(quantization.getPackedVerticesSize());
+
+        std::vector<glm::vec3> mins(chunksCount, glm::vec3(std::numeric_limits<float>::max()));
+        std::vector<glm::vec3> maxs(chunksCount, glm::vec3(std::numeric_limits<float>::lowest()));
+
+        for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+        {
+            int chunk = quantization.getPackedVertex(i) / PositionQuantization::chunkSize;
+
+            mins[chunk] = glm::min(mins[chunk], positions[i]);
+            maxs[chunk] = glm::max(maxs[chunk], positions[i]);
+        }
+
+        std::vector<float> chunkSizes(chunksCount, 0.0f);
+        int usedChunksCount = 0;
+
+        for (int i = 0; i < chunksCount; ++i)
+        {
+            if (mins[i].x > maxs[i].x)
+                continue;
+
+            glm::vec3 extent = maxs[i] - mins[i];
+            chunkSizes[i] = std::max({ extent.x, extent.y, extent.z });
+            ++usedChunksCount;
+        }
+
+        std::map<std::array<float, 3>, float> sharedSizes;
+
+        for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+        {
+            float& sharedSize = sharedSizes[getPositionKey(positions[i])];
+            sharedSize = std::max(sharedSize, chunkSizes[quantization.getPackedVertex(i) / PositionQuantization::chunkSize]);
+        }
+
+        std::map<std::array<float, 3>, glm::vec3> decodedPositions;
+        int cracksCount = 0;
+        float maxError = 0.0f;
+        float maxOwnChunkError = 0.0f;
+
+        for (int i = 0; i < static_cast<int>(positions.size()); ++i)
+        {
+            int packedVertex = quantization.getPackedVertex(i);
+            float chunkSize = chunkSizes[packedVertex / PositionQuantization::chunkSize];
+            float sharedSize = sharedSizes[getPositionKey(positions[i])];
+
+            glm::vec3 decoded = quantization.unpack(packedPositions[packedVertex], packedVertex);
+            glm::vec3 difference = glm::abs(decoded - positions[i]);
+            float error = std::max({ difference.x, difference.y, difference.z });
+
+            maxError = std::max(maxError, sharedSize > 0.0f ? error / sharedSize : error);
+            maxOwnChunkError = std::max(maxOwnChunkError, chunkSize > 0.0f ? error / chunkSize : error);
+
+            auto [it, isInserted] = decodedPositions.try_emplace(getPositionKey(positions[i]), decoded);
+
+            if (!isInserted && it->second != decoded)
+                ++cracksCount;
+        }
+
+        std::cout << name << ": " << usedChunksCount << " chunks, worst chunk error " << maxError << " of the chunk size ("
+            << maxOwnChunkError << " of the own chunk size of shared positions), " << cracksCount << " cracks" << std::endl;
+
+        if (cracksCount > 0)
+        {
+            std::cerr << name << " has copies of a position that decode to different points!" << std::endl;
+            return false;
+        }
+
+        if (maxError > maxChunkError)
+        {
+            std::cerr << name << " chunk error is above the tolerance!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool checkLayout(const char* name, Layouts layout)
+    {
+        std::vector<glm::vec2> cut(cutSize);
+
+        for (int i = 0; i < cutSize; ++i)
+        {
+            float angle = 6.2831853f * i / cutSize;
+            cut[i] = glm::vec2(std::cos(angle), std::sin(angle)) * profileRadius;
+        }
+
+        // a long winding trajectory away from the origin, so a single grid for the whole surface would be coarse
+        std::vector<glm::vec3> trajectory(trajectorySize);
+        std::vector<float> cutParameters(trajectorySize, 1.0f);
+
+        for (int i = 0; i < trajectorySize; ++i)
+            trajectory[i] = glm::vec3(100.0f + 0.05f * i, 20.0f * std::sin(0.01f * i), 20.0f * std::cos(0.013f * i));
+
+        SweepInput input{ cut.data(), cutSize, trajectory.data(), trajectorySize, cutParameters.data(), trajectorySize };
+
+        SweepGenerator generator;
+        std::vector<glm::vec3> translatedCut(SweepGenerator::getTrajectoryCutsSize(cutSize, trajectorySize));
+        generator.generateTrajectoryCuts(input, translatedCut.data());
+
+        Surface surface;
+        generateSurface(generator, input, translatedCut, layout, surface);
+
+        PositionQuantization quantization;
+        quantization.setSections(getSections(surface.positions.size(), layout));
+
+        std::vector<PackedPosition> packedPositions(quantization.getPackedVerticesSize());
+        quantization.build(surface.positions.data(), packedPositions.data());
+
+        bool isPassed = checkQuantization(name, quantization, surface.positions, packedPositions);
+
+        // the moved positions are packed again on the kept grids, or the grids are fitted again when they do not fit
+        for (int i = 0; i < 2; ++i)
+        {
+            int point = editedPoints[i];
+            trajectory[point] += glm::vec3(0.0f, editOffsets[i], editOffsets[i]);
+
+            SweepRange changedRings{ point, point + 1 };
+
+            if (!generator.updateTrajectoryCuts(input, translatedCut.data(), changedRings, true))
+            {
+                generator.generateTrajectoryCuts(input, translatedCut.data());
+                generateSurface(generator, input, translatedCut, layout, surface);
+
+                changedRings = SweepRange{ 0, trajectorySize };
+            }
+
+            std::vector<SweepRange> changedVertices = updateSurface(generator, input, translatedCut, changedRings, layout, surface);
+            bool isUpdated = quantization.update(surface.positions.data(), changedVertices, packedPositions.data());
+
+            if (!isUpdated)
+                quantization.build(surface.positions.data(), packedPositions.data());
+
+            std::string editedName = std::string(name) + " after edit of point " + std::to_string(point) + (isUpdated ? ", updated" : ", fitted again");
+            isPassed = checkQuantization(editedName, quantization, surface.positions, packedPositions) && isPassed;
+        }
+
+        return isPassed;
+    }
+}
+
+// packs a long sweep in every layout of the surface, exits with 1 when a chunk error is above the tolerance
+// or when copies of a position decode to different points, before and after edits
+int main()
+{
+    bool isPassed = checkLayout("non indexed", Non_indexed_layout);
+    isPassed = checkLayout("indexed smooth", Indexed_smooth_layout) && isPassed;
+    isPassed = checkLayout("indexed flat", Indexed_flat_layout) && isPassed;
+
+    return isPassed ? 0 : 1;
+}